@@ -45,6 +45,14 @@ namespace G25
         /// When this string is non-null, a list of generated files is written to that file.
         /// </summary>
         public static string OptionSaveFileListFile = null;
+        /// <summary>
+        /// When this string is non-null, the functions from this usage report are added to the spec before it is saved.
+        /// </summary>
+        public static string OptionUsageReportFile = null;
+        /// <summary>
+        /// Maximum number of functions added from the usage report (all when less than 0).
+        /// </summary>
+        public static int OptionUsageReportTopN = -1;
 
         static void Main(string[] args)
         {
@@ -88,6 +96,8 @@ namespace G25
                 { "s|save=", (string str) => {OptionSaveSpecXmlFile = str;} },
                 { "f|filelist=", (string str) => {OptionSaveFileListFile = str;} },
                 { "d|deterministic=", (Boolean B) => G25.CG.Shared.Threads.SetRunThreadsSerially(B) },
+                { "u|usage=", (string str) => {OptionUsageReportFile = str;} },
+                { "n|top=", (int N) => {OptionUsageReportTopN = N;} },
             };
 
             List<string> extra = p.Parse(args);
@@ -97,7 +107,9 @@ namespace G25
         }
 
         public static void ProcessSpecificationXML(string filename) {
-            if (OptionSaveSpecXmlFile != null)
+            if ((OptionUsageReportFile != null) && (OptionSaveSpecXmlFile == null))
+                Console.WriteLine("Error: the -usage option requires the -save option (the augmented specification is saved to that file).");
+            else if (OptionSaveSpecXmlFile != null)
                 LoadAndSave(filename, OptionSaveSpecXmlFile);
             else Generate(filename);
 
@@ -110,6 +122,10 @@ namespace G25
                 Console.WriteLine("Loading algebra specification: " + srcFilename);
                 G25.Specification S = new G25.Specification(srcFilename);
 
+                // add the most frequently used functions from the usage report
+                if (OptionUsageReportFile != null)
+                    AddFunctionsFromUsageReport(S, OptionUsageReportFile, OptionUsageReportTopN);
+
                 Console.WriteLine("Saving algebra specification: " + dstFilename);
                 string str = XML.ToXmlString(S);
                 G25.CG.Shared.Util.WriteFile(dstFilename, str);
@@ -136,6 +152,21 @@ namespace G25
 
         }
 
+        /// <summary>
+        /// Adds the (at most) <paramref name="topN"/> most frequently used functions from usage report
+        /// <paramref name="reportFilename"/> to <paramref name="S"/>, and prints them.
+        /// </summary>
+        public static void AddFunctionsFromUsageReport(G25.Specification S, string reportFilename, int topN)
+        {
+            Console.WriteLine("Loading usage report: " + reportFilename);
+            G25.UsageReport R = new G25.UsageReport(reportFilename);
+
+            List<G25.UsageReport.Entry> added = R.AddToSpecification(S, topN);
+            Console.WriteLine("Adding " + added.Count + " of " + R.Entries.Count + " reported functions:");
+            foreach (G25.UsageReport.Entry E in added)
+                Console.WriteLine(E.m_count.ToString().PadLeft(12) + "  " + E.m_xml);
+        }
+
         public static void Generate(string filename)
         {
             try
@@ -204,6 +235,9 @@ namespace G25
                 "-s file.xml -save file.xml: saves loaded specification back to XML (for testing).\n" +
                 "-f list.txt -filelist list.txt: writes names of generated files to text file.\n" +
                 "-d true -deterministic true: set to true to enforce deterministic behavior.\n" +
+                "-u report.txt -usage report.txt: adds the functions from a usage report (printed by ReportUsage)\n" +
+                "    to the specification, most frequently used first. Requires -save.\n" +
+                "-n N -top N: adds at most N functions from the usage report.\n" +
                 "\n");
         }
 
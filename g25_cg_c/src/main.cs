@@ -48,8 +48,12 @@ using System.Threading;
  *   - G25.CG.C.AddSubtract: addition and subtraction of (specialized/general) multivectors.
  *   - G25.CG.C.ApplyOM: application of outermorphisms to multivectors.
  *   - G25.CG.C.ApplyVersor: applying a (unit) versor to other (specialized/general) multivectors.
+ *   - G25.CG.C.ApplyVersorBatch: applying a (unit) versor to an array of specialized multivectors.
  *   - G25.CG.C.CgaPoint: initialization of conformal points.
  *   - G25.CG.C.CgaPointDistance: distance of conformal points.
+ *   - G25.CG.C.CgaPointDistanceBatch: distance matrices and nearest neighbours of arrays of conformal points.
+ *   - G25.CG.C.ComposeOM: composition of general outermorphisms.
+ *   - G25.CG.C.MeetBatch: meets (intersections) of arrays of specialized multivectors.
  *   - G25.CG.C.Div: division of multivectors by scalar values.
  *   - G25.CG.C.Dual: computing the (un) dual of multivectors.
  *   - G25.CG.C.Equals: check for equality of multivectors.
@@ -68,7 +72,9 @@ using System.Threading;
  *   - G25.CG.C.Unit: unit of (specialized/general) multivectors.
  *   - G25.CG.C.ToggleSign: negation, reversion,  Clifford Conjugate and grade involution of (specialized/general) multivectors.
  *   - G25.CG.C.SinCosExp: sine, cosine and exponential of (specialized/general) bivectors.
+ *   - G25.CG.C.SphereBVH: bounding volume hierarchy over arrays of conformal spheres, with point and ray queries.
  *   - G25.CG.C.VersorInverse: (versor) inverse of (specialized/general) multivectors.
+ *   - G25.CG.C.VersorToOM: converting a (unit) versor to an outermorphism.
  *   - G25.CG.C.Zero: code to check whether multivector is zero (up to some epsilon)
  * 
  * 
@@ -116,6 +122,10 @@ namespace G25.CG.C
             CG.Shared.CGdata cgd = new G25.CG.Shared.CGdata(plugins, cog);
             cgd.SetDependencyPrefix("missing_function_"); // this makes sure that the user sees the function call is a missing dependency
             G25.CG.Shared.FunctionGeneratorInfo FGI = (S.m_generateTestSuite) ? new G25.CG.Shared.FunctionGeneratorInfo() : null; // the fields in this variable are set by Functions.WriteFunctions() and reused by TestSuite.GenerateCode()
+            if (S.m_nbSourceShards > 1) // collect definitions per function family, such that they can be split over multiple source files
+                cgd.m_sourceShards = new G25.CG.Shared.SourceShards(S, S.m_nbSourceShards);
+            else // stream the definitions of the source file to disk as they are generated
+                cgd.m_defSpool = new G25.CG.Shared.DefinitionSpool(G25.CG.Shared.DefinitionSpool.GetTmpFilename(S, Source.GetRawSourceFilename(S)));
            
 
             { // pregenerated code that will go into header, source
@@ -152,6 +162,7 @@ namespace G25.CG.C
             if ((cgd.GetNbErrors() == 0) && (cgd.GetNbMissingDependencies() == 0) && S.m_generateTestSuite)
             {
                 // if no errors, then generate testing code
+                cgd.m_sourceShards = null; // all testing code goes into one file
                 TestSuite.GenerateCode(S, cgd, FGI);
             }
 
@@ -200,7 +211,7 @@ namespace G25.CG.C
             for (int i = 0; i < NB_SET_CODE; i++)
             {
                 cgd.m_declSB.Append(tmpCgd[i].m_declSB);
-                cgd.m_defSB.Append(tmpCgd[i].m_defSB);
+                cgd.AppendDefinitions(G25.CG.Shared.SourceShards.SET, tmpCgd[i].m_defSB);
                 cgd.m_inlineDefSB.Append(tmpCgd[i].m_inlineDefSB);
             }
         }
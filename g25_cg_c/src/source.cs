@@ -293,12 +293,8 @@ namespace G25.CG.C
             G25.CG.Shared.Util.WriteCopyright(SB, S);
             G25.CG.Shared.Util.WriteLicense(SB, S);
 
-            { // #includes
-                SB.AppendLine("#include <stdio.h>");
-                if (cgd.GetFeedback(G25.CG.Shared.Main.NEED_TIME) == "true")
-                    SB.AppendLine("#include <time.h> /* used to seed random generator */");
-                SB.AppendLine("#include \"" + S.GetOutputFilename(G25.CG.C.Header.GetRawHeaderFilename(S)) + "\"");
-            }
+            // #includes
+            WriteIncludes(SB, S, cgd);
 
             GenerateTables(S, cgd, SB);
 
@@ -335,11 +331,75 @@ namespace G25.CG.C
             }
 
             //SB.AppendLine("/* def SB: */");
-            SB.Append(cgd.m_defSB);
+            if (cgd.m_defSpool != null)
+            { // the definitions so far were streamed to a temporary file
+                cgd.m_defSpool.CopyTo(sourceFilename, SB.ToString(), cgd.m_defSB.ToString());
+                cgd.m_defSpool = null; // later code (e.g., testing code) goes into m_defSB again
+            }
+            else
+            {
+                SB.Append(cgd.m_defSB);
+
+                // write all to file
+                G25.CG.Shared.Util.WriteFile(sourceFilename, SB.ToString());
+            }
 
-            // write all to file
-            G25.CG.Shared.Util.WriteFile(sourceFilename, SB.ToString());
+            // write internal header and other source files
+            if (cgd.m_sourceShards != null)
+                generatedFiles.AddRange(GenerateShards(S, cgd));
 
+            return generatedFiles;
+        }
+
+        /// <summary>
+        /// Writes the #include directives of the source file(s).
+        /// When the source is split over multiple files, the internal header is included instead of the regular header.
+        /// </summary>
+        public static void WriteIncludes(StringBuilder SB, Specification S, G25.CG.Shared.CGdata cgd)
+        {
+            SB.AppendLine("#include <stdio.h>");
+            if (cgd.GetFeedback(G25.CG.Shared.Main.NEED_TIME) == "true")
+                SB.AppendLine("#include <time.h> /* used to seed random generator */");
+            if (cgd.m_sourceShards != null)
+                SB.AppendLine("#include \"" + S.GetOutputFilename(G25.CG.Shared.SourceShards.GetRawInternalHeaderFilename(S)) + "\"");
+            else SB.AppendLine("#include \"" + S.GetOutputFilename(G25.CG.C.Header.GetRawHeaderFilename(S)) + "\"");
+        }
+
+        /// <summary>
+        /// Generates the internal header and the source files of all function families 
+        /// (parts, set functions, converters, functions), when the source is split over multiple files.
+        /// </summary>
+        /// <param name="S">Specification of algebra.</param>
+        /// <param name="cgd">The definitions are taken from <c>cgd.m_sourceShards</c>.</param>
+        /// <returns>a list of filenames which were generated (full path).</returns>
+        public static List<string> GenerateShards(Specification S, G25.CG.Shared.CGdata cgd)
+        {
+            List<string> generatedFiles = new List<string>();
+
+            { // internal header (declarations shared by all source files)
+                string rawHeaderFilename = G25.CG.Shared.SourceShards.GetRawInternalHeaderFilename(S);
+                string headerFilename = S.GetOutputPath(rawHeaderFilename);
+                generatedFiles.Add(headerFilename);
+
+                StringBuilder SB = new StringBuilder();
+                G25.CG.Shared.Util.WriteCopyright(SB, S);
+                G25.CG.Shared.Util.WriteLicense(SB, S);
+                G25.CG.Shared.Util.WriteOpenIncludeGuard(SB, rawHeaderFilename);
+                SB.AppendLine("");
+                SB.AppendLine("#include \"" + S.GetOutputFilename(G25.CG.C.Header.GetRawHeaderFilename(S)) + "\"");
+                SB.Append(cgd.m_sourceShards.GetDeclarations());
+                G25.CG.Shared.Util.WriteCloseIncludeGuard(SB, rawHeaderFilename);
+                G25.CG.Shared.Util.WriteFile(headerFilename, SB.ToString());
+            }
+
+            { // source files (the definitions were already streamed to temporary files)
+                StringBuilder preambleSB = new StringBuilder();
+                G25.CG.Shared.Util.WriteCopyright(preambleSB, S);
+                G25.CG.Shared.Util.WriteLicense(preambleSB, S);
+                WriteIncludes(preambleSB, S, cgd);
+
+                generatedFiles.AddRange(cgd.m_sourceShards.WriteShards(".c", preambleSB.ToString(), ""));
+            }
 
             return generatedFiles;
         }
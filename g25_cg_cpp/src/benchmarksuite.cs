@@ -0,0 +1,177 @@
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+// Copyright 2008-2010, Daniel Fontijne, University of Amsterdam -- fontijne@science.uva.nl
+
+using System;
+using System.Collections.Generic;
+using System.Text;
+using System.Threading;
+
+namespace G25.CG.CPP
+{
+    /// <summary>
+    /// Handles code generation of the micro-benchmark suite.
+    /// </summary>
+    class BenchmarkSuite
+    {
+        public static string GetRawBenchmarkSuiteFilename(Specification S)
+        {
+            return S.m_namespace + "_benchmark_main.cpp";
+        }
+
+        /// <summary>
+        /// Generates a complete benchmark suite, including a main function.
+        ///
+        /// Every generated function is timed on random inputs (see BaseFunctionGenerator.WriteBenchmarkFunction()).
+        /// The main function prints the median and 99th percentile time per call of each function,
+        /// as CSV (default) or JSON (command line option <c>--json</c>).
+        /// </summary>
+        /// <param name="S">Specification of algebra.</param>
+        /// <param name="cgd">Used to pass all kinds of info around.</param>
+        /// <param name="FGI">Info about what FunctionGenerator to use for each FGS. Recycled from
+        /// Function.WriteFunctions() for efficiency.</param>
+        /// <returns></returns>
+        public static List<string> GenerateCode(Specification S, G25.CG.Shared.CGdata cgd, G25.CG.Shared.FunctionGeneratorInfo FGI)
+        {
+            System.Console.WriteLine("Generating benchmark suite . . .\n");
+            cgd.SetDependencyPrefix(""); // we want missing dependencies to actually compile, and not generate an error based on function name
+
+            // get list of generated filenames
+            List<string> generatedFiles = new List<string>();
+            string sourceFilename = S.GetOutputPath(G25.CG.CPP.BenchmarkSuite.GetRawBenchmarkSuiteFilename(S));
+            generatedFiles.Add(sourceFilename);
+
+            // reset code in cgd (get rid of all the code that was generated for the regular non-benchmark output)
+            cgd.ResetSB();
+
+            // get StringBuilder where all generated code goes
+            StringBuilder SB = new StringBuilder();
+
+            G25.CG.Shared.Util.WriteOpenNamespace(SB, S);
+
+            // generate declarations for parts of the geometric product, dual, etc (works in parallel internally)
+            try
+            {
+                bool declOnly = true;
+                G25.CG.Shared.PartsCode.GeneratePartsCode(S, cgd, declOnly);
+            }
+            catch (G25.UserException E) { cgd.AddError(E); }
+
+            // reset generated code (StringBuilders) of all CGDs
+            for (int i = 0; i < FGI.m_functionFGS.Count; i++)
+                if (FGI.m_functionGenerators[i] != null)
+                    FGI.m_functionGenerators[i].ResetCGdata();
+
+            // figure out all dependencies (random generators for the arguments)
+            for (int i = 0; i < FGI.m_functionFGS.Count; i++)
+            {
+                if (FGI.m_functionGenerators[i] != null)
+                {
+                    FGI.m_functionGenerators[i].CheckBenchmarkDepenciesEntryPoint();
+                }
+            }
+
+            // get random number generator for each float type (they are seeded with a fixed value, such that each run uses the same inputs)
+            List<string> randomNumberSeedFuncs = new List<string>();
+            foreach (FloatType FT in S.m_floatTypes)
+            {
+                string funcName = G25.CG.Shared.Dependencies.GetDependency(S, cgd, "random_" + FT.type, new String[0], FT, null);
+                randomNumberSeedFuncs.Add(funcName + "_seed");
+            }
+
+            { // iteratively get all dependencies and generate their code
+                int count = 0;
+                List<fgs> missingFunctions = null, alreadyGeneratedMissingFunctions = new List<fgs>();
+                do
+                {
+                    count = cgd.m_missingDependencies.Count; // we loop until the number of dependencies doesn't grow anymore
+                    missingFunctions = cgd.GetMissingDependenciesList(alreadyGeneratedMissingFunctions);
+                    G25.CG.Shared.Functions.WriteFunctions(S, cgd, null, Functions.GetFunctionGeneratorPlugins(cgd), missingFunctions);
+                    alreadyGeneratedMissingFunctions.AddRange(missingFunctions);
+                } while (count < cgd.m_missingDependencies.Count);
+            }
+
+            // write code for all dependencies to output
+            SB.AppendLine("// Missing dependencies declarations:");
+            SB.Append(cgd.m_declSB);
+            SB.AppendLine("// Missing dependencies inline definitions:");
+            SB.Append(cgd.m_inlineDefSB);
+            SB.AppendLine("// Missing dependencies definitions:");
+            SB.Append(cgd.m_defSB);
+
+            cgd.ResetSB();
+            List<string> benchmarkFunctionNames = new List<string>(); // list of names of bool functionName(benchmarkResult &) goes here
+
+            { // write all benchmark functions (in parallel)
+                Thread[] benchmarkFunctionThreads = new Thread[FGI.m_functionFGS.Count];
+                for (int i = 0; i < FGI.m_functionFGS.Count; i++)
+                {
+                    if (FGI.m_functionGenerators[i] != null)
+                    {
+                        benchmarkFunctionThreads[i] = new Thread(FGI.m_functionGenerators[i].WriteBenchmarkFunctionEntryPoint);
+                    }
+                }
+                G25.CG.Shared.Threads.StartThreadArray(benchmarkFunctionThreads);
+                G25.CG.Shared.Threads.JoinThreadArray(benchmarkFunctionThreads);
+
+                // collect all the results from the threads:
+                for (int f = 0; f < FGI.m_functionFGS.Count; f++)
+                {
+                    if (FGI.m_functionGenerators[f] != null)
+                    {
+                        if (FGI.m_functionCgd[f].m_generatedBenchmarkFunctions != null)
+                            benchmarkFunctionNames.AddRange(FGI.m_functionCgd[f].m_generatedBenchmarkFunctions);
+
+                        cgd.m_defSB.Append(FGI.m_functionCgd[f].m_defSB);
+                    }
+                }
+            }
+
+            // write code for all benchmark code to output
+            cgd.m_cog.EmitTemplate(SB, "benchmarkSupport", "S=", S);
+            SB.AppendLine("// Benchmark code definitions:");
+            SB.Append(cgd.m_defSB);
+
+            G25.CG.Shared.Util.WriteCloseNamespace(SB, S);
+
+            // write main function
+            cgd.m_cog.EmitTemplate(SB, "benchmarkSuiteMain",
+                "S=", S,
+                "benchmarkFunctionNames=", benchmarkFunctionNames.ToArray(),
+                "randomNumberSeedFunctionNames=", randomNumberSeedFuncs.ToArray());
+
+            // #include all relevant headers (done last because the random number generators may have been generated above)
+            StringBuilder includeSB = new StringBuilder();
+            includeSB.AppendLine("#include <time.h> /* used for timing */");
+            includeSB.AppendLine("#if (__cplusplus >= 201103L) || (defined(_MSC_VER) && (_MSC_VER >= 1700))");
+            includeSB.AppendLine("#include <chrono> /* std::chrono::steady_clock is used for timing when available */");
+            includeSB.AppendLine("#define G25_BENCHMARK_STEADY_CLOCK");
+            includeSB.AppendLine("#endif");
+            includeSB.AppendLine("#include <stdio.h>");
+            includeSB.AppendLine("#include <stdlib.h>");
+            includeSB.AppendLine("#include <string.h>");
+            includeSB.AppendLine("#include \"" + S.GetOutputFilename(G25.CG.CPP.Header.GetRawHeaderFilename(S)) + "\"");
+            if (cgd.GetFeedback(G25.CG.CPP.MainGenerator.MERSENNE_TWISTER) == "true")
+                includeSB.AppendLine("#include \"" + S.GetOutputFilename(G25.CG.CPP.RandomMT.GetRawMtHeaderFilename(S)) + "\"");
+
+            // write all to file
+            G25.CG.Shared.Util.WriteFile(sourceFilename, includeSB.ToString() + SB.ToString());
+
+            return generatedFiles;
+        } // end of GenerateCode()
+
+    } // end of class BenchmarkSuite
+
+} // end of namespace G25.CG.CPP
@@ -159,7 +159,7 @@ namespace G25.CG.CPP
         /// <param name="className">Mangled name of GMV class.</param>
         public static void WriteToString(StringBuilder SB, Specification S, G25.CG.Shared.CGdata cgd, FloatType FT, G25.GMV gmv, string className)
         {
-            cgd.m_cog.EmitTemplate(SB, "MVtoStringHeader", "NAMESPACE=", (S.m_namespace.Length > 0) ? "::" + S.m_namespace + "::" : "");
+            cgd.m_cog.EmitTemplate(SB, "MVtoStringHeader", "S=", S, "NAMESPACE=", (S.m_namespace.Length > 0) ? "::" + S.m_namespace + "::" : "");
         }
 
 
@@ -59,12 +59,37 @@ namespace G25.CG.CPP
         public static void WriteMemberVariables(StringBuilder SB, Specification S, G25.CG.Shared.CGdata cgd, FloatType FT, G25.GOM gom)
         {
             SB.AppendLine("public:");
+            // the matrices of a lazy GOM are filled in by const member functions (see validateGrade())
+            string MUTABLE = (gom.Lazy) ? "mutable " : "";
             for (int g = 1; g < gom.Domain.Length; g++) // start at '1' in order to skip scalar grade
             {
                 SB.AppendLine("\t/// Matrix for grade " + g + "; the size is " + gom.DomainForGrade(g).Length + " x " + gom.RangeForGrade(g).Length);
-                SB.AppendLine("\t" + FT.type + " m_m" + g + "[" +
+                if (gom.AlignedLayout)
+                {
+                    SB.AppendLine("\t/// Stored column-major; each column is padded to " + gom.ColumnStride(g) + " coordinates.");
+                    SB.AppendLine("\t" + MUTABLE + GetAlignedDeclaration(S, FT, gom, FT.type + " m_m" + g + "[" + gom.MatrixSize(g) + "]") + ";");
+                }
+                else SB.AppendLine("\t" + MUTABLE + FT.type + " m_m" + g + "[" +
                     gom.DomainForGrade(g).Length * gom.RangeForGrade(g).Length + "];");
             }
+            if (gom.Lazy)
+            {
+                SB.AppendLine("\t/// Bitmap of the matrices which are up to date (bit 'g' for grade 'g'). Use validateGrade() before reading a matrix.");
+                SB.AppendLine("\t/// Bit 0x" + G25.CG.Shared.OMinit.COMPUTING_GRADES_BIT.ToString("X") + " is set while a thread computes the missing matrices. Accessed atomically by const member functions.");
+                SB.AppendLine("\tmutable volatile long " + G25.CG.Shared.OMinit.VALID_GRADES_NAME + ";");
+            }
+        }
+
+        /// <returns>The alignment (in bytes) of the matrices of <paramref name="gom"/> when it uses the aligned layout.</returns>
+        public static int GetAlignment(FloatType FT, G25.GOM gom)
+        {
+            return FT.SizeOf() * gom.SimdWidth;
+        }
+
+        /// <returns>Declaration <paramref name="decl"/> wrapped in the <c>NS_ALIGNED</c> macro (see template <c>alignedStorageMacro</c>).</returns>
+        public static string GetAlignedDeclaration(Specification S, FloatType FT, G25.GOM gom, string decl)
+        {
+            return S.m_namespace.ToUpper() + "_ALIGNED(" + GetAlignment(FT, gom) + ", " + decl + ")";
         }
 
         /// <summary>
@@ -246,7 +271,7 @@ namespace G25.CG.CPP
                 defSB.AppendLine(inlineStr + "void " + funcName + "() {");
                 for (int g = 1; g < S.m_GOM.Domain.Length; g++)
                 {
-                    int s = S.m_GOM.Domain[g].Length * S.m_GOM.Range[g].Length;
+                    int s = S.m_GOM.MatrixSize(g);
                     defSB.AppendLine("\t" + G25.CG.Shared.Util.GetSetToZeroCode(S, FT, matrixName + g, s));
                 } // end of loop over all grades of the OM
 
@@ -265,6 +290,9 @@ namespace G25.CG.CPP
                     defSB.AppendLine(FT.DoubleToString(S, kvp.Key) + ";");
                 }
 
+                if (S.m_GOM.Lazy)
+                    defSB.AppendLine("\t" + G25.CG.Shared.OMinit.VALID_GRADES_NAME + " = " + G25.CG.Shared.OMinit.GetAllGradesValidBitmap(S.m_GOM) + ";");
+
                 defSB.AppendLine("}");
             }
         } // end of WriteSetIdentity()
@@ -283,21 +311,151 @@ namespace G25.CG.CPP
 
             string srcName = "src";
             string matrixName = "m_m";
+            string validName = G25.CG.Shared.OMinit.VALID_GRADES_NAME;
+            bool lazy = S.m_GOM.Lazy;
 
             foreach (G25.FloatType FT in S.m_floatTypes)
             {
                 string className = FT.GetMangledName(S, S.m_GOM.Name);
                 string funcName = className + "::set";
                 defSB.AppendLine(inlineStr + "void " + funcName + "(const " + className + " &" + srcName + ") {");
+                // lazy: only copy the matrices which are up to date (another thread may be computing the others)
+                if (lazy)
+                {
+                    defSB.AppendLine("\tlong valid = " + S.m_namespace.ToUpper() + "_LAZY_GOM_LOAD(&" + srcName + "." + validName + ") & ~0x" + G25.CG.Shared.OMinit.COMPUTING_GRADES_BIT.ToString("X") + ";");
+                    // the padding of matrices which are not copied must still be cleared
+                    string padCode = (S.m_GOM.AlignedLayout) ? G25.CG.Shared.OMinit.GetClearPaddingCode(S, FT, S.m_GOM) : "";
+                    if (padCode.Length > 0)
+                        defSB.AppendLine("\t" + padCode);
+                }
                 for (int g = 1; g < S.m_GOM.Domain.Length; g++)
                 {
-                    int s = S.m_GOM.Domain[g].Length * S.m_GOM.Range[g].Length;
-                    defSB.AppendLine("\t" + G25.CG.Shared.Util.GetCopyCode(S, FT, srcName + "." + matrixName + g, matrixName + g, s));
+                    int s = S.m_GOM.MatrixSize(g);
+                    string copyCode = G25.CG.Shared.Util.GetCopyCode(S, FT, srcName + "." + matrixName + g, matrixName + g, s);
+                    if (lazy && (g > 1))
+                        defSB.AppendLine("\tif (valid & " + (1 << g) + ") " + copyCode);
+                    else defSB.AppendLine("\t" + copyCode);
                 } // end of loop over all grades of the OM
+                if (lazy)
+                    defSB.AppendLine("\t" + validName + " = valid;");
                 defSB.AppendLine("}");
             }
         } // end of WriteCopy()
 
+        /// <summary>
+        /// Writes the <c>applyGrade</c> kernels of the aligned layout (see G25.OM.SetAlignedLayout()), for all floating point types.
+        /// 
+        /// Each kernel accumulates the images of the domain blades in an aligned buffer of one padded column.
+        /// The inner loops run over whole (padded, aligned) columns with a constant trip count, so the compiler
+        /// can turn them into SIMD multiply-adds without any remainder handling.
+        /// </summary>
+        /// <param name="S">Used for basis vector names and output language.</param>
+        /// <param name="cgd">Results go here. Also intermediate data for code generation. Also contains plugins and cog.</param>
+        public static void WriteApplyGrade(Specification S, G25.CG.Shared.CGdata cgd)
+        {
+            G25.GOM gom = S.m_GOM;
+            if (!gom.AlignedLayout) return;
+
+            StringBuilder defSB = cgd.m_defSB;
+            defSB.AppendLine("");
+
+            foreach (G25.FloatType FT in S.m_floatTypes)
+            {
+                string className = FT.GetMangledName(S, gom.Name);
+                for (int g = 1; g < gom.Domain.Length; g++)
+                {
+                    int nbDomain = gom.DomainForGrade(g).Length;
+                    int nbRange = gom.RangeForGrade(g).Length;
+                    int stride = gom.ColumnStride(g);
+
+                    defSB.AppendLine("void " + className + "::applyGrade" + g + "(const " + FT.type + " *src, " + FT.type + " *dst, int nb) const {");
+                    defSB.AppendLine("\t" + GetAlignedDeclaration(S, FT, gom, FT.type + " acc[" + stride + "]") + ";");
+                    defSB.AppendLine("\tint i, d, r;");
+                    if (gom.Lazy && (g > 1))
+                        defSB.AppendLine("\tvalidateGrade(" + g + ");");
+                    defSB.AppendLine("\tfor (i = 0; i < nb; i++, src += " + nbDomain + ", dst += " + nbRange + ") {");
+                    defSB.AppendLine("\t\tfor (r = 0; r < " + stride + "; r++)");
+                    defSB.AppendLine("\t\t\tacc[r] = src[0] * m_m" + g + "[r];");
+                    defSB.AppendLine("\t\tfor (d = 1; d < " + nbDomain + "; d++) {");
+                    defSB.AppendLine("\t\t\tconst " + FT.type + " x = src[d];");
+                    defSB.AppendLine("\t\t\tconst " + FT.type + " *col = m_m" + g + " + d * " + stride + ";");
+                    defSB.AppendLine("\t\t\tfor (r = 0; r < " + stride + "; r++)");
+                    defSB.AppendLine("\t\t\t\tacc[r] += x * col[r];");
+                    defSB.AppendLine("\t\t}");
+                    defSB.AppendLine("\t\tfor (r = 0; r < " + nbRange + "; r++)");
+                    defSB.AppendLine("\t\t\tdst[r] = acc[r];");
+                    defSB.AppendLine("\t}");
+                    defSB.AppendLine("}");
+                }
+            }
+        } // end of WriteApplyGrade()
+
+        /// <summary>
+        /// Writes the <c>computeGrades()</c> function of a lazy GOM (see G25.OM.SetLazy()), for all floating point types.
+        /// 
+        /// <c>computeGrades(g)</c> computes all grade matrices up to grade 'g' which are not up to date,
+        /// from the lower grade matrices, using the regular 'set from lower grade' functions (see OMinit.WriteSetVectorImages()).
+        /// 
+        /// Because <c>computeGrades()</c> is called from const member functions, one GOM may be used by several threads at once.
+        /// The computation is therefore guarded by OMinit.COMPUTING_GRADES_BIT: the thread which manages to set the bit (by
+        /// compare-and-swap) computes the missing matrices, the other threads wait until the bit is cleared again.
+        /// The valid grade bits are published together with the clearing of the guard bit, so a matrix is never
+        /// read before it is complete.
+        /// </summary>
+        /// <param name="S">Used for basis vector names and output language.</param>
+        /// <param name="cgd">Results go here. Also intermediate data for code generation. Also contains plugins and cog.</param>
+        public static void WriteComputeGrades(Specification S, G25.CG.Shared.CGdata cgd)
+        {
+            G25.GOM gom = S.m_GOM;
+            if (!gom.Lazy) return;
+
+            StringBuilder defSB = cgd.m_defSB;
+            defSB.AppendLine("");
+
+            string validName = G25.CG.Shared.OMinit.VALID_GRADES_NAME;
+            string guardBit = "0x" + G25.CG.Shared.OMinit.COMPUTING_GRADES_BIT.ToString("X");
+            string loadMacro = S.m_namespace.ToUpper() + "_LAZY_GOM_LOAD";
+            string casMacro = S.m_namespace.ToUpper() + "_LAZY_GOM_CAS";
+            bool matrixMode = false; // this value is irrelevant for the grade > 1 functions
+            foreach (G25.FloatType FT in S.m_floatTypes)
+            {
+                string className = FT.GetMangledName(S, gom.Name);
+                string prefix = className + "::";
+                string[] funcNames = G25.CG.Shared.OMinit.GetSetFromLowerGradeFunctionNames(S, FT, matrixMode);
+
+                defSB.AppendLine("void " + className + "::computeGrades(int g) const {");
+                defSB.AppendLine("\t" + className + " *self = const_cast<" + className + "*>(this); // only mutable members are written");
+                defSB.AppendLine("\tlong valid;");
+                defSB.AppendLine("\tint h;");
+                defSB.AppendLine("\t// acquire the guard (or return when another thread has computed the matrices meanwhile)");
+                defSB.AppendLine("\tfor (;;) {");
+                defSB.AppendLine("\t\tvalid = " + loadMacro + "(&" + validName + ");");
+                defSB.AppendLine("\t\tif (valid & (1 << g)) return;");
+                defSB.AppendLine("\t\tif ((!(valid & " + guardBit + ")) && (" + casMacro + "(&" + validName + ", valid | " + guardBit + ", valid) == valid)) break;");
+                defSB.AppendLine("\t}");
+                defSB.AppendLine("\tfor (h = 2; h <= g; h++) {");
+                defSB.AppendLine("\t\tif (valid & (1 << h)) continue;");
+                defSB.AppendLine("\t\tswitch(h) {");
+                for (int h = 2; h < gom.Domain.Length; h++)
+                {
+                    defSB.AppendLine("\t\tcase " + h + ":");
+                    for (int d = 0; d < gom.DomainForGrade(h).Length; d++)
+                    {
+                        string funcName = funcNames[h] + "_" + d;
+                        if (funcName.IndexOf(prefix) == 0)
+                            funcName = funcName.Substring(prefix.Length);
+                        defSB.AppendLine("\t\t\tself->" + funcName + "();");
+                    }
+                    defSB.AppendLine("\t\t\tbreak;");
+                }
+                defSB.AppendLine("\t\t}");
+                defSB.AppendLine("\t}");
+                defSB.AppendLine("\t// publish the matrices and release the guard");
+                defSB.AppendLine("\t" + casMacro + "(&" + validName + ", valid | ((2 << g) - 1), valid | " + guardBit + ");");
+                defSB.AppendLine("}");
+            }
+        } // end of WriteComputeGrades()
+
         /// <summary>
         /// Writes a function to set a GOM struct according to vector images, for all floating point types.
         /// </summary>
@@ -422,7 +580,8 @@ namespace G25.CG.CPP
             WriteSetVectorImages(m_specification, m_cgd, false, false); // false, false = matrixMode, transpose
             WriteSetVectorImages(m_specification, m_cgd, true, false); // true, false = matrixMode, transpose
             WriteGOMtoSOMcopy(m_specification, m_cgd);
-            
+            WriteApplyGrade(m_specification, m_cgd);
+            WriteComputeGrades(m_specification, m_cgd);
         }
 
 
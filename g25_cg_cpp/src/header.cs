@@ -71,9 +71,9 @@ namespace G25.CG.CPP
                 if (cgd.GetFeedback(G25.CG.Shared.Main.MERSENNE_TWISTER) == "true")
                     SB.AppendLine("#include \"" + S.m_namespace + "_mt.h\"");
                 if (S.m_reportUsage)
-                {
-                    SB.AppendLine("#include <map>");
-                }
+                    cgd.m_cog.EmitTemplate(SB, "ReportUsageIncludes", "S=", S);
+                if (S.m_instrumentation)
+                    cgd.m_cog.EmitTemplate(SB, "InstrumentationIncludes", "S=", S);
             }
 
             G25.CG.Shared.Util.WriteOpenNamespace(SB, S);
@@ -148,7 +148,13 @@ namespace G25.CG.CPP
 
             // write classes for all GOM (all float types)
             if (S.m_GOM != null)
+            {
+                if (S.m_GOM.AlignedLayout)
+                    cgd.m_cog.EmitTemplate(SB, "alignedStorageMacro", "S=", S);
+                if (S.m_GOM.Lazy)
+                    cgd.m_cog.EmitTemplate(SB, "lazyGOMatomicMacros", "S=", S);
                 G25.CG.CPP.GOM.WriteGOMclasses(SB, S, cgd);
+            }
 
             // write classes for all SOMs (all float types)
             G25.CG.CPP.SOM.WriteSOMclasses(SB, S, cgd);
@@ -156,8 +162,17 @@ namespace G25.CG.CPP
             // write constant declarations
             G25.CG.CPP.Constants.WriteDeclarations(SB, S, cgd);
 
+            { // write binary serialization
+                bool def = false;
+                G25.CG.CPP.Serialization.WriteSerialization(SB, S, cgd, def);
+            }
+
             // write report usage
-            cgd.m_cog.EmitTemplate(SB, (S.m_reportUsage) ? "ReportUsageHeader" : "NoReportUsageHeader");
+            cgd.m_cog.EmitTemplate(SB, (S.m_reportUsage) ? "ReportUsageHeader" : "NoReportUsageHeader", "S=", S);
+
+            // write instrumentation (call counting / timing)
+            if (S.m_instrumentation)
+                cgd.m_cog.EmitTemplate(SB, "InstrumentationHeader", "S=", S);
 
             // set to zero / copy floats
             bool hasDouble = false;
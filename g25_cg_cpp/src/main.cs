@@ -49,7 +49,11 @@ namespace G25.CG.CPP
 
             CG.Shared.CGdata cgd = new G25.CG.Shared.CGdata(plugins, cog);
             cgd.SetDependencyPrefix("missing_function_"); // this makes sure that the user sees the function call is a missing dependency
-            G25.CG.Shared.FunctionGeneratorInfo FGI = (S.m_generateTestSuite) ? new G25.CG.Shared.FunctionGeneratorInfo() : null; // the fields in this variable are set by Functions.WriteFunctions() and reused by TestSuite.GenerateCode()
+            G25.CG.Shared.FunctionGeneratorInfo FGI = (S.m_generateTestSuite || S.m_generateBenchmarkSuite) ? new G25.CG.Shared.FunctionGeneratorInfo() : null; // the fields in this variable are set by Functions.WriteFunctions() and reused by TestSuite.GenerateCode() and BenchmarkSuite.GenerateCode()
+            if (S.m_nbSourceShards > 1) // collect definitions per function family, such that they can be split over multiple source files
+                cgd.m_sourceShards = new G25.CG.Shared.SourceShards(S, S.m_nbSourceShards);
+            else // stream the definitions of the source file to disk as they are generated
+                cgd.m_defSpool = new G25.CG.Shared.DefinitionSpool(G25.CG.Shared.DefinitionSpool.GetTmpFilename(S, Source.GetRawSourceFilename(S)));
 
             { // pregenerated code that will go into header, source
                 // generate code for parts of the geometric product, dual, etc (works in parallel internally)
@@ -86,11 +90,19 @@ namespace G25.CG.CPP
             // report errors and missing deps to user
             cgd.PrintErrors(S);
             cgd.PrintMissingDependencies(S);
-            if ((cgd.GetNbErrors() == 0) && (cgd.GetNbMissingDependencies() == 0) && S.m_generateTestSuite)
+            bool noErrors = (cgd.GetNbErrors() == 0) && (cgd.GetNbMissingDependencies() == 0); // (the test suite adds missing dependencies of its own)
+            if (noErrors && S.m_generateTestSuite)
             {
                 // if no errors, then generate testing code
+                cgd.m_sourceShards = null; // all testing code goes into one file
                 TestSuite.GenerateCode(S, cgd, FGI);
             }
+            if (noErrors && S.m_generateBenchmarkSuite)
+            {
+                // if no errors, then generate benchmark code
+                cgd.m_sourceShards = null; // all benchmark code goes into one file
+                BenchmarkSuite.GenerateCode(S, cgd, FGI);
+            }
 
             // Generate random number generator source code (Mersenne Twister).
             // This must be done last since the testing code may require it!
@@ -140,7 +152,7 @@ namespace G25.CG.CPP
             for (int i = 0; i < NB_SET_CODE; i++)
             {
                 cgd.m_declSB.Append(tmpCgd[i].m_declSB);
-                cgd.m_defSB.Append(tmpCgd[i].m_defSB);
+                cgd.AppendDefinitions(G25.CG.Shared.SourceShards.SET, tmpCgd[i].m_defSB);
                 cgd.m_inlineDefSB.Append(tmpCgd[i].m_inlineDefSB);
             }
         }
@@ -158,7 +170,7 @@ namespace G25.CG.CPP
             G25.CG.Shared.Util.LoadCTemplates(cog);
 
             cog.LoadTemplates(g25_cg_cpp.Properties.Resources.cg_cpp_templates, "cg_cpp_templates.txt");
-            if (S.m_generateTestSuite) // only load when testing code is required
+            if (S.m_generateTestSuite || S.m_generateBenchmarkSuite) // only load when testing or benchmark code is required (the benchmark templates are in the same file)
                 cog.LoadTemplates(g25_cg_cpp.Properties.Resources.cg_cpp_test_templates, "cg_cpp_test_templates.txt");
         }
 
@@ -0,0 +1,135 @@
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+// Copyright 2008-2010, Daniel Fontijne, University of Amsterdam -- fontijne@science.uva.nl
+
+using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.Text;
+
+namespace G25.CG.CPP
+{
+    /// <summary>
+    /// Handles code generation for binary serialization (writeBinary() and readBinary()).
+    /// 
+    /// Each binary record starts with a header which contains a type tag and a schema hash. The schema hash
+    /// is derived from the layout of the type in the specification (basis vector names, basis blades, 
+    /// constant coordinates), so data written by code generated from an incompatible specification is rejected.
+    /// </summary>
+    class Serialization
+    {
+        /// <summary>
+        /// Type tag of the general multivector. Specialized multivector <c>S.m_SMV[i]</c> has type tag <c>i + 1</c>.
+        /// </summary>
+        public const int GMV_TYPE_TAG = 0;
+
+        /// <returns>Round-trip string representation of <paramref name="x"/> which does not depend on the culture of the machine 
+        /// (otherwise the schema hash would differ between code generated on different machines).</returns>
+        private static string ToString(double x)
+        {
+            return x.ToString("R", CultureInfo.InvariantCulture);
+        }
+
+        /// <returns>The schema hash of the general multivector (depends on the basis vectors and the groups).</returns>
+        public static uint GetSchemaHash(Specification S, G25.GMV gmv)
+        {
+            StringBuilder SB = new StringBuilder();
+            SB.Append("gmv " + gmv.Name + " " + String.Join(",", S.m_basisVectorNames.ToArray()));
+            for (int g = 0; g < gmv.NbGroups; g++)
+            {
+                SB.Append(" |");
+                foreach (RefGA.BasisBlade B in gmv.Group(g))
+                    SB.Append(" " + B.bitmap + ":" + ToString(B.scale));
+            }
+            return G25.CG.Shared.Util.GetStringHash(2166136261u, SB.ToString());
+        }
+
+        /// <returns>The schema hash of specialized multivector <paramref name="smv"/> (depends on the basis vectors, the basis blades and the constant coordinates).</returns>
+        public static uint GetSchemaHash(Specification S, G25.SMV smv)
+        {
+            StringBuilder SB = new StringBuilder();
+            SB.Append("smv " + smv.Name + " " + String.Join(",", S.m_basisVectorNames.ToArray()) + " |");
+            for (int i = 0; i < smv.NbNonConstBasisBlade; i++)
+                SB.Append(" " + smv.NonConstBasisBlade(i).bitmap + ":" + ToString(smv.NonConstBasisBlade(i).scale));
+            SB.Append(" |");
+            for (int i = 0; i < smv.NbConstBasisBlade; i++)
+                SB.Append(" " + smv.ConstBasisBlade(i).bitmap + ":" + ToString(smv.ConstBasisBlade(i).scale) + "=" + ToString(smv.ConstBasisBladeValue(i)));
+            return G25.CG.Shared.Util.GetStringHash(2166136261u, SB.ToString());
+        }
+
+        /// <summary>
+        /// Write code for binary serialization of the general multivector and all (non-constant) specialized multivectors.
+        /// </summary>
+        /// <param name="SB">Where the code goes.</param>
+        /// <param name="S">Specification.</param>
+        /// <param name="cgd">Code generation data.</param>
+        /// <param name="def">Whether to generate code for definition or declaration.</param>
+        public static void WriteSerialization(StringBuilder SB, G25.Specification S, G25.CG.Shared.CGdata cgd, bool def)
+        {
+            string SUFFIX = (def) ? "Source" : "Header";
+
+            cgd.m_cog.EmitTemplate(SB, "binarySerialization" + SUFFIX, "S=", S);
+
+            uint gmvHash = GetSchemaHash(S, S.m_GMV);
+            foreach (FloatType FT in S.m_floatTypes)
+            {
+                string typeName = FT.GetMangledName(S, S.m_GMV.Name);
+                if (def) // the functions which write/read the value itself
+                    cgd.m_cog.EmitTemplate(SB, "binarySerializationGMVvalue", "S=", S, "FT=", FT, "typeName=", typeName);
+
+                cgd.m_cog.EmitTemplate(SB, "binarySerializationType" + SUFFIX,
+                    "S=", S,
+                    "FT=", FT,
+                    "typeName=", typeName,
+                    "gmv=", true,
+                    "typeTag=", GMV_TYPE_TAG,
+                    "schemaHash=", gmvHash);
+            }
+
+            for (int s = 0; s < S.m_SMV.Count; s++)
+            {
+                G25.SMV smv = S.m_SMV[s];
+                if (smv.NbNonConstBasisBlade == 0) continue; // nothing to serialize
+
+                string[] getters = new string[smv.NbNonConstBasisBlade];
+                for (int i = 0; i < smv.NbNonConstBasisBlade; i++)
+                    getters[i] = G25.CG.Shared.Main.GETTER_PREFIX + smv.NonConstBasisBlade(i).ToLangString(S.m_basisVectorNames);
+
+                uint smvHash = GetSchemaHash(S, smv);
+                foreach (FloatType FT in S.m_floatTypes)
+                {
+                    string typeName = FT.GetMangledName(S, smv.Name);
+                    if (def) // the functions which write/read the value itself
+                        cgd.m_cog.EmitTemplate(SB, "binarySerializationSMVvalue",
+                            "S=", S,
+                            "FT=", FT,
+                            "smv=", smv,
+                            "typeName=", typeName,
+                            "getters=", getters,
+                            "coordinateOrder=", G25.CG.Shared.SmvUtil.GetCoordinateOrderConstant(S, smv));
+
+                    cgd.m_cog.EmitTemplate(SB, "binarySerializationType" + SUFFIX,
+                        "S=", S,
+                        "FT=", FT,
+                        "typeName=", typeName,
+                        "gmv=", false,
+                        "typeTag=", s + 1,
+                        "schemaHash=", smvHash);
+                }
+            }
+        }
+
+    } // end of class Serialization
+} // end of namespace G25.CG.CPP
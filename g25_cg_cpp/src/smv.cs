@@ -310,7 +310,7 @@ namespace G25.CG.CPP
         /// <param name="smv">The specialized multivector for which the code should be written.</param>
         public static void WriteToString(StringBuilder SB, Specification S, G25.CG.Shared.CGdata cgd, FloatType FT, G25.SMV smv)
         {
-            cgd.m_cog.EmitTemplate(SB, "MVtoStringHeader", "NAMESPACE=", (S.m_namespace.Length > 0) ? "::" + S.m_namespace + "::" : "");
+            cgd.m_cog.EmitTemplate(SB, "MVtoStringHeader", "S=", S, "NAMESPACE=", (S.m_namespace.Length > 0) ? "::" + S.m_namespace + "::" : "");
         }
 
         /// <summary>
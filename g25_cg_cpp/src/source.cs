@@ -281,13 +281,8 @@ namespace G25.CG.CPP
             G25.CG.Shared.Util.WriteCopyright(SB, S);
             G25.CG.Shared.Util.WriteLicense(SB, S);
 
-            { // #includes
-                SB.AppendLine("#include <stdio.h>");
-                SB.AppendLine("#include <utility> // for std::swap");
-                if (cgd.GetFeedback(G25.CG.Shared.Main.NEED_TIME) == "true")
-                    SB.AppendLine("#include <time.h> /* used to seed random generator */");
-                SB.AppendLine("#include \"" + S.GetOutputFilename(G25.CG.CPP.Header.GetRawHeaderFilename(S)) + "\"");
-            }
+            // #includes
+            WriteIncludes(SB, S, cgd);
 
             G25.CG.Shared.Util.WriteOpenNamespace(SB, S);
 
@@ -300,7 +295,11 @@ namespace G25.CG.CPP
             G25.CG.CPP.Constants.WriteDefinitions(SB, S, cgd);
 
             // write report usage
-            cgd.m_cog.EmitTemplate(SB, (S.m_reportUsage) ? "ReportUsageSource" : "NoReportUsageSource");
+            cgd.m_cog.EmitTemplate(SB, (S.m_reportUsage) ? "ReportUsageSource" : "NoReportUsageSource", "S=", S);
+
+            // write instrumentation (call counting / timing)
+            if (S.m_instrumentation)
+                cgd.m_cog.EmitTemplate(SB, "InstrumentationSource", "S=", S);
 
             if (S.m_gmvCodeGeneration == GMV_CODE.RUNTIME)
             {
@@ -323,19 +322,101 @@ namespace G25.CG.CPP
                 G25.CG.CPP.ToString.WriteToString(SB, S, cgd, def);
             }
 
+            { // write binary serialization
+                bool def = true;
+                G25.CG.CPP.Serialization.WriteSerialization(SB, S, cgd, def);
+            }
+
             // write operators
             if (!S.m_inlineOperators)
                 Operators.WriteOperatorDefinitions(SB, S, cgd);
 
             SB.AppendLine("// def SB:");
+            string preamble = null;
+            if (cgd.m_defSpool != null)
+            { // the definitions so far were streamed to a temporary file; they go in between 'preamble' and the rest of SB
+                preamble = SB.ToString();
+                SB = new StringBuilder();
+            }
             SB.Append(cgd.m_defSB);
 
             // close namespace
             G25.CG.Shared.Util.WriteCloseNamespace(SB, S);                    
 
             // write all to file
-            G25.CG.Shared.Util.WriteFile(sourceFilename, SB.ToString());
+            if (cgd.m_defSpool != null)
+            {
+                cgd.m_defSpool.CopyTo(sourceFilename, preamble, SB.ToString());
+                cgd.m_defSpool = null; // later code (e.g., testing code) goes into m_defSB again
+            }
+            else G25.CG.Shared.Util.WriteFile(sourceFilename, SB.ToString());
+
+            // write internal header and other source files
+            if (cgd.m_sourceShards != null)
+                generatedFiles.AddRange(GenerateShards(S, cgd));
+
+            return generatedFiles;
+        }
+
+        /// <summary>
+        /// Writes the #include directives of the source file(s).
+        /// When the source is split over multiple files, the internal header is included instead of the regular header.
+        /// </summary>
+        public static void WriteIncludes(StringBuilder SB, Specification S, G25.CG.Shared.CGdata cgd)
+        {
+            SB.AppendLine("#include <stdio.h>");
+            SB.AppendLine("#include <utility> // for std::swap");
+            if (cgd.GetFeedback(G25.CG.Shared.Main.NEED_TIME) == "true")
+                SB.AppendLine("#include <time.h> /* used to seed random generator */");
+            cgd.m_cog.EmitTemplate(SB, "toStringIncludes", "S=", S);
+            if (cgd.m_sourceShards != null)
+                SB.AppendLine("#include \"" + S.GetOutputFilename(G25.CG.Shared.SourceShards.GetRawInternalHeaderFilename(S)) + "\"");
+            else SB.AppendLine("#include \"" + S.GetOutputFilename(G25.CG.CPP.Header.GetRawHeaderFilename(S)) + "\"");
+        }
+
+        /// <summary>
+        /// Generates the internal header and the source files of all function families 
+        /// (parts, set functions, converters, functions), when the source is split over multiple files.
+        /// </summary>
+        /// <param name="S">Specification of algebra.</param>
+        /// <param name="cgd">The definitions are taken from <c>cgd.m_sourceShards</c>.</param>
+        /// <returns>a list of filenames which were generated (full path).</returns>
+        public static List<string> GenerateShards(Specification S, G25.CG.Shared.CGdata cgd)
+        {
+            List<string> generatedFiles = new List<string>();
+
+            { // internal header (declarations shared by all source files)
+                string rawHeaderFilename = G25.CG.Shared.SourceShards.GetRawInternalHeaderFilename(S);
+                string headerFilename = S.GetOutputPath(rawHeaderFilename);
+                generatedFiles.Add(headerFilename);
+
+                StringBuilder SB = new StringBuilder();
+                G25.CG.Shared.Util.WriteCopyright(SB, S);
+                G25.CG.Shared.Util.WriteLicense(SB, S);
+                G25.CG.Shared.Util.WriteOpenIncludeGuard(SB, rawHeaderFilename);
+                SB.AppendLine("");
+                SB.AppendLine("#include \"" + S.GetOutputFilename(G25.CG.CPP.Header.GetRawHeaderFilename(S)) + "\"");
+
+                G25.CG.Shared.Util.WriteOpenNamespace(SB, S);
+                SB.Append(cgd.m_sourceShards.GetDeclarations());
+                G25.CG.Shared.Util.WriteCloseNamespace(SB, S);
+
+                G25.CG.Shared.Util.WriteCloseIncludeGuard(SB, rawHeaderFilename);
+                G25.CG.Shared.Util.WriteFile(headerFilename, SB.ToString());
+            }
 
+            { // source files (the definitions were already streamed to temporary files)
+                StringBuilder preambleSB = new StringBuilder();
+                G25.CG.Shared.Util.WriteCopyright(preambleSB, S);
+                G25.CG.Shared.Util.WriteLicense(preambleSB, S);
+                WriteIncludes(preambleSB, S, cgd);
+                G25.CG.Shared.Util.WriteOpenNamespace(preambleSB, S);
+
+                StringBuilder postambleSB = new StringBuilder();
+                G25.CG.Shared.Util.WriteCloseNamespace(postambleSB, S);
+
+                generatedFiles.AddRange(cgd.m_sourceShards.WriteShards(".cpp", preambleSB.ToString(), postambleSB.ToString()));
+            }
 
             return generatedFiles;
         }
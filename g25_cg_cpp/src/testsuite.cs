@@ -153,6 +153,11 @@ namespace G25.CG.CPP
                 // toString & parser (if available)
                 if (S.m_parserType != PARSER.NONE)
                     testFunctionNames.Add(WriteParserTest(S, cgd, randomNumberGenerators[0], randomVersorFuncName, subtractGmvFuncName));
+                if (S.m_parserType == PARSER.BUILTIN)
+                    testFunctionNames.Add(WriteParseStreamTest(S, cgd, randomNumberGenerators[0], randomVersorFuncName, subtractGmvFuncName));
+
+                // binary serialization
+                testFunctionNames.Add(WriteBinarySerializationTest(S, cgd, randomNumberGenerators[0], randomVersorFuncName, subtractGmvFuncName));
             }
 
             { // write all test functions
@@ -244,6 +249,96 @@ namespace G25.CG.CPP
             return testFuncName;
         } // end of WriteParserTest()
 
+        /// <summary>
+        /// Writes test code for the streaming parser (ParseStream, builtin parser only) to <c>cgd.m_defSB</c>.
+        /// </summary>
+        /// <param name="S">Specification of algebra.</param>
+        /// <param name="cgd">Code generation data (used for <c>m_cog</c> and <c>m_defSB</c>.</param>
+        /// <param name="randomNumberGeneratorFuncName">Function for random number generator (main float type).</param>
+        /// <param name="randomVersorFuncName">Function for random versor (main float type).</param>
+        /// <param name="subtractGmvFuncName">Function for subtracting general multivectors (main float type).</param>
+        /// <returns>Name of the test function.</returns>
+        public static string WriteParseStreamTest(G25.Specification S, G25.CG.Shared.CGdata cgd,
+            string randomNumberGeneratorFuncName,
+            string randomVersorFuncName,
+            string subtractGmvFuncName)
+        {
+            FloatType FT = S.m_floatTypes[0];
+            string testFuncName = "test_" + FT.GetMangledName(S, "ParseStream");
+
+            // for each specialized type which ParseStream can parse into: a value which does not fit in the type (or null)
+            List<G25.SMV> smvs = new List<G25.SMV>();
+            List<string> foreignValues = new List<string>();
+            foreach (G25.SMV smv in S.m_SMV)
+            {
+                if (smv.NbNonConstBasisBlade == 0) continue;
+                smvs.Add(smv);
+
+                string foreignValue = null;
+                for (uint bitmap = 0; (bitmap < (1 << S.m_dimension)) && (foreignValue == null); bitmap++)
+                {
+                    if (smv.GetElementIdx(new RefGA.BasisBlade(bitmap)) >= 0) continue;
+                    string bladeName = "";
+                    for (int i = 0; i < S.m_dimension; i++)
+                        if ((bitmap & (1 << i)) != 0)
+                            bladeName += ((bladeName.Length > 0) ? "^" : "") + S.m_basisVectorNames[i];
+                    foreignValue = (bladeName.Length > 0) ? ("2.0*" + bladeName) : "2.0";
+                }
+                foreignValues.Add(foreignValue);
+            }
+
+            System.Collections.Hashtable argTable = new System.Collections.Hashtable();
+            argTable["S"] = S;
+            argTable["FT"] = FT;
+            argTable["gmvName"] = FT.GetMangledName(S, S.m_GMV.Name);
+            argTable["parseStreamName"] = FT.GetMangledName(S, "ParseStream");
+            argTable["testFuncName"] = testFuncName;
+            argTable["smvs"] = smvs.ToArray();
+            argTable["foreignValues"] = foreignValues.ToArray();
+            argTable["randomScalarFuncName"] = randomNumberGeneratorFuncName;
+            argTable["randomVersorFuncName"] = randomVersorFuncName;
+            argTable["subtractGmvFuncName"] = subtractGmvFuncName;
+            cgd.m_cog.EmitTemplate(cgd.m_defSB, "testParseStream", argTable);
+            return testFuncName;
+        } // end of WriteParseStreamTest()
+
+        /// <summary>
+        /// Writes test code for writeBinary() and readBinary() to <c>cgd.m_defSB</c>.
+        /// Values of the main float type are tested. When there is more than one float type, the values are also read into the general multivector of the second float type.
+        /// </summary>
+        /// <param name="S">Specification of algebra.</param>
+        /// <param name="cgd">Code generation data (used for <c>m_cog</c> and <c>m_defSB</c>.</param>
+        /// <param name="randomNumberGeneratorFuncName">Function for random number generator (main float type).</param>
+        /// <param name="randomVersorFuncName">Function for random versor (main float type).</param>
+        /// <param name="subtractGmvFuncName">Function for subtracting general multivectors (main float type).</param>
+        /// <returns>Name of the test function.</returns>
+        public static string WriteBinarySerializationTest(G25.Specification S, G25.CG.Shared.CGdata cgd,
+            string randomNumberGeneratorFuncName,
+            string randomVersorFuncName,
+            string subtractGmvFuncName)
+        {
+            FloatType FT = S.m_floatTypes[0];
+            string gmvName = FT.GetMangledName(S, S.m_GMV.Name);
+            string testFuncName = "test_binarySerialization_" + gmvName;
+
+            List<G25.SMV> smvs = new List<G25.SMV>();
+            foreach (G25.SMV smv in S.m_SMV)
+                if (smv.NbNonConstBasisBlade > 0) smvs.Add(smv);
+
+            System.Collections.Hashtable argTable = new System.Collections.Hashtable();
+            argTable["S"] = S;
+            argTable["FT"] = FT;
+            argTable["gmvName"] = gmvName;
+            argTable["otherGmvName"] = (S.m_floatTypes.Count > 1) ? S.m_floatTypes[1].GetMangledName(S, S.m_GMV.Name) : "";
+            argTable["testFuncName"] = testFuncName;
+            argTable["smvs"] = smvs.ToArray();
+            argTable["randomScalarFuncName"] = randomNumberGeneratorFuncName;
+            argTable["randomVersorFuncName"] = randomVersorFuncName;
+            argTable["subtractGmvFuncName"] = subtractGmvFuncName;
+            cgd.m_cog.EmitTemplate(cgd.m_defSB, "testBinarySerialization", argTable);
+            return testFuncName;
+        } // end of WriteBinarySerializationTest()
+
         public static List<string> WriteMetricTests(G25.Specification S, G25.CG.Shared.CGdata cgd,
             Dictionary<String, String> gpGmvFuncName) // , string gpFuncName
         {
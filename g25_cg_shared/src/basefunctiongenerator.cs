@@ -113,6 +113,46 @@ namespace G25.CG.Shared
             return null; // this means no testing function
         }
 
+        /// <summary>
+        /// This function should check the dependencies for the _benchmark_ code of this function.
+        /// 
+        /// The default implementation asks for the random generators required to fill in the arguments
+        /// (see G25.CG.Shared.Benchmark.GetRandomArgumentCode()). Subclasses can override, for example
+        /// to generate more representative inputs.
+        /// </summary>
+        public virtual void CheckBenchmarkDepencies()
+        {
+            foreach (string floatName in m_fgs.FloatNames)
+            {
+                FloatType FT = m_specification.GetFloatType(floatName);
+                m_benchmarkArgumentCode[FT.type] = G25.CG.Shared.Benchmark.GetRandomArgumentCode(m_specification, m_cgd, m_fgs, FT, m_G25M.m_name);
+            }
+        }
+
+        /// <summary>
+        /// Should write the benchmark function for 'F' to 'm_defSB'.
+        /// 
+        /// The default implementation times the function with the name in <c>m_funcName</c> on the random
+        /// arguments computed by CheckBenchmarkDepencies(). Functions with arguments that cannot
+        /// be generated randomly are skipped.
+        /// </summary>
+        /// <returns>The list of names of the bool(benchmarkResult &amp;) functions which benchmark the function.</returns>
+        public virtual List<string> WriteBenchmarkFunction()
+        {
+            List<string> benchmarkFuncNames = new List<string>();
+            foreach (string floatName in m_fgs.FloatNames)
+            {
+                FloatType FT = m_specification.GetFloatType(floatName);
+                if ((!m_funcName.ContainsKey(FT.type)) || (!m_benchmarkArgumentCode.ContainsKey(FT.type)) ||
+                    (m_benchmarkArgumentCode[FT.type] == null)) continue;
+
+                string benchmarkFuncName = G25.CG.Shared.Benchmark.WriteBenchmarkFunction(m_specification, m_cgd, m_fgs, FT, 
+                    m_funcName[FT.type], m_benchmarkArgumentCode[FT.type]);
+                if (benchmarkFuncName != null) benchmarkFuncNames.Add(benchmarkFuncName);
+            }
+            return benchmarkFuncNames;
+        }
+
 
         /// <summary>
         /// Entry point for new thread. Catches G25.ErrorExceptions and puts them in m_cgd.
@@ -215,6 +255,47 @@ namespace G25.CG.Shared
             }
         }
 
+        /// <summary>
+        /// Entry point for new thread. Catches G25.ErrorExceptions and puts them in m_cgd.
+        /// If an exception is caught, m_sane is set to false.
+        /// Aborts the call when m_sane is false on entry.
+        /// </summary>
+        public void CheckBenchmarkDepenciesEntryPoint()
+        {
+            if (!m_sane) return;
+            try
+            {
+                CheckBenchmarkDepencies();
+            }
+            catch (G25.UserException E)
+            {
+                ErrorDetected(E);
+            }
+        }
+
+        /// <summary>
+        /// Entry point for new thread. Catches G25.ErrorExceptions and puts them in m_cgd.
+        /// If an exception is caught, m_sane is set to false.
+        /// Aborts the call when m_sane is false on entry.
+        /// The names of the generated benchmark functions are stored in <c>m_cgd.m_generatedBenchmarkFunctions</c>.
+        /// </summary>
+        public void WriteBenchmarkFunctionEntryPoint()
+        {
+            List<string> funcNames = null;
+            if (m_sane)
+            {
+                try
+                {
+                    funcNames = WriteBenchmarkFunction();
+                }
+                catch (G25.UserException E)
+                {
+                    ErrorDetected(E);
+                }
+            }
+            m_cgd.m_generatedBenchmarkFunctions = funcNames;
+        }
+
         protected void ErrorDetected(G25.UserException E)
         {
             m_sane = false; // do not continue code generation for this type
@@ -255,6 +336,11 @@ namespace G25.CG.Shared
         /// Set to true by default, but set to false when an error occurs.
         /// </summary>
         protected bool m_sane;
+        /// <summary>Name of the generated function for each float type, with full mangling, etc. Set by WriteFunction() of the subclass.</summary>
+        protected Dictionary<string, string> m_funcName = new Dictionary<string, string>();
+        /// <summary>Code which generates a random value for each argument, for each float type (set by CheckBenchmarkDepencies()).
+        /// The entry is null when some argument cannot be generated.</summary>
+        protected Dictionary<string, string[]> m_benchmarkArgumentCode = new Dictionary<string, string[]>();
 
 
 
@@ -0,0 +1,129 @@
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+// Copyright 2008-2010, Daniel Fontijne, University of Amsterdam -- fontijne@science.uva.nl
+
+using System;
+using System.Collections.Generic;
+using System.Text;
+
+namespace G25.CG.Shared
+{
+    /// <summary>
+    /// Helper functions for generating benchmark code (see Specification.m_generateBenchmarkSuite).
+    ///
+    /// Used by the default implementation of BaseFunctionGenerator.CheckBenchmarkDepencies() and
+    /// BaseFunctionGenerator.WriteBenchmarkFunction(). The actual code is emitted by the <c>benchmarkFunction</c> template.
+    /// </summary>
+    public static class Benchmark
+    {
+        /// <summary>
+        /// Returns code which generates a random value for each argument of <paramref name="F"/>.
+        /// The required random generators are requested as dependencies:
+        ///   - floating point arguments use <c>random_float</c> (or whatever float type <paramref name="FT"/> is),
+        ///   - specialized multivector arguments use <c>random_smv</c>, scaled by a random float,
+        ///   - general multivector arguments use <c>random_versor</c>, with a random grade.
+        ///
+        /// Other types of arguments (outermorphisms, integers, pointers, arrays, constant specialized multivectors)
+        /// cannot be generated, in which case null is returned.
+        /// </summary>
+        /// <param name="S">Specification of algebra.</param>
+        /// <param name="cgd">Missing dependencies are registered here.</param>
+        /// <param name="F">The function (the argument types must be completed).</param>
+        /// <param name="FT">Floating point type of the benchmark.</param>
+        /// <param name="metricName">Metric used for random versors.</param>
+        /// <returns>Code for each argument, or null.</returns>
+        public static string[] GetRandomArgumentCode(Specification S, CGdata cgd, G25.fgs F, G25.FloatType FT, string metricName)
+        {
+            string[] argCode = new string[F.NbArguments];
+            string randomScalarFuncName = null;
+            for (int i = 0; i < F.NbArguments; i++)
+            {
+                if (F.GetArgumentPtr(S, i) || F.GetArgumentArr(S, i)) return null;
+
+                G25.VariableType VT = S.GetType(F.ArgumentTypeNames[i]);
+                if (!((VT is G25.FloatType) || (VT is G25.SMV) || (VT is G25.GMV))) return null;
+                if ((VT is G25.SMV) && ((G25.SMV)VT).IsConstant()) return null;
+
+                if (randomScalarFuncName == null)
+                    randomScalarFuncName = G25.CG.Shared.Dependencies.GetDependency(S, cgd, "random_" + FT.type, new String[0], FT.type, FT, null);
+
+                if (VT is G25.FloatType)
+                {
+                    argCode[i] = randomScalarFuncName + "()";
+                }
+                else if (VT is G25.SMV)
+                {
+                    string randomSmvFuncName = G25.CG.Shared.Dependencies.GetDependency(S, cgd, "random_" + ((G25.SMV)VT).Name, new String[0], null, FT, null);
+                    argCode[i] = randomSmvFuncName + "(" + randomScalarFuncName + "())";
+                }
+                else // GMV
+                {
+                    string randomVersorFuncName = G25.CG.Shared.Dependencies.GetDependency(S, cgd, "random_versor", new String[0], S.m_GMV.Name, FT, metricName);
+                    argCode[i] = randomVersorFuncName + "(" + randomScalarFuncName + "(), " +
+                        "(int)(" + randomScalarFuncName + "() * " + FT.DoubleToString(S, S.m_dimension + 0.5) + "), -1)";
+                }
+            }
+            return argCode;
+        }
+
+        /// <summary>
+        /// Writes a benchmark function for function <paramref name="funcName"/> to <c>cgd.m_defSB</c>.
+        /// The generated function has signature <c>bool name(benchmarkResult &amp;R)</c>; it returns false when the function was not selected on the command line.
+        /// </summary>
+        /// <param name="S">Specification of algebra.</param>
+        /// <param name="cgd">Code is written to <c>cgd.m_defSB</c>.</param>
+        /// <param name="F">The function (must be completed).</param>
+        /// <param name="FT">Floating point type of the benchmark.</param>
+        /// <param name="funcName">Name of the generated function which is benchmarked.</param>
+        /// <param name="argCode">Code which generates a random value for each argument (see GetRandomArgumentCode()).</param>
+        /// <returns>Name of the benchmark function, or null if the function could not be benchmarked.</returns>
+        public static string WriteBenchmarkFunction(Specification S, CGdata cgd, G25.fgs F, G25.FloatType FT, string funcName, string[] argCode)
+        {
+            if ((F.ReturnTypeName == null) || (F.ReturnTypeName.Length == 0)) return null;
+
+            string benchmarkFuncName = "benchmark_" + funcName + cgd.GetDontMangleUniqueId();
+
+            string[] argTypeNames = new string[argCode.Length];
+            StringBuilder displayName = new StringBuilder(F.OutputName + "(");
+            StringBuilder callArgs = new StringBuilder();
+            for (int i = 0; i < argCode.Length; i++)
+            {
+                argTypeNames[i] = FT.GetMangledName(S, F.ArgumentTypeNames[i]);
+                if (i > 0)
+                {
+                    displayName.Append(", ");
+                    callArgs.Append(", ");
+                }
+                displayName.Append(argTypeNames[i]);
+                callArgs.Append("arg" + i + "[i]");
+            }
+            displayName.Append(")");
+
+            System.Collections.Hashtable argTable = new System.Collections.Hashtable();
+            argTable["S"] = S;
+            argTable["FT"] = FT;
+            argTable["benchmarkFuncName"] = benchmarkFuncName;
+            argTable["targetFuncName"] = funcName;
+            argTable["displayName"] = displayName.ToString();
+            argTable["returnTypeName"] = FT.GetMangledName(S, F.ReturnTypeName);
+            argTable["argTypeNames"] = argTypeNames;
+            argTable["argCode"] = argCode;
+            argTable["callArgs"] = callArgs.ToString();
+            cgd.m_cog.EmitTemplate(cgd.m_defSB, "benchmarkFunction", argTable);
+
+            return benchmarkFuncName;
+        }
+    } // end of class Benchmark
+} // end of namespace G25.CG.Shared
@@ -49,6 +49,7 @@ namespace G25.CG.Shared
             m_feedback = cgd.m_feedback;
             m_dependencyId = cgd.m_dependencyId;
             m_dependencyPrefix = cgd.m_dependencyPrefix;
+            m_sourceShards = cgd.m_sourceShards;
         }
 
         /// <summary>
@@ -296,6 +297,30 @@ namespace G25.CG.Shared
             m_inlineDefSB = new StringBuilder();
         }
 
+        /// <summary>
+        /// Appends the definitions in <c>defSB</c> to the source file: to the shards of <c>family</c> when the source
+        /// is split over multiple files, or to the definition spool when the source file is streamed to disk.
+        /// In the latter case, the definitions collected in <c>m_defSB</c> so far are written to the spool first, 
+        /// such that the order of the definitions is not changed. Otherwise, <c>defSB</c> is appended to <c>m_defSB</c>.
+        /// </summary>
+        /// <param name="family">One of SourceShards.FAMILIES.</param>
+        /// <param name="defSB">The definitions.</param>
+        public void AppendDefinitions(string family, StringBuilder defSB)
+        {
+            if (m_sourceShards != null)
+                m_sourceShards.AppendDefinitions(family, defSB);
+            else if (m_defSpool != null)
+            {
+                if (m_defSB.Length > 0)
+                {
+                    m_defSpool.Write(m_defSB);
+                    m_defSB = new StringBuilder();
+                }
+                m_defSpool.Write(defSB);
+            }
+            else m_defSB.Append(defSB);
+        }
+
         public bool generateOmInitCode(string floatType)
         {
             bool generate = false;
@@ -341,11 +366,29 @@ namespace G25.CG.Shared
         /// </summary>
         public StringBuilder m_inlineDefSB = new StringBuilder();
 
+        /// <summary>
+        /// When the source is split over multiple files (C and C++ only), the definitions of the parts, set functions,
+        /// converters and functions are collected here instead of in <c>m_defSB</c>. Is <c>null</c> otherwise.
+        /// </summary>
+        public SourceShards m_sourceShards;
+
+        /// <summary>
+        /// When the (single) source file of the C and C++ languages is streamed to disk, the definitions 
+        /// which were moved out of <c>m_defSB</c> by AppendDefinitions() go here. Is <c>null</c> otherwise.
+        /// Not copied by the copy constructor (only the main CGdata streams its definitions).
+        /// </summary>
+        public DefinitionSpool m_defSpool;
+
         /// <summary>
         /// Names of generated test functions go here.
         /// </summary>
         public List<string> m_generatedTestFunctions;
 
+        /// <summary>
+        /// Names of generated benchmark functions go here.
+        /// </summary>
+        public List<string> m_generatedBenchmarkFunctions;
+
         /// <summary>
         /// Set of missing dependencies.
         /// </summary>
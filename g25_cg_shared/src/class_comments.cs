@@ -142,7 +142,15 @@ namespace G25.CG.Shared
 
             SB.AppendLine("There are " + gom.Domain.Length + " matrices, one for each grade.");
             SB.AppendLine("The columns of these matrices are the range of the outermorphism.");
-            SB.AppendLine("Matrices are stored in row-major order. So the coordinates of rows are stored contiguously.");
+            if (gom.AlignedLayout)
+            {
+                SB.AppendLine("Matrices are stored in column-major order. So the coordinates of columns are stored contiguously.");
+                SB.AppendLine("Each column is padded to a multiple of " + gom.SimdWidth + " coordinates, and the matrices are aligned to " + (FT.SizeOf() * gom.SimdWidth) + " bytes.");
+            }
+            else SB.AppendLine("Matrices are stored in row-major order. So the coordinates of rows are stored contiguously.");
+            if (gom.Lazy)
+                SB.AppendLine("The matrices of grade 2 and higher are computed on first use. Call validateGrade() before reading them directly.");
+                SB.AppendLine("A const " + FT.GetMangledName(S, gom.Name) + " can be used by several threads at once: the missing matrices are computed only once.");
             for (int g = 1; g < gom.Domain.Length; g++) // start at '1' in order to skip scalar grade
             {
                 SB.Append("Domain grade " + g + ": ");
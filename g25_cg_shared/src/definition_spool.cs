@@ -0,0 +1,121 @@
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+// Copyright 2008-2010, Daniel Fontijne, University of Amsterdam -- fontijne@science.uva.nl
+
+using System;
+using System.Collections.Generic;
+using System.Text;
+
+namespace G25.CG.Shared
+{
+
+    /// <summary>
+    /// Streams definitions to a temporary file, such that they do not have to be kept in memory
+    /// until the source file is written.
+    ///
+    /// The preamble of a source file (#includes, tables, etc) is only known once all code is generated.
+    /// CopyTo() therefore writes the final file afterwards: the preamble, the contents of the
+    /// temporary file (copied in small blocks) and a postamble.
+    ///
+    /// Used for the source shards (see SourceShards) and for the single source file of the C and C++ languages
+    /// (see <c>CGdata.m_defSpool</c>).
+    /// </summary>
+    public class DefinitionSpool
+    {
+        /// <summary>
+        /// Size of the buffer of the temporary file (in bytes).
+        /// </summary>
+        public const int BUFFER_SIZE = 64 * 1024;
+
+        /// <summary>Prefix of the temporary files.</summary>
+        public const string TMP_PREFIX = "~";
+
+        /// <param name="tmpFilename">Full path of the temporary file (it is created immediately).</param>
+        public DefinitionSpool(string tmpFilename)
+        {
+            m_tmpFilename = tmpFilename;
+            m_writer = new System.IO.StreamWriter(tmpFilename, false, new UTF8Encoding(false), BUFFER_SIZE);
+        }
+
+        /// <returns>Full path of the temporary file that goes with raw output filename <paramref name="rawFilename"/>.</returns>
+        public static string GetTmpFilename(Specification S, string rawFilename)
+        {
+            return S.GetOutputPath(TMP_PREFIX + rawFilename + ".tmp");
+        }
+
+        /// <summary>Number of characters written so far.</summary>
+        public long Length
+        {
+            get { return m_length; }
+        }
+
+        /// <summary>Writes <c>length</c> characters of <c>code</c>, starting at <c>startIdx</c>.</summary>
+        public void Write(string code, int startIdx, int length)
+        {
+            m_writer.Write(code.ToCharArray(startIdx, length));
+            m_length += length;
+        }
+
+        /// <summary>Writes the contents of <c>SB</c>.</summary>
+        public void Write(StringBuilder SB)
+        {
+            string code = SB.ToString();
+            Write(code, 0, code.Length);
+        }
+
+        /// <summary>
+        /// Closes the temporary file, writes the final file <c>filename</c> and removes the temporary file
+        /// (also when writing the final file fails).
+        /// </summary>
+        public void CopyTo(string filename, string preamble, string postamble)
+        {
+            System.IO.StreamWriter W = null;
+            System.IO.StreamReader R = null;
+            try
+            {
+                m_writer.Close();
+                W = System.IO.File.CreateText(filename);
+                R = new System.IO.StreamReader(m_tmpFilename, new UTF8Encoding(false));
+                W.Write(preamble);
+                char[] buffer = new char[BUFFER_SIZE];
+                int n;
+                while ((n = R.Read(buffer, 0, buffer.Length)) > 0)
+                    W.Write(buffer, 0, n);
+                W.Write(postamble);
+            }
+            finally
+            {
+                if (R != null) R.Close();
+                if (W != null) W.Close();
+                Delete();
+            }
+        }
+
+        /// <summary>
+        /// Closes and removes the temporary file without writing its contents anywhere.
+        /// Can be called more than once.
+        /// </summary>
+        public void Delete()
+        {
+            m_writer.Close();
+            if (System.IO.File.Exists(m_tmpFilename))
+                System.IO.File.Delete(m_tmpFilename);
+        }
+
+        private string m_tmpFilename;
+        private System.IO.StreamWriter m_writer;
+        private long m_length;
+    } // end of class DefinitionSpool
+} // end of namespace G25.CG.Shared
@@ -98,19 +98,26 @@ namespace G25.CG.Shared
                 FGI.m_functionFGS = functionFGS;
             }
 
-            // start threads to generate code for all converters
-            Thread[] converterThreads = new Thread[converterFGS.Count];
+            // generate code for all converters (on a fixed number of worker threads), collecting the results in order
+            ThreadStart[] converterWork = new ThreadStart[converterFGS.Count];
             Converter[] converters = new Converter[converterFGS.Count];
             for (int f = 0; f < converterFGS.Count; f++)
             {
                 G25.fgs F = converterFGS[f];
                 converters[f] = new Converter(S, cgd, F);
-                converterThreads[f] = new Thread(converters[f].WriteConverter);
+                converterWork[f] = converters[f].WriteConverter;
             }
-            G25.CG.Shared.Threads.StartThreadArray(converterThreads);
+            G25.CG.Shared.Threads.RunWorkQueue(converterWork, delegate(int f)
+            {
+                cgd.m_declSB.Append(converters[f].m_declSB);
+                cgd.AppendDefinitions(SourceShards.CONVERTERS, converters[f].m_defSB);
+                cgd.m_inlineDefSB.Append(converters[f].m_inlineDefSB);
+                cgd.MergeErrors(converters[f].m_cgd);
+                converters[f] = null; // release memory
+            });
 
             // find out which plugin can implement which FGS
-            Thread[] functionThreads = new Thread[functionFGS.Count];
+            ThreadStart[] functionWork = new ThreadStart[functionFGS.Count];
             G25.CG.Shared.BaseFunctionGenerator[] functionGenerators = new G25.CG.Shared.BaseFunctionGenerator[functionFGS.Count];
             G25.CG.Shared.CGdata[] functionCgd = new G25.CG.Shared.CGdata[functionFGS.Count];
             for (int f = 0; f < functionFGS.Count; f++)
@@ -143,59 +150,38 @@ namespace G25.CG.Shared
                 FGI.m_functionCgd = functionCgd;
             }
 
-            // run threads for fill-in of functions
+            // run fill-in of functions
             for (int f = 0; f < functionFGS.Count; f++)
             {
                 if (functionGenerators[f] == null) continue;
-                functionThreads[f] = new Thread(functionGenerators[f].CompleteFGSentryPoint);
+                functionWork[f] = functionGenerators[f].CompleteFGSentryPoint;
             }
-            G25.CG.Shared.Threads.StartThreadArray(functionThreads);
-            G25.CG.Shared.Threads.JoinThreadArray(functionThreads);
-            //G25.CG.Shared.Threads.RunThreadArraySerially(functionThreads);
-
+            G25.CG.Shared.Threads.RunWorkQueue(functionWork, null);
 
-            // runs thread for dependency check of functions
+            // run dependency check of functions
             for (int f = 0; f < functionFGS.Count; f++)
             {
                 if (functionGenerators[f] == null) continue;
-                functionThreads[f] = new Thread(functionGenerators[f].CheckDepenciesEntryPoint);
+                functionWork[f] = functionGenerators[f].CheckDepenciesEntryPoint;
             }
-            G25.CG.Shared.Threads.StartThreadArray(functionThreads);
-            G25.CG.Shared.Threads.JoinThreadArray(functionThreads);
-            //G25.CG.Shared.Threads.RunThreadArraySerially(functionThreads);
+            G25.CG.Shared.Threads.RunWorkQueue(functionWork, null);
 
-            // runs thread for actual code generation of functions
+            // Run the actual code generation of functions, and collect the result of each function in order, as soon as it is done.
+            // This keeps the output deterministic, while the code of finished functions is already 
+            // streamed to the source file(s) and released.
             for (int f = 0; f < functionFGS.Count; f++)
             {
                 if (functionGenerators[f] == null) continue;
-                functionThreads[f] = new Thread(functionGenerators[f].WriteFunctionEntryPoint);
-            }
-            G25.CG.Shared.Threads.StartThreadArray(functionThreads);
-            //G25.CG.Shared.Threads.RunThreadArraySerially(functionThreads);
-
-            // join all the converter threads:
-            G25.CG.Shared.Threads.JoinThreadArray(converterThreads);
-
-            // join all function generation threads
-            G25.CG.Shared.Threads.JoinThreadArray(functionThreads);
-
-            // collect all the results from the threads:
-            for (int f = 0; f < converters.Length; f++)
-            {
-                cgd.m_declSB.Append(converters[f].m_declSB);
-                cgd.m_defSB.Append(converters[f].m_defSB);
-                cgd.m_inlineDefSB.Append(converters[f].m_inlineDefSB);
-                cgd.MergeErrors(converters[f].m_cgd);
+                functionWork[f] = functionGenerators[f].WriteFunctionEntryPoint;
             }
-
-            // collect all the results from the threads:
-            for (int f = 0; f < functionCgd.Length; f++)
+            G25.CG.Shared.Threads.RunWorkQueue(functionWork, delegate(int f)
             {
-                if (functionGenerators[f] == null) continue;
+                if (functionGenerators[f] == null) return;
                 cgd.m_declSB.Append(functionCgd[f].m_declSB);
-                cgd.m_defSB.Append(functionCgd[f].m_defSB);
+                cgd.AppendDefinitions(SourceShards.FUNCTIONS, functionCgd[f].m_defSB);
+                functionCgd[f].m_defSB = new StringBuilder(); // release memory
                 cgd.m_inlineDefSB.Append(functionCgd[f].m_inlineDefSB);
-            }
+            });
 
         } // end of WriteFunctions()
 
@@ -456,6 +442,10 @@ namespace G25.CG.Shared
             if (S.m_reportUsage)
                 instructions.Insert(0, ReportUsage.GetReportInstruction(S, F, arguments));
 
+            // add extra instruction for counting calls / timing
+            if (S.m_instrumentation)
+                instructions.Insert(0, Instrumentation.GetInstrumentationInstruction(S, functionName, GetInstrumentationFloatType(S, F, arguments), arguments));
+
             if (returnArgument != null)
             {
                 int nbTabs = 1;
@@ -516,6 +506,8 @@ namespace G25.CG.Shared
             defSB.AppendLine("");
             defSB.AppendLine("{");
 
+            Instrumentation.WriteInstrumentationCode(defSB, S, cgd, functionName, dstFT, arguments);
+
             int nbTabs = 1; 
             bool declareVariable = false;
             AssignInstruction AI = new AssignInstruction(nbTabs, dstSmv, dstFT, mustCastDst, value, dstName, dstPtr, declareVariable);
@@ -572,6 +564,8 @@ namespace G25.CG.Shared
             defSB.AppendLine("");
             defSB.AppendLine("{");
 
+            Instrumentation.WriteInstrumentationCode(defSB, S, cgd, functionName, returnFT, arguments);
+
             int nbTabs = 1;
             ReturnInstruction RI = new ReturnInstruction(nbTabs, returnType, returnFT, mustCastDst, value);
             RI.Write(defSB, S, cgd);
@@ -581,6 +575,17 @@ namespace G25.CG.Shared
             defSB.AppendLine("}");
         } // end of WriteReturnFunction()
 
+        /// <summary>
+        /// Returns the floating point type under which calls to a function are counted by the instrumentation code:
+        /// the float type of the first argument, or the first float type of <paramref name="F"/> when there are no arguments.
+        /// </summary>
+        private static FloatType GetInstrumentationFloatType(Specification S, G25.fgs F, FuncArgInfo[] arguments)
+        {
+            if ((arguments != null) && (arguments.Length > 0)) return arguments[0].FloatType;
+            else if ((F != null) && (F.NbFloatNames > 0)) return S.GetFloatType(F.FloatNames[0]);
+            else return null;
+        }
+
         /// <summary>
         /// Return true if 'F' does not mix arguments of type SMV and GMV
         /// </summary>
@@ -35,7 +35,6 @@ namespace G25.CG.Shared.Func
         protected RefGA.Multivector m_returnValue; ///< returned value (symbolic multivector)
         protected G25.SMV m_smv1 = null; ///< if function over SMV, type goes here
         protected G25.SMV m_smv2 = null; ///< if function over SMV, type goes here
-        protected Dictionary<string, string> m_funcName = new Dictionary<string, string>();  ///< generated function name with full mangling, etc
 
         /// <returns>true when F.Name == "add".</returns>
         public static bool IsAdd(G25.fgs F)
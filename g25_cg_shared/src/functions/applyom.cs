@@ -34,7 +34,6 @@ namespace G25.CG.Shared.Func
         protected G25.OM m_om;
         protected G25.MV m_mv;
         protected RefGA.Multivector m_returnValue; ///< returned value (symbolic multivector)
-        protected Dictionary<string, string> m_funcName = new Dictionary<string, string>();  ///< generated function name with full mangling, etc
 
         /// <summary>
         /// Checks if this FunctionGenerator can implement a certain function.
@@ -94,30 +93,8 @@ namespace G25.CG.Shared.Func
                 RefGA.Multivector inputValue = tmpFAI[1].MultivectorValue[0];
 
                 // Compute m_returnValue:
-                // Replace each basis blade in 'inputValue' with its value under the outermorphism.
-                m_returnValue = RefGA.Multivector.ZERO;
-                for (int i = 0; i < inputValue.BasisBlades.Length; i++)
-                {
-                    // get input blade and domain for that grade
-                    RefGA.BasisBlade inputBlade = inputValue.BasisBlades[i];
-                    RefGA.BasisBlade[] domainBlades = m_om.DomainForGrade(inputBlade.Grade());
-                    for (int c = 0; c < domainBlades.Length; c++)
-                    {
-                        // if a match is found in the domain, add range vector to m_returnValue
-                        if (domainBlades[c].bitmap == inputBlade.bitmap)
-                        {
-                            bool ptr = m_specification.OutputC();
-                            RefGA.Multivector omColumnValue = G25.CG.Shared.Symbolic.SMVtoSymbolicMultivector(m_specification, m_om.DomainSmvForGrade(inputBlade.Grade())[c], tmpFAI[0].Name, ptr);
-                            RefGA.Multivector inputBladeScalarMultiplier = new RefGA.Multivector(new RefGA.BasisBlade(inputBlade, 0));
-                            RefGA.Multivector domainBladeScalarMultiplier = new RefGA.Multivector(new RefGA.BasisBlade(domainBlades[c], 0));
-                            m_returnValue = RefGA.Multivector.Add(m_returnValue,
-                                RefGA.Multivector.gp(
-                                RefGA.Multivector.gp(omColumnValue, inputBladeScalarMultiplier),
-                                domainBladeScalarMultiplier));
-                            break; // no need to search the other domainBlades too
-                        }
-                    }
-                }
+                bool ptr = m_specification.OutputC();
+                m_returnValue = GetApplyOMvalue(m_specification, m_om, tmpFAI[0].Name, ptr, inputValue);
 
                 // get name of return type
                 if (m_fgs.m_returnTypeName.Length == 0)
@@ -126,6 +103,44 @@ namespace G25.CG.Shared.Func
         }
 
 
+        /// <summary>
+        /// Returns the symbolic value of outermorphism <paramref name="om"/> applied to <paramref name="inputValue"/>:
+        /// each basis blade in <paramref name="inputValue"/> is replaced with its value under the outermorphism.
+        /// Basis blades which are not in the domain of <paramref name="om"/> are lost.
+        /// </summary>
+        /// <param name="S">Specification of algebra.</param>
+        /// <param name="om">The outermorphism type.</param>
+        /// <param name="omName">Name of the outermorphism variable.</param>
+        /// <param name="omPtr">Whether the outermorphism variable is a pointer.</param>
+        /// <param name="inputValue">Symbolic value of the multivector to which the outermorphism is applied.</param>
+        /// <returns>Symbolic value of the result.</returns>
+        public static RefGA.Multivector GetApplyOMvalue(Specification S, G25.OM om, string omName, bool omPtr, RefGA.Multivector inputValue)
+        {
+            RefGA.Multivector value = RefGA.Multivector.ZERO;
+            for (int i = 0; i < inputValue.BasisBlades.Length; i++)
+            {
+                // get input blade and domain for that grade
+                RefGA.BasisBlade inputBlade = inputValue.BasisBlades[i];
+                RefGA.BasisBlade[] domainBlades = om.DomainForGrade(inputBlade.Grade());
+                for (int c = 0; c < domainBlades.Length; c++)
+                {
+                    // if a match is found in the domain, add range vector to value
+                    if (domainBlades[c].bitmap == inputBlade.bitmap)
+                    {
+                        RefGA.Multivector omColumnValue = G25.CG.Shared.Symbolic.SMVtoSymbolicMultivector(S, om.DomainSmvForGrade(inputBlade.Grade())[c], omName, omPtr);
+                        RefGA.Multivector inputBladeScalarMultiplier = new RefGA.Multivector(new RefGA.BasisBlade(inputBlade, 0));
+                        RefGA.Multivector domainBladeScalarMultiplier = new RefGA.Multivector(new RefGA.BasisBlade(domainBlades[c], 0));
+                        value = RefGA.Multivector.Add(value,
+                            RefGA.Multivector.gp(
+                            RefGA.Multivector.gp(omColumnValue, inputBladeScalarMultiplier),
+                            domainBladeScalarMultiplier));
+                        break; // no need to search the other domainBlades too
+                    }
+                }
+            }
+            return value;
+        }
+
         /// <summary>
         /// Write the declaration/definition of 'F' to 'm_declSB', 'm_defSB' and 'm_inlineDefSB',
         /// taking into account parameters specified in specification 'S'.
@@ -154,7 +169,19 @@ namespace G25.CG.Shared.Func
                     m_funcName[FT.type] = CF.OutputName;
 
                     // write out the function:
-                    G25.CG.Shared.Functions.WriteSpecializedFunction(m_specification, m_cgd, CF, FT, FAI, m_returnValue, comment);
+                    if (OMinit.IsLazyGom(m_om))
+                    {
+                        // the required grade matrices must be validated before they are read
+                        List<Instruction> I = new List<Instruction>();
+                        int nbTabs = 1;
+                        bool mustCast = false;
+                        I.Add(OMinit.GetValidateGradeInstruction(m_specification, m_om, FAI[0].Name, FAI[0].Pointer, m_mv.ToMultivectorValue(), nbTabs));
+                        I.Add(new ReturnInstruction(nbTabs, m_specification.GetType(m_fgs.m_returnTypeName), FT, mustCast, m_returnValue));
+
+                        bool staticFunc = Functions.OutputStaticFunctions(m_specification);
+                        G25.CG.Shared.Functions.WriteFunction(m_specification, m_cgd, CF, m_specification.m_inlineFunctions, staticFunc, CF.OutputName, FAI, I, comment);
+                    }
+                    else G25.CG.Shared.Functions.WriteSpecializedFunction(m_specification, m_cgd, CF, FT, FAI, m_returnValue, comment);
                 }
             }
 
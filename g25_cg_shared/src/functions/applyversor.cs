@@ -45,7 +45,6 @@ namespace G25.CG.Shared.Func
         protected RefGA.Multivector m_transformedValue; ///< symbolic value of transformed input multivector
         protected RefGA.Multivector m_n2Value = null; ///< symbolic value of norm squared or versor (can be null)
         protected int m_inputGradeUsage; ///< grade usage bitmap of input (arg #2) multivector
-        protected Dictionary<string, string> m_funcName = new Dictionary<string, string>();  ///< generated function name with full mangling, etc
 
         protected G25.MV m_versorMv; ///< the versor type
         protected G25.MV m_subjectMv; ///< the type of the multivector to which the versor is applied
@@ -141,8 +140,8 @@ namespace G25.CG.Shared.Func
                 m_versorValue = tmpFAI[0].MultivectorValue[0];
                 m_reverseVersorValue = (IsApplyVersorWI(m_fgs)) ? tmpFAI[2].MultivectorValue[0] : RefGA.Multivector.Reverse(m_versorValue);
                 m_transformedValue =
-                    RefGA.Multivector.gp(
-                    RefGA.Multivector.gp(m_versorValue, tmpFAI[1].MultivectorValue[0], m_M),
+                    G25.CG.Shared.ProductCache.gp(
+                    G25.CG.Shared.ProductCache.gp(m_versorValue, tmpFAI[1].MultivectorValue[0], m_M),
                     m_reverseVersorValue, m_M);
 
 
@@ -151,7 +150,7 @@ namespace G25.CG.Shared.Func
 
                 // if rotor is not guaranteed by the user to be unit, compute norm squared
                 if (!m_isUnit)
-                    m_n2Value = RefGA.Multivector.ip(m_reverseVersorValue, m_versorValue, m_M, RefGA.BasisBlade.InnerProductType.LEFT_CONTRACTION);
+                    m_n2Value = G25.CG.Shared.ProductCache.ip(m_reverseVersorValue, m_versorValue, m_M, RefGA.BasisBlade.InnerProductType.LEFT_CONTRACTION);
 
                 // round value if required by metric
                 if (m_G25M.m_round)
@@ -0,0 +1,314 @@
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+// Copyright 2008-2010, Daniel Fontijne, University of Amsterdam -- fontijne@science.uva.nl
+
+using System;
+using System.Collections.Generic;
+using System.Text;
+
+namespace G25.CG.Shared.Func
+{
+    /// <summary>
+    /// Generates code for applying a (unit) versor to an array of multivectors.
+    ///
+    /// The function should be called <c>"applyVersorBatch"</c> or <c>"applyUnitVersorBatch"</c>.
+    /// The first argument is the versor, the second argument is the type of the elements of the array.
+    /// Both must be specialized multivectors. The generated function has the signature
+    /// <c>void applyVersorBatch(const versor &amp;V, const X *src, Y *dst, int nb)</c>, where <c>Y</c> is the
+    /// return type (the type returned by <c>applyVersor(V, X)</c> when it is not specified).
+    ///
+    /// The versor is converted to an outermorphism once (see VersorToOM), after which each element only
+    /// costs the application of that outermorphism (a small matrix-vector product). The first specialized
+    /// outermorphism type which can represent the transformation is used, otherwise the general outermorphism.
+    ///
+    /// Only implemented for C and C++.
+    ///
+    /// The metric can be specified using the <c>metric="metricName"</c> attribute.
+    /// </summary>
+    public class ApplyVersorBatch : G25.CG.Shared.BaseFunctionGenerator
+    {
+        protected const int NB_ARGS = 2;
+        protected const string OM_NAME = "M";
+        protected const string SRC_NAME = "src";
+        protected const string DST_NAME = "dst";
+        protected const string NB_NAME = "nb";
+
+        protected bool m_isUnit; ///< set to true when the versor is unit
+        protected G25.SMV m_versorSmv; ///< the versor type
+        protected G25.SMV m_subjectSmv; ///< the type of the elements of the array
+        protected G25.SMV m_returnSmv; ///< the type of the transformed elements
+        protected G25.OM m_om; ///< the outermorphism type used to apply the versor
+        protected RefGA.Multivector[] m_imageValue; ///< symbolic value of the images of the domain vectors of m_om
+        protected RefGA.Multivector m_n2Value; ///< symbolic value of norm squared of versor (null when m_isUnit)
+        protected RefGA.Multivector m_elementValue; ///< symbolic value of transformed element <c>i</c> (in terms of <c>M</c> and <c>src[i]</c>)
+
+        /// <returns>true when <c>F.Name == "applyVersorBatch"</c>.</returns>
+        public static bool IsApplyVersorBatch(G25.fgs F)
+        {
+            return F.Name == "applyVersorBatch";
+        }
+
+        /// <returns>true when <c>F.Name == "applyUnitVersorBatch"</c>.</returns>
+        public static bool IsApplyUnitVersorBatch(G25.fgs F)
+        {
+            return F.Name == "applyUnitVersorBatch";
+        }
+
+        /// <summary>
+        /// Checks if this FunctionGenerator can implement a certain function.
+        /// </summary>
+        /// <param name="S">The specification of the algebra.</param>
+        /// <param name="F">The function to be implemented.</param>
+        /// <returns>true if 'F' can be implemented</returns>
+        public override bool CanImplement(Specification S, G25.fgs F)
+        {
+            return (IsApplyVersorBatch(F) || IsApplyUnitVersorBatch(F)) &&
+                S.OutputCppOrC() &&
+                F.MatchNbArguments(NB_ARGS) &&
+                G25.CG.Shared.Functions.IsSmv(S, F, 0) && // argument 0 must be a specialized multivector
+                G25.CG.Shared.Functions.IsSmv(S, F, 1); // argument 1 must be a specialized multivector
+        }
+
+        /// <summary>
+        /// If this FunctionGenerator can implement 'F', then this function should complete the (possible)
+        /// blanks in 'F'. This means:
+        ///  - Fill in F.m_returnTypeName if it is empty
+        ///  - Fill in F.m_argumentTypeNames (and m_argumentVariableNames) if it is empty.
+        /// </summary>
+        public override void CompleteFGS()
+        {
+            m_isUnit = IsApplyUnitVersorBatch(m_fgs);
+
+            // init argument pointers from the completed typenames (language sensitive);
+            m_fgs.InitArgumentPtrFromTypeNames(m_specification);
+
+            // get all function info
+            FloatType FT = m_specification.GetFloatType(m_fgs.FloatNames[0]);
+            bool computeMultivectorValue = true;
+            G25.CG.Shared.FuncArgInfo[] tmpFAI = G25.CG.Shared.FuncArgInfo.GetAllFuncArgInfo(m_specification, m_fgs, NB_ARGS, FT, m_specification.m_GMV.Name, computeMultivectorValue);
+            m_versorSmv = (G25.SMV)tmpFAI[0].Type;
+            m_subjectSmv = (G25.SMV)tmpFAI[1].Type;
+
+            RefGA.Multivector versorValue = tmpFAI[0].MultivectorValue[0];
+            RefGA.Multivector subjectValue = tmpFAI[1].MultivectorValue[0];
+
+            // get symbolic value of versor * X * reverse(versor) (used to find the outermorphism and return type)
+            RefGA.Multivector transformedValue = G25.CG.Shared.ProductCache.gp(
+                G25.CG.Shared.ProductCache.gp(versorValue, subjectValue, m_M),
+                RefGA.Multivector.Reverse(versorValue), m_M);
+            transformedValue = transformedValue.ExtractGrade(RefGA.Multivector.GradeBitmapToArray(subjectValue.GradeUsage()));
+            if (m_G25M.m_round)
+                transformedValue = transformedValue.Round(1e-14);
+
+            // find outermorphism type, compute images of domain vectors
+            m_om = FindOM(m_specification, m_G25M, versorValue, subjectValue, transformedValue, m_isUnit);
+            m_imageValue = VersorToOM.GetVectorImages(m_G25M, m_om, versorValue, m_isUnit, out m_n2Value);
+
+            // element i = applyOM(M, src[i]) (the scalar part is not transformed)
+            bool srcPtr = false;
+            RefGA.Multivector srcValue = G25.CG.Shared.Symbolic.SMVtoSymbolicMultivector(m_specification, m_subjectSmv, SRC_NAME + "[i]", srcPtr);
+            bool omPtr = false;
+            m_elementValue = RefGA.Multivector.Add(
+                ApplyOM.GetApplyOMvalue(m_specification, m_om, OM_NAME, omPtr, srcValue),
+                srcValue.ExtractGrade(0));
+
+            // get name of return type
+            if (m_fgs.m_returnTypeName.Length == 0)
+                m_fgs.m_returnTypeName = G25.CG.Shared.SpecializedReturnType.GetReturnType(m_specification, m_cgd, m_fgs, FT, transformedValue).GetName();
+            m_returnSmv = m_specification.GetType(m_fgs.m_returnTypeName) as G25.SMV;
+            if (m_returnSmv == null)
+                throw new G25.UserException("The return type of " + m_fgs.Name + " must be a specialized multivector.");
+        }
+
+        /// <summary>
+        /// Finds an outermorphism type which can apply versor <paramref name="versorValue"/> to <paramref name="subjectValue"/>.
+        /// The domain of the outermorphism must contain all basis blades of <paramref name="subjectValue"/>, and the
+        /// range must contain the images of the domain vectors and all basis blades of <paramref name="transformedValue"/>.
+        /// </summary>
+        /// <returns>The first suitable specialized outermorphism, or else the general outermorphism.</returns>
+        public static G25.OM FindOM(Specification S, G25.Metric G25M, RefGA.Multivector versorValue,
+            RefGA.Multivector subjectValue, RefGA.Multivector transformedValue, bool unit)
+        {
+            foreach (G25.SOM som in S.m_SOM)
+            {
+                if (IsSuitableOM(G25M, som, versorValue, subjectValue, transformedValue, unit))
+                    return som;
+            }
+
+            if (S.m_GOM == null)
+                throw new G25.UserException("No outermorphism type can represent the transformation, and no general outermorphism type is defined.");
+            return S.m_GOM;
+        }
+
+        /// <returns>true when <paramref name="om"/> can be used to apply versor <paramref name="versorValue"/> to <paramref name="subjectValue"/> (see FindOM()).</returns>
+        protected static bool IsSuitableOM(G25.Metric G25M, G25.OM om, RefGA.Multivector versorValue,
+            RefGA.Multivector subjectValue, RefGA.Multivector transformedValue, bool unit)
+        {
+            foreach (RefGA.BasisBlade B in subjectValue.BasisBlades)
+                if ((B.Grade() > 0) && (!ContainsBitmap(om.DomainForGrade(B.Grade()), B.bitmap))) return false;
+
+            foreach (RefGA.BasisBlade B in transformedValue.BasisBlades)
+                if ((B.Grade() > 0) && (!ContainsBitmap(om.RangeForGrade(B.Grade()), B.bitmap))) return false;
+
+            RefGA.Multivector n2Value;
+            RefGA.Multivector[] imageValue = VersorToOM.GetVectorImages(G25M, om, versorValue, unit, out n2Value);
+            foreach (RefGA.Multivector image in imageValue)
+                foreach (RefGA.BasisBlade B in image.BasisBlades)
+                    if (!ContainsBitmap(om.RangeVectors, B.bitmap)) return false;
+
+            return true;
+        }
+
+        /// <returns>true when one of the blades in <paramref name="L"/> has bitmap <paramref name="bitmap"/>.</returns>
+        protected static bool ContainsBitmap(RefGA.BasisBlade[] L, uint bitmap)
+        {
+            foreach (RefGA.BasisBlade B in L)
+                if (B.bitmap == bitmap) return true;
+            return false;
+        }
+
+        /// <summary>
+        /// The array arguments cannot be generated randomly, so no benchmark is generated.
+        /// </summary>
+        public override void CheckBenchmarkDepencies()
+        {
+        }
+
+        /// <summary>
+        /// Writes the declaration/definitions of 'F' to StringBuffer 'SB', taking into account parameters specified in specification 'S'.
+        /// </summary>
+        public override void WriteFunction()
+        {
+            foreach (string floatName in m_fgs.FloatNames)
+            {
+                FloatType FT = m_specification.GetFloatType(floatName);
+
+                bool computeMultivectorValue = false;
+                G25.CG.Shared.FuncArgInfo[] FAI = G25.CG.Shared.FuncArgInfo.GetAllFuncArgInfo(m_specification, m_fgs, NB_ARGS, FT, m_specification.m_GMV.Name, computeMultivectorValue);
+
+                // because of lack of overloading, function names include names of argument types
+                G25.fgs CF = G25.CG.Shared.Util.AppendTypenameToFuncName(m_specification, FT, m_fgs, FAI);
+                m_funcName[FT.type] = CF.OutputName;
+
+                string omTypeName = FT.GetMangledName(m_specification, m_om.Name);
+                string srcTypeName = FT.GetMangledName(m_specification, m_subjectSmv.Name);
+                string dstTypeName = FT.GetMangledName(m_specification, m_returnSmv.Name);
+                string versorRefStr = (m_specification.OutputC()) ? "*" : "&";
+
+                string funcDecl = "void " + CF.OutputName + "(const " + FAI[0].MangledTypeName + " " + versorRefStr + FAI[0].Name + ", " +
+                    "const " + srcTypeName + " *" + SRC_NAME + ", " + dstTypeName + " *" + DST_NAME + ", int " + NB_NAME + ")";
+
+                // generate comment
+                string warningComment = (m_isUnit) ? " Only gives the correct result when the versor has a positive squared norm.\n" : "";
+                Comment comment = new Comment(
+                    m_fgs.AddUserComment("Sets " + DST_NAME + "[i] = " + FAI[0].Name + " * " + SRC_NAME + "[i] * " + ((m_isUnit) ? "reverse" : "inverse") + "(" + FAI[0].Name + ") for i = 0 ... " + NB_NAME + "-1, using " + m_G25M.m_name + " metric.\n" +
+                    FAI[0].Name + " is converted to a " + omTypeName + " once, which is then applied to each element." + warningComment));
+
+                // setup instructions
+                List<G25.CG.Shared.Instruction> I = new List<G25.CG.Shared.Instruction>();
+                {
+                    int nbTabs = 1;
+                    I.Add(new VerbatimCodeInstruction(nbTabs, omTypeName + " " + OM_NAME + ";"));
+                    I.Add(new VerbatimCodeInstruction(nbTabs, "int i;"));
+
+                    // M = versorToOM(V)
+                    bool omPtr = false;
+                    I.AddRange(VersorToOM.GetSetOMinstructions(m_specification, m_cgd, FT, m_om, m_imageValue, m_n2Value, OM_NAME, omPtr, nbTabs));
+                    I.Add(OMinit.GetValidateGradeInstruction(m_specification, m_om, OM_NAME, omPtr, m_subjectSmv.ToMultivectorValue(), nbTabs));
+
+                    // dst[i] = applyOM(M, src[i])
+                    I.Add(new VerbatimCodeInstruction(nbTabs, "for (i = 0; i < " + NB_NAME + "; i++) {"));
+                    bool mustCast = false;
+                    bool dstPtr = false;
+                    bool declareDst = false;
+                    I.Add(new AssignInstruction(nbTabs + 1, m_returnSmv, FT, mustCast, m_elementValue, DST_NAME + "[i]", dstPtr, declareDst));
+                    I.Add(new VerbatimCodeInstruction(nbTabs, "}"));
+                }
+
+                // write declaration
+                comment.Write(m_cgd.m_declSB, m_specification, 0);
+                m_cgd.m_declSB.AppendLine(funcDecl + ";");
+
+                // write definition (never inline: the loop is potentially large)
+                StringBuilder defSB = m_cgd.m_defSB;
+                defSB.AppendLine(funcDecl + " {");
+                G25.CG.Shared.Instrumentation.WriteInstrumentationCode(defSB, m_specification, m_cgd, CF.OutputName, FT, FAI);
+                foreach (G25.CG.Shared.Instruction instr in I)
+                    instr.Write(defSB, m_specification, m_cgd);
+                defSB.AppendLine("}");
+            }
+        } // end of WriteFunction
+
+        // used for testing:
+        protected Dictionary<string, System.Collections.Hashtable> m_testArgTable = new Dictionary<string, System.Collections.Hashtable>();
+
+        /// <summary>
+        /// This function checks the dependencies for the _testing_ code of this function. If dependencies are
+        /// missing, the function adds the required functions (this is done simply by asking for them . . .).
+        /// </summary>
+        public override void CheckTestingDepencies()
+        {
+            foreach (string floatName in m_fgs.FloatNames)
+            {
+                FloatType FT = m_specification.GetFloatType(floatName);
+
+                string defaultReturnTypeName = null;
+                System.Collections.Hashtable argTable = new System.Collections.Hashtable();
+                VersorToOM.GetRandomVersorTestDependencies(m_specification, m_cgd, FT, m_G25M, m_versorSmv, argTable);
+                argTable["randomSubjectFuncName"] = G25.CG.Shared.Dependencies.GetDependency(m_specification, m_cgd, "random_" + m_subjectSmv.Name, new String[0], defaultReturnTypeName, FT, null);
+                m_testArgTable[FT.type] = argTable;
+            }
+        }
+
+        /// <summary>
+        /// Writes the testing function for 'F' to 'm_defSB'.
+        /// The generated function returns success (1) or failure (0).
+        ///
+        /// The test (<c>testApplyVersorBatch</c> template) checks that each transformed element is equal to the
+        /// element transformed by applying the versor as a general multivector.
+        /// </summary>
+        /// <returns>The list of name name of the int() function which tests the function.</returns>
+        public override List<string> WriteTestFunction()
+        {
+            StringBuilder defSB = (m_specification.m_inlineFunctions) ? m_cgd.m_inlineDefSB : m_cgd.m_defSB;
+
+            List<string> testFuncNames = new List<string>();
+
+            foreach (string floatName in m_fgs.FloatNames)
+            {
+                FloatType FT = m_specification.GetFloatType(floatName);
+
+                string testFuncName = Util.GetTestingFunctionName(m_specification, m_cgd, m_funcName[FT.type]);
+                testFuncNames.Add(testFuncName);
+
+                System.Collections.Hashtable argTable = m_testArgTable[FT.type];
+                argTable["S"] = m_specification;
+                argTable["FT"] = FT;
+                argTable["gmvName"] = FT.GetMangledName(m_specification, m_specification.m_GMV.Name);
+                argTable["versorType"] = m_versorSmv;
+                argTable["versorName"] = FT.GetMangledName(m_specification, m_versorSmv.Name);
+                argTable["subjectName"] = FT.GetMangledName(m_specification, m_subjectSmv.Name);
+                argTable["returnName"] = FT.GetMangledName(m_specification, m_returnSmv.Name);
+                argTable["unit"] = m_isUnit;
+                argTable["testFuncName"] = testFuncName;
+                argTable["targetFuncName"] = m_funcName[FT.type];
+                m_cgd.m_cog.EmitTemplate(defSB, "testApplyVersorBatch", argTable);
+            }
+
+            return testFuncNames;
+        } // end of WriteTestFunction()
+
+    } // end of class ApplyVersorBatch
+} // end of namespace G25.CG.Shared.Func
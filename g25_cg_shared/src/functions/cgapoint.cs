@@ -110,7 +110,6 @@ namespace G25.CG.Shared.Func
         protected RefGA.Multivector m_returnValue; ///< returned value (symbolic multivector)
         protected Dictionary<string, string> m_randomScalarFunc = new Dictionary<string, string>(); ///< = mangled name of random scalar func 
         protected Dictionary<string, string> m_cgaPointFunc = new Dictionary<string, string>(); ///< = mangled name of random scalar func 
-        protected Dictionary<string, string> m_funcName = new Dictionary<string, string>();  ///< generated function name with full mangling, etc
         protected G25.VariableType m_vectorType;
         protected G25.VariableType m_flatPointType;
 
@@ -42,7 +42,6 @@ namespace G25.CG.Shared.Func
         // constants, intermediate results
         protected int NB_ARGS; ///< 1, or dimension of algebra
         protected RefGA.Multivector m_returnValue; ///< returned value (symbolic multivector)
-        protected Dictionary<string, string> m_funcName = new Dictionary<string, string>();  ///< generated function name with full mangling, etc
         protected G25.SMV m_smv1 = null; ///< if function over SMV, type goes here
         protected G25.SMV m_smv2 = null; ///< if function over SMV, type goes here
 
@@ -58,6 +57,30 @@ namespace G25.CG.Shared.Func
             return (F.Name == "cgaPointDistance2");
         }
 
+        /// <summary>
+        /// Returns the symbolic (squared) distance of conformal points <paramref name="A"/> and <paramref name="B"/>.
+        /// The squared distance is <c>-2 A . B</c>; the distance is the square root of its absolute value.
+        /// </summary>
+        /// <param name="G25M">The metric (the value is rounded when the metric requires it).</param>
+        /// <param name="A">Symbolic value of the first point.</param>
+        /// <param name="B">Symbolic value of the second point.</param>
+        /// <param name="squared">When true, the squared distance is returned.</param>
+        public static RefGA.Multivector GetDistanceValue(G25.Metric G25M, RefGA.Multivector A, RefGA.Multivector B, bool squared)
+        {
+            // compute symbolic distance squared value
+            RefGA.Multivector value = RefGA.Multivector.gp(RefGA.Multivector.ScalarProduct(A, B, G25M.m_metric), -2.0);
+
+            // apply sqrt(fabs()) if distance should not be squared:
+            if (!squared)
+                value = RefGA.Symbolic.UnaryScalarOp.Sqrt(RefGA.Symbolic.UnaryScalarOp.Abs(value));
+
+            // round value if required by metric
+            if (G25M.m_round)
+                value = value.Round(1e-14);
+
+            return value;
+        }
+
         /// <summary>
         /// Checks if this FunctionGenerator can implement a certain function.
         /// </summary>
@@ -99,20 +122,8 @@ namespace G25.CG.Shared.Func
             m_smv1 = tmpFAI[0].Type as G25.SMV;
             m_smv2 = tmpFAI[1].Type as G25.SMV;
 
-            { // compute return value
-                // compute symbolic distance squared value
-                m_returnValue = RefGA.Multivector.gp(
-                    RefGA.Multivector.ScalarProduct(tmpFAI[0].MultivectorValue[0], tmpFAI[1].MultivectorValue[0], m_M),
-                    -2.0);
-
-                // apply sqrt(fabs()) if distance should not be squared:
-                if (IsDistance(m_fgs))
-                    m_returnValue = RefGA.Symbolic.UnaryScalarOp.Sqrt(RefGA.Symbolic.UnaryScalarOp.Abs(m_returnValue));
-
-                // round value if required by metric
-                if (m_G25M.m_round)
-                    m_returnValue = m_returnValue.Round(1e-14);
-            }
+            // compute return value
+            m_returnValue = GetDistanceValue(m_G25M, tmpFAI[0].MultivectorValue[0], tmpFAI[1].MultivectorValue[0], IsDistance2(m_fgs));
 
             // get name of return type
             if (m_fgs.m_returnTypeName.Length == 0)
@@ -0,0 +1,261 @@
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+// Copyright 2008-2010, Daniel Fontijne, University of Amsterdam -- fontijne@science.uva.nl
+
+using System;
+using System.Collections.Generic;
+using System.Text;
+
+namespace G25.CG.Shared.Func
+{
+    /// <summary>
+    /// Generates code for computing distances between arrays of (normalized) conformal model points.
+    ///
+    /// The function should be called <c>"cgaPointDistanceMatrix"</c>, <c>"cgaPointDistance2Matrix"</c> or <c>"cgaPointKNearest"</c>.
+    /// Both arguments must be specialized multivectors (typically <c>normalizedPoint</c> or <c>dualSphere</c>).
+    ///
+    /// <c>cgaPointDistanceMatrix</c> and <c>cgaPointDistance2Matrix</c> have the signature
+    /// <c>void f(const A *a, int nbA, const B *b, int nbB, float *D)</c>. They set <c>D[i * nbB + j]</c> to the
+    /// (squared) distance of <c>a[i]</c> and <c>b[j]</c>. The loops are tiled: a tile of <c>b</c> is
+    /// compared to all elements of <c>a</c> before moving on to the next tile, such that the tile stays in the cache.
+    ///
+    /// <c>cgaPointKNearest</c> has the signature
+    /// <c>int f(const Q &amp;q, const P *points, int nb, int k, int *idx, float *dist2)</c>. It finds the (at most)
+    /// <c>k</c> points closest to <c>q</c>, and returns how many were found. On return, <c>idx</c> and <c>dist2</c>
+    /// contain the indices and squared distances of these points, sorted on increasing distance.
+    ///
+    /// All distances are computed from the inner product of the points (see CgaPointDistance.GetDistanceValue()),
+    /// so the points do not have to be converted to Euclidean vectors.
+    ///
+    /// Only implemented for C and C++.
+    ///
+    /// Some examples of XML to request the functions:
+    /// <code>
+    /// <function name="cgaPointDistanceMatrix" arg1="normalizedPoint" arg2="normalizedPoint" floatType="float"/>
+    /// <function name="cgaPointDistance2Matrix" arg1="normalizedPoint" arg2="dualSphere" floatType="double"/>
+    /// <function name="cgaPointKNearest" arg1="normalizedPoint" arg2="normalizedPoint" floatType="float"/>
+    /// </code>
+    /// </summary>
+    public class CgaPointDistanceBatch : G25.CG.Shared.BaseFunctionGenerator
+    {
+        protected const int NB_ARGS = 2;
+
+        /// <summary>Number of elements of the second array which are compared to the first array in one go.</summary>
+        public const int TILE_SIZE = 256;
+
+        protected const string A_NAME = "a";
+        protected const string NB_A_NAME = "nbA";
+        protected const string B_NAME = "b";
+        protected const string NB_B_NAME = "nbB";
+        protected const string D_NAME = "D";
+        protected const string POINTS_NAME = "points";
+        protected const string NB_NAME = "nb";
+        protected const string K_NAME = "k";
+        protected const string IDX_NAME = "idx";
+        protected const string DIST2_NAME = "dist2";
+
+        protected G25.SMV m_smv1 = null; ///< type of the first argument
+        protected G25.SMV m_smv2 = null; ///< type of the second argument
+
+        /// <returns>true when F.Name == "cgaPointDistanceMatrix".</returns>
+        public static bool IsDistanceMatrix(G25.fgs F)
+        {
+            return (F.Name == "cgaPointDistanceMatrix");
+        }
+
+        /// <returns>true when F.Name == "cgaPointDistance2Matrix".</returns>
+        public static bool IsDistance2Matrix(G25.fgs F)
+        {
+            return (F.Name == "cgaPointDistance2Matrix");
+        }
+
+        /// <returns>true when F.Name == "cgaPointKNearest".</returns>
+        public static bool IsKNearest(G25.fgs F)
+        {
+            return (F.Name == "cgaPointKNearest");
+        }
+
+        /// <summary>
+        /// Checks if this FunctionGenerator can implement a certain function.
+        /// </summary>
+        /// <param name="S">The specification of the algebra.</param>
+        /// <param name="F">The function to be implemented.</param>
+        /// <returns>true if 'F' can be implemented.</returns>
+        public override bool CanImplement(Specification S, G25.fgs F)
+        {
+            return (IsDistanceMatrix(F) || IsDistance2Matrix(F) || IsKNearest(F)) &&
+                S.OutputCppOrC() &&
+                (F.m_argumentTypeNames.Length == NB_ARGS) && // all arguments must be explicitly listed
+                G25.CG.Shared.Functions.IsSmv(S, F, 0) &&
+                G25.CG.Shared.Functions.IsSmv(S, F, 1);
+        }
+
+        /// <summary>
+        /// If this FunctionGenerator can implement 'F', then this function should complete the (possible)
+        /// blanks in 'F'. This means:
+        ///  - Fill in F.m_returnTypeName if it is empty
+        ///  - Fill in F.m_argumentTypeNames (and m_argumentVariableNames) if it is empty.
+        /// </summary>
+        public override void CompleteFGS()
+        {
+            // init argument pointers from the completed typenames (language sensitive);
+            m_fgs.InitArgumentPtrFromTypeNames(m_specification);
+
+            // get all function info
+            FloatType FT = m_specification.GetFloatType(m_fgs.FloatNames[0]);
+            bool computeMultivectorValue = false;
+            G25.CG.Shared.FuncArgInfo[] tmpFAI = G25.CG.Shared.FuncArgInfo.GetAllFuncArgInfo(m_specification, m_fgs, NB_ARGS, FT, m_specification.m_GMV.Name, computeMultivectorValue);
+
+            m_smv1 = (G25.SMV)tmpFAI[0].Type;
+            m_smv2 = (G25.SMV)tmpFAI[1].Type;
+
+            // the matrix functions write floats, cgaPointKNearest returns the number of points found
+            if (IsKNearest(m_fgs)) m_fgs.ReturnTypeName = IntegerType.INTEGER;
+            else if (m_fgs.m_returnTypeName.Length == 0)
+                m_fgs.m_returnTypeName = FT.type;
+        }
+
+        /// <summary>
+        /// The array arguments cannot be generated randomly, so no benchmark is generated.
+        /// </summary>
+        public override void CheckBenchmarkDepencies()
+        {
+        }
+
+        /// <summary>
+        /// Returns the instructions of <c>cgaPointDistanceMatrix</c> and <c>cgaPointDistance2Matrix</c>.
+        /// </summary>
+        protected List<G25.CG.Shared.Instruction> GetDistanceMatrixInstructions(FloatType FT)
+        {
+            List<G25.CG.Shared.Instruction> I = new List<G25.CG.Shared.Instruction>();
+            int nbTabs = 1;
+            bool ptr = false;
+            RefGA.Multivector aValue = G25.CG.Shared.Symbolic.SMVtoSymbolicMultivector(m_specification, m_smv1, A_NAME + "[i]", ptr);
+            RefGA.Multivector bValue = G25.CG.Shared.Symbolic.SMVtoSymbolicMultivector(m_specification, m_smv2, B_NAME + "[j]", ptr);
+            RefGA.Multivector distValue = CgaPointDistance.GetDistanceValue(m_G25M, aValue, bValue, IsDistance2Matrix(m_fgs));
+
+            I.Add(new VerbatimCodeInstruction(nbTabs, FT.type + " *row;"));
+            I.Add(new VerbatimCodeInstruction(nbTabs, "int i, j, j0, j1;"));
+            I.Add(new CommentInstruction(nbTabs, "compare one tile of " + B_NAME + " to all of " + A_NAME + ", such that the tile stays in the cache"));
+            I.Add(new VerbatimCodeInstruction(nbTabs, "for (j0 = 0; j0 < " + NB_B_NAME + "; j0 += " + TILE_SIZE + ") {"));
+            I.Add(new VerbatimCodeInstruction(nbTabs + 1, "j1 = (j0 + " + TILE_SIZE + " < " + NB_B_NAME + ") ? (j0 + " + TILE_SIZE + ") : " + NB_B_NAME + ";"));
+            I.Add(new VerbatimCodeInstruction(nbTabs + 1, "for (i = 0; i < " + NB_A_NAME + "; i++) {"));
+            I.Add(new CommentInstruction(nbTabs + 2, "compute the offset in size_t, such that nbA * nbB may exceed the range of int"));
+            I.Add(new VerbatimCodeInstruction(nbTabs + 2, "row = " + D_NAME + " + (size_t)i * (size_t)" + NB_B_NAME + ";"));
+            I.Add(new VerbatimCodeInstruction(nbTabs + 2, "for (j = j0; j < j1; j++) {"));
+            bool mustCast = false;
+            bool declareDst = false;
+            I.Add(new AssignInstruction(nbTabs + 3, FT, FT, mustCast, distValue, "row[j]", ptr, declareDst));
+            I.Add(new VerbatimCodeInstruction(nbTabs + 2, "}"));
+            I.Add(new VerbatimCodeInstruction(nbTabs + 1, "}"));
+            I.Add(new VerbatimCodeInstruction(nbTabs, "}"));
+            return I;
+        }
+
+        /// <summary>
+        /// Returns the instructions of <c>cgaPointKNearest</c>.
+        ///
+        /// The <c>k</c> nearest points found so far are kept sorted in <c>idx</c> and <c>dist2</c>;
+        /// each point which is closer than the last of them is inserted (insertion sort).
+        /// </summary>
+        protected List<G25.CG.Shared.Instruction> GetKNearestInstructions(FloatType FT, G25.CG.Shared.FuncArgInfo[] FAI)
+        {
+            List<G25.CG.Shared.Instruction> I = new List<G25.CG.Shared.Instruction>();
+            int nbTabs = 1;
+            bool ptr = false;
+            RefGA.Multivector qValue = G25.CG.Shared.Symbolic.SMVtoSymbolicMultivector(m_specification, m_smv1, FAI[0].Name, FAI[0].Pointer);
+            RefGA.Multivector pValue = G25.CG.Shared.Symbolic.SMVtoSymbolicMultivector(m_specification, m_smv2, POINTS_NAME + "[i]", ptr);
+            bool squared = true;
+            RefGA.Multivector dist2Value = CgaPointDistance.GetDistanceValue(m_G25M, qValue, pValue, squared);
+
+            I.Add(new VerbatimCodeInstruction(nbTabs, FT.type + " d;"));
+            I.Add(new VerbatimCodeInstruction(nbTabs, "int i, j, n = 0;"));
+            I.Add(new VerbatimCodeInstruction(nbTabs, "if (" + K_NAME + " <= 0) return 0;"));
+            I.Add(new VerbatimCodeInstruction(nbTabs, "for (i = 0; i < " + NB_NAME + "; i++) {"));
+            bool mustCast = false;
+            bool declareDst = false;
+            I.Add(new AssignInstruction(nbTabs + 1, FT, FT, mustCast, dist2Value, "d", ptr, declareDst));
+            I.Add(new VerbatimCodeInstruction(nbTabs + 1, "if ((n == " + K_NAME + ") && (d >= " + DIST2_NAME + "[n - 1])) continue;"));
+            I.Add(new VerbatimCodeInstruction(nbTabs + 1, "if (n < " + K_NAME + ") n++;"));
+            I.Add(new CommentInstruction(nbTabs + 1, "insert point i, dropping the farthest point when the list is full"));
+            I.Add(new VerbatimCodeInstruction(nbTabs + 1, "for (j = n - 1; (j > 0) && (" + DIST2_NAME + "[j - 1] > d); j--) {"));
+            I.Add(new VerbatimCodeInstruction(nbTabs + 2, DIST2_NAME + "[j] = " + DIST2_NAME + "[j - 1];"));
+            I.Add(new VerbatimCodeInstruction(nbTabs + 2, IDX_NAME + "[j] = " + IDX_NAME + "[j - 1];"));
+            I.Add(new VerbatimCodeInstruction(nbTabs + 1, "}"));
+            I.Add(new VerbatimCodeInstruction(nbTabs + 1, DIST2_NAME + "[j] = d;"));
+            I.Add(new VerbatimCodeInstruction(nbTabs + 1, IDX_NAME + "[j] = i;"));
+            I.Add(new VerbatimCodeInstruction(nbTabs, "}"));
+            I.Add(new VerbatimCodeInstruction(nbTabs, "return n;"));
+            return I;
+        }
+
+        /// <summary>
+        /// Writes the declaration/definitions of 'F' to StringBuffer 'SB', taking into account parameters specified in specification 'S'.
+        /// </summary>
+        public override void WriteFunction()
+        {
+            foreach (string floatName in m_fgs.FloatNames)
+            {
+                FloatType FT = m_specification.GetFloatType(floatName);
+
+                bool computeMultivectorValue = false;
+                G25.CG.Shared.FuncArgInfo[] FAI = G25.CG.Shared.FuncArgInfo.GetAllFuncArgInfo(m_specification, m_fgs, NB_ARGS, FT, m_specification.m_GMV.Name, computeMultivectorValue);
+
+                // because of lack of overloading, function names include names of argument types
+                G25.fgs CF = G25.CG.Shared.Util.AppendTypenameToFuncName(m_specification, FT, m_fgs, FAI);
+                m_funcName[FT.type] = CF.OutputName;
+
+                string type1Name = FT.GetMangledName(m_specification, m_smv1.Name);
+                string type2Name = FT.GetMangledName(m_specification, m_smv2.Name);
+
+                string funcDecl;
+                Comment comment;
+                List<G25.CG.Shared.Instruction> I;
+                if (IsKNearest(m_fgs))
+                {
+                    string queryRefStr = (m_specification.OutputC()) ? "*" : "&";
+                    funcDecl = "int " + CF.OutputName + "(const " + type1Name + " " + queryRefStr + FAI[0].Name + ", " +
+                        "const " + type2Name + " *" + POINTS_NAME + ", int " + NB_NAME + ", int " + K_NAME + ", int *" + IDX_NAME + ", " + FT.type + " *" + DIST2_NAME + ")";
+                    comment = new Comment(m_fgs.AddUserComment("Finds the (at most) " + K_NAME + " points of " + POINTS_NAME + "[0] ... " + POINTS_NAME + "[" + NB_NAME + "-1] which are closest to " + FAI[0].Name + ".\n" +
+                        "On return, " + IDX_NAME + "[0 ... n-1] and " + DIST2_NAME + "[0 ... n-1] contain their indices and squared distances, sorted on increasing distance.\n" +
+                        IDX_NAME + " and " + DIST2_NAME + " must have room for " + K_NAME + " elements.")).SetReturnComment("the number of points found (n = min(" + K_NAME + ", " + NB_NAME + ")).");
+                    I = GetKNearestInstructions(FT, FAI);
+                }
+                else
+                {
+                    funcDecl = "void " + CF.OutputName + "(const " + type1Name + " *" + A_NAME + ", int " + NB_A_NAME + ", " +
+                        "const " + type2Name + " *" + B_NAME + ", int " + NB_B_NAME + ", " + FT.type + " *" + D_NAME + ")";
+                    comment = new Comment(m_fgs.AddUserComment("Sets " + D_NAME + "[i * " + NB_B_NAME + " + j] to the distance" + ((IsDistance2Matrix(m_fgs)) ? " squared" : "") + " of conformal points " +
+                        A_NAME + "[i] and " + B_NAME + "[j], for i = 0 ... " + NB_A_NAME + "-1 and j = 0 ... " + NB_B_NAME + "-1.\n" +
+                        D_NAME + " must have room for " + NB_A_NAME + " * " + NB_B_NAME + " elements."));
+                    I = GetDistanceMatrixInstructions(FT);
+                }
+
+                // write declaration
+                comment.Write(m_cgd.m_declSB, m_specification, 0);
+                m_cgd.m_declSB.AppendLine(funcDecl + ";");
+
+                // write definition (never inline: the loops are potentially large)
+                StringBuilder defSB = m_cgd.m_defSB;
+                defSB.AppendLine(funcDecl + " {");
+                G25.CG.Shared.Instrumentation.WriteInstrumentationCode(defSB, m_specification, m_cgd, CF.OutputName, FT, FAI);
+                foreach (G25.CG.Shared.Instruction instr in I)
+                    instr.Write(defSB, m_specification, m_cgd);
+                defSB.AppendLine("}");
+            }
+        } // end of WriteFunction
+
+    } // end of class CgaPointDistanceBatch
+} // end of namespace G25.CG.Shared.Func
@@ -0,0 +1,253 @@
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+// Copyright 2008-2010, Daniel Fontijne, University of Amsterdam -- fontijne@science.uva.nl
+
+using System;
+using System.Collections.Generic;
+using System.Text;
+
+namespace G25.CG.Shared.Func
+{
+    /// <summary>
+    /// Generates code for composing two general outermorphisms.
+    ///
+    /// The function should be called <c>"composeOM"</c>. Both arguments must be the general outermorphism
+    /// (when no arguments are specified, the general outermorphism is used). The return type is the general outermorphism.
+    /// <c>composeOM(A, B)</c> returns the outermorphism which applies <c>B</c> first, and then <c>A</c>.
+    ///
+    /// Each grade matrix of the result is the product of the grade matrices of <c>A</c> and <c>B</c> (each column of
+    /// the result is <c>A</c> applied to a column of <c>B</c>, see ApplyOM.GetApplyOMvalue()), so the result
+    /// does not have to be set from the images of the domain vectors. When the general outermorphism is lazy
+    /// (see G25.OM.SetLazy()), only the grade 1 matrix is computed; the higher grade matrices are computed on first use.
+    /// In the aligned layout (see G25.OM.SetAlignedLayout()), the padding of all grade matrices of the result is cleared.
+    ///
+    /// Only implemented for C and C++.
+    /// </summary>
+    public class ComposeOM : G25.CG.Shared.BaseFunctionGenerator
+    {
+        protected const int NB_ARGS = 2;
+
+        /// <returns>true when argument <paramref name="argIdx"/> of <paramref name="F"/> is the general outermorphism.</returns>
+        protected static bool IsGom(Specification S, G25.fgs F, int argIdx)
+        {
+            return G25.CG.Shared.Functions.IsOm(S, F, argIdx) && (!G25.CG.Shared.Functions.IsSom(S, F, argIdx));
+        }
+
+        /// <summary>
+        /// Checks if this FunctionGenerator can implement a certain function.
+        /// </summary>
+        /// <param name="S">The specification of the algebra.</param>
+        /// <param name="F">The function to be implemented.</param>
+        /// <returns>true if 'F' can be implemented</returns>
+        public override bool CanImplement(Specification S, G25.fgs F)
+        {
+            return (F.Name == "composeOM") &&
+                S.OutputCppOrC() &&
+                (S.m_GOM != null) &&
+                F.MatchNbArguments(NB_ARGS) &&
+                ((F.NbArguments == 0) || (IsGom(S, F, 0) && IsGom(S, F, 1))); // both arguments must be general outermorphisms
+        }
+
+        /// <summary>
+        /// If this FunctionGenerator can implement 'F', then this function should complete the (possible)
+        /// blanks in 'F'. This means:
+        ///  - Fill in F.m_returnTypeName if it is empty
+        ///  - Fill in F.m_argumentTypeNames (and m_argumentVariableNames) if it is empty.
+        /// </summary>
+        public override void CompleteFGS()
+        {
+            // fill in ArgumentTypeNames
+            if (m_fgs.ArgumentTypeNames.Length == 0)
+            {
+                m_fgs.m_argumentTypeNames = new String[] { m_specification.m_GOM.Name, m_specification.m_GOM.Name };
+                m_fgs.m_argumentVariableNames = new String[] { G25.fgs.DefaultArgumentName(0), G25.fgs.DefaultArgumentName(1) };
+            }
+
+            // init argument pointers from the completed typenames (language sensitive);
+            m_fgs.InitArgumentPtrFromTypeNames(m_specification);
+
+            // return type
+            if (m_fgs.m_returnTypeName.Length == 0)
+                m_fgs.m_returnTypeName = m_specification.m_GOM.Name;
+            else if (m_fgs.m_returnTypeName != m_specification.m_GOM.Name)
+                throw new G25.UserException("The return type of " + m_fgs.Name + " must be the general outermorphism.");
+        }
+
+        /// <summary>
+        /// Returns instructions which set general outermorphism <paramref name="dstName"/> to the composition of
+        /// <paramref name="FAI"/>[0] and <paramref name="FAI"/>[1] (the latter is applied first).
+        /// </summary>
+        /// <param name="S">Specification of algebra.</param>
+        /// <param name="FT">Floating point type.</param>
+        /// <param name="FAI">The two outermorphism arguments.</param>
+        /// <param name="dstName">Name of the outermorphism variable where the result goes.</param>
+        /// <param name="dstPtr">Whether the result variable is a pointer.</param>
+        /// <param name="nbTabs">How many tabs to put in front of the code.</param>
+        public static List<Instruction> GetComposeInstructions(Specification S, G25.FloatType FT, G25.CG.Shared.FuncArgInfo[] FAI, string dstName, bool dstPtr, int nbTabs)
+        {
+            List<Instruction> I = new List<Instruction>();
+            G25.GOM gom = S.m_GOM;
+            bool mustCast = false;
+            bool declareDst = false;
+
+            // the padding of the aligned layout is not written by the assignments below (see OMinit.WriteSetVectorImages())
+            if (gom.AlignedLayout)
+            {
+                string matrixStr = dstName + ((dstPtr) ? "->" : ".") + ((S.OutputC()) ? "m" : "m_m");
+                string padCode = OMinit.GetClearPaddingCode(S, FT, gom, matrixStr);
+                if (padCode.Length > 0)
+                {
+                    I.Add(new CommentInstruction(nbTabs, "Clear padding of aligned matrices"));
+                    I.Add(new VerbatimCodeInstruction(nbTabs, padCode));
+                }
+            }
+
+            // a lazy result only needs the grade 1 matrix (the higher grades follow from it)
+            int maxGrade = (gom.Lazy) ? 1 : gom.Domain.Length - 1;
+            for (int g = 1; g <= maxGrade; g++)
+            {
+                for (int d = 0; d < gom.DomainForGrade(g).Length; d++)
+                {
+                    G25.SMVOM smvOM = gom.DomainSmvForGrade(g)[d];
+
+                    // column 'd' of the result is A applied to column 'd' of B
+                    RefGA.Multivector columnValueB = G25.CG.Shared.Symbolic.SMVtoSymbolicMultivector(S, smvOM, FAI[1].Name, FAI[1].Pointer);
+                    RefGA.Multivector columnValue = ApplyOM.GetApplyOMvalue(S, gom, FAI[0].Name, FAI[0].Pointer, columnValueB);
+
+                    I.Add(new CommentInstruction(nbTabs, "Set image of " + gom.DomainForGrade(g)[d].ToString(S.m_basisVectorNames)));
+                    I.Add(new AssignInstruction(nbTabs, smvOM, FT, mustCast, columnValue, dstName, dstPtr, declareDst));
+                }
+            }
+
+            if (gom.Lazy)
+                I.Add(new VerbatimCodeInstruction(nbTabs, dstName + ((dstPtr) ? "->" : ".") + OMinit.VALID_GRADES_NAME + " = " + OMinit.GetVectorGradeValidBitmap() + ";"));
+
+            return I;
+        }
+
+        /// <summary>
+        /// The outermorphism arguments cannot be generated randomly, so no benchmark is generated.
+        /// </summary>
+        public override void CheckBenchmarkDepencies()
+        {
+        }
+
+        /// <summary>
+        /// Writes the declaration/definitions of 'F' to StringBuffer 'SB', taking into account parameters specified in specification 'S'.
+        /// </summary>
+        public override void WriteFunction()
+        {
+            foreach (string floatName in m_fgs.FloatNames)
+            {
+                FloatType FT = m_specification.GetFloatType(floatName);
+
+                bool computeMultivectorValue = false;
+                G25.CG.Shared.FuncArgInfo[] FAI = G25.CG.Shared.FuncArgInfo.GetAllFuncArgInfo(m_specification, m_fgs, NB_ARGS, FT, m_specification.m_GMV.Name, computeMultivectorValue);
+
+                // generate comment
+                string aliasComment = (m_specification.OutputC()) ? "\nThe result must not be stored in " + FAI[0].Name + " or " + FAI[1].Name + "." : "";
+                Comment comment = new Comment(
+                    m_fgs.AddUserComment("Returns the composition of " + FAI[0].Name + " and " + FAI[1].Name + ": the outermorphism which applies " + FAI[1].Name + " first and then " + FAI[0].Name + "." + aliasComment));
+
+                // because of lack of overloading, function names include names of argument types
+                G25.fgs CF = G25.CG.Shared.Util.AppendTypenameToFuncName(m_specification, FT, m_fgs, FAI);
+                m_funcName[FT.type] = CF.OutputName;
+
+                string omTypeName = FT.GetMangledName(m_specification, m_specification.m_GOM.Name);
+                string dstName = G25.fgs.RETURN_ARG_NAME;
+                bool dstPtr = m_specification.OutputC();
+                int nbTabs = 1;
+
+                // setup instructions
+                List<G25.CG.Shared.Instruction> I = new List<G25.CG.Shared.Instruction>();
+                if (!dstPtr) I.Add(new VerbatimCodeInstruction(nbTabs, omTypeName + " " + dstName + ";"));
+                I.AddRange(GetComposeInstructions(m_specification, FT, FAI, dstName, dstPtr, nbTabs));
+
+                G25.CG.Shared.FuncArgInfo returnArgument = null;
+                if (m_specification.OutputC())
+                    returnArgument = new G25.CG.Shared.FuncArgInfo(m_specification, CF, -1, FT, m_specification.m_GOM.Name, computeMultivectorValue);
+                else I.Add(new VerbatimCodeInstruction(nbTabs, "return " + dstName + ";"));
+
+                bool inline = false; // the function is potentially large
+                bool staticFunc = Functions.OutputStaticFunctions(m_specification);
+                G25.CG.Shared.Functions.WriteFunction(m_specification, m_cgd, CF, inline, staticFunc, omTypeName, CF.OutputName, returnArgument, FAI, I, comment);
+            }
+        } // end of WriteFunction
+
+        // used for testing:
+        protected Dictionary<string, string> m_randomScalarFuncName = new Dictionary<string, string>();
+        protected Dictionary<string, string> m_randomBladeFuncName = new Dictionary<string, string>();
+        protected Dictionary<string, string> m_subtractGmvFuncName = new Dictionary<string, string>();
+        protected Dictionary<string, string> m_applyOMgmvFuncName = new Dictionary<string, string>();
+
+        /// <summary>
+        /// This function checks the dependencies for the _testing_ code of this function. If dependencies are
+        /// missing, the function adds the required functions (this is done simply by asking for them . . .).
+        /// </summary>
+        public override void CheckTestingDepencies()
+        {
+            foreach (string floatName in m_fgs.FloatNames)
+            {
+                FloatType FT = m_specification.GetFloatType(floatName);
+
+                string gmvName = m_specification.m_GMV.Name;
+                m_randomScalarFuncName[FT.type] = G25.CG.Shared.Dependencies.GetDependency(m_specification, m_cgd, "random_" + FT.type, new String[0], FT.type, FT, null);
+                m_randomBladeFuncName[FT.type] = G25.CG.Shared.Dependencies.GetDependency(m_specification, m_cgd, "random_blade", new String[0], gmvName, FT, null);
+                m_subtractGmvFuncName[FT.type] = G25.CG.Shared.Dependencies.GetDependency(m_specification, m_cgd, "subtract", new String[] { gmvName, gmvName }, gmvName, FT, null);
+                m_applyOMgmvFuncName[FT.type] = G25.CG.Shared.Dependencies.GetDependency(m_specification, m_cgd, "applyOM", new String[] { m_specification.m_GOM.Name, gmvName }, gmvName, FT, null);
+            }
+        }
+
+        /// <summary>
+        /// Writes the testing function for 'F' to 'm_defSB'.
+        /// The generated function returns success (1) or failure (0).
+        ///
+        /// The test (<c>testComposeOM</c> template) checks that applying the composition of two random outermorphisms
+        /// to random blades is equal to applying them one after the other.
+        /// </summary>
+        /// <returns>The list of name name of the int() function which tests the function.</returns>
+        public override List<string> WriteTestFunction()
+        {
+            StringBuilder defSB = (m_specification.m_inlineFunctions) ? m_cgd.m_inlineDefSB : m_cgd.m_defSB;
+
+            List<string> testFuncNames = new List<string>();
+
+            foreach (string floatName in m_fgs.FloatNames)
+            {
+                FloatType FT = m_specification.GetFloatType(floatName);
+
+                string testFuncName = Util.GetTestingFunctionName(m_specification, m_cgd, m_funcName[FT.type]);
+                testFuncNames.Add(testFuncName);
+
+                System.Collections.Hashtable argTable = new System.Collections.Hashtable();
+                argTable["S"] = m_specification;
+                argTable["FT"] = FT;
+                argTable["gmv"] = m_specification.m_GMV;
+                argTable["gmvName"] = FT.GetMangledName(m_specification, m_specification.m_GMV.Name);
+                argTable["gomName"] = FT.GetMangledName(m_specification, m_specification.m_GOM.Name);
+                argTable["testFuncName"] = testFuncName;
+                argTable["targetFuncName"] = m_funcName[FT.type];
+                argTable["randomScalarFuncName"] = m_randomScalarFuncName[FT.type];
+                argTable["randomBladeFuncName"] = m_randomBladeFuncName[FT.type];
+                argTable["subtractGmvFuncName"] = m_subtractGmvFuncName[FT.type];
+                argTable["applyOMgmvFuncName"] = m_applyOMgmvFuncName[FT.type];
+                m_cgd.m_cog.EmitTemplate(defSB, "testComposeOM", argTable);
+            }
+
+            return testFuncNames;
+        } // end of WriteTestFunction()
+
+    } // end of class ComposeOM
+} // end of namespace G25.CG.Shared.Func
@@ -47,7 +47,6 @@ namespace G25.CG.Shared.Func
         protected bool m_gmvFunc; ///< is this a function over GMVs?
         protected RefGA.Multivector m_returnValue; ///< returned value (symbolic multivector)
         protected G25.SMV m_smv = null; ///< if function over SMV, type goes here
-        protected Dictionary<string, string> m_funcName = new Dictionary<string, string>();  ///< generated function name with full mangling, etc
 
         /// <summary>
         /// Checks if this FunctionGenerator can implement a certain function.
@@ -52,7 +52,6 @@ namespace G25.CG.Shared.Func
         protected int m_gradeIdx; ///< requested grade (-1 for specify-at-runtime)
 
         protected G25.SMV m_smv = null; ///< if function over SMV, type goes here
-        protected Dictionary<string, string> m_funcName = new Dictionary<string, string>();  ///< generated function name with full mangling, etc
 
         /// <summary>
         /// Checks if this FunctionGenerator can implement a certain function.
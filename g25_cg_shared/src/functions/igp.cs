@@ -42,7 +42,6 @@ namespace G25.CG.Shared.Func
         protected String m_normSquaredName = "_n2_";
         protected G25.SMV m_smv1 = null; ///< if function over SMV, type goes here
         protected G25.SMV m_smv2 = null; ///< if function over SMV, type goes here
-        protected Dictionary<string, string> m_funcName = new Dictionary<string, string>();  ///< generated function name with full mangling, etc
 
         /// <summary>
         /// Checks if this FunctionGenerator can implement a certain function.
@@ -92,12 +91,12 @@ namespace G25.CG.Shared.Func
             {
                 // compute return value
                 m_reverseValue = RefGA.Multivector.Reverse(tmpFAI[1].MultivectorValue[0]);
-                m_n2Value = RefGA.Multivector.gp(m_reverseValue, tmpFAI[1].MultivectorValue[0], m_M);
+                m_n2Value = G25.CG.Shared.ProductCache.gp(m_reverseValue, tmpFAI[1].MultivectorValue[0], m_M);
                 if (m_G25M.m_round) m_n2Value = m_n2Value.Round(1e-14);
 
                 //m_returnValue = RefGA.Multivector.gp(RefGA.Multivector.gp(tmpFAI[0].MultivectorValue[0], m_reverseValue, m_M),
                   //  RefGA.Symbolic.ScalarOp.Inverse(new RefGA.Multivector(new RefGA.BasisBlade(0, 1.0, m_normSquaredName))));
-                m_returnValue = RefGA.Multivector.gp(tmpFAI[0].MultivectorValue[0], m_reverseValue, m_M);
+                m_returnValue = G25.CG.Shared.ProductCache.gp(tmpFAI[0].MultivectorValue[0], m_reverseValue, m_M);
 
                 // round value if required by metric
                 if (m_G25M.m_round) m_returnValue = m_returnValue.Round(1e-14);
@@ -100,7 +100,6 @@ namespace G25.CG.Shared.Func
         RefGA.BasisBlade.InnerProductType m_ipType; ///< type of inner product (left, right, Hestenes, etc)
         protected G25.SMV m_smv1 = null; ///< if function over SMV, type goes here
         protected G25.SMV m_smv2 = null; ///< if function over SMV, type goes here
-        protected Dictionary<string, string> m_funcName = new Dictionary<string, string>();  ///< generated function name with full mangling, etc
 
         /// <summary>
         /// Checks if this FunctionGenerator can implement a certain function.
@@ -155,7 +154,7 @@ namespace G25.CG.Shared.Func
             else
             {
                 // compute return value
-                m_returnValue = RefGA.Multivector.ip(tmpFAI[0].MultivectorValue[0], tmpFAI[1].MultivectorValue[0], m_M, m_ipType);
+                m_returnValue = G25.CG.Shared.ProductCache.ip(tmpFAI[0].MultivectorValue[0], tmpFAI[1].MultivectorValue[0], m_M, m_ipType);
 
                 // round value if required by metric
                 if (m_G25M.m_round) m_returnValue = m_returnValue.Round(1e-14);
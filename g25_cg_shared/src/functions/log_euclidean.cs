@@ -37,7 +37,6 @@ namespace G25.CG.Shared.Func
         protected RefGA.Multivector m_mulValue;
         protected RefGA.Multivector m_returnValue; ///< returned value (symbolic multivector)
         protected G25.SMV m_smv = null; ///< if function over SMV, type goes here
-        protected Dictionary<string, string> m_funcName = new Dictionary<string, string>();  ///< generated function name with full mangling, etc
         protected G25.VariableType m_returnType; ///< return type
 
         protected Dictionary<string, string> m_norm2Func = new Dictionary<string, string>(); ///< = mangled name of norm2 func
@@ -97,7 +96,7 @@ namespace G25.CG.Shared.Func
                 m_grade0Value = tmpFAI[0].MultivectorValue[0].ExtractGrade(0);
                 m_grade2Value = tmpFAI[0].MultivectorValue[0].ExtractGrade(2);
                 RefGA.Multivector reverseGrade2Value = RefGA.Multivector.Reverse(m_grade2Value);
-                m_grade2norm2Value = RefGA.Multivector.gp(reverseGrade2Value, m_grade2Value, m_M);
+                m_grade2norm2Value = G25.CG.Shared.ProductCache.gp(reverseGrade2Value, m_grade2Value, m_M);
 
                 m_returnValue = RefGA.Multivector.gp(m_grade2Value, new RefGA.Multivector(mulName)); // where mulName = atan2(sqrt(grade2norm2), grade0) / sqrt(grade2norm2)
 
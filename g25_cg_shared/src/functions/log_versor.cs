@@ -0,0 +1,411 @@
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+// Copyright 2008-2010, Daniel Fontijne, University of Amsterdam -- fontijne@science.uva.nl
+
+using System;
+using System.Collections.Generic;
+using System.Text;
+
+namespace G25.CG.Shared.Func
+{
+    /// <summary>
+    /// Generates closed form code for the log of rigid body motors and of n-D Euclidean rotors.
+    ///
+    /// The function name should be <c>"log"</c> with <c>optionType="motor"</c> or <c>optionType="rotor"</c>.
+    /// The argument must be a specialized multivector with only grade 0, 2 and 4 coordinates.
+    /// The return type is the bivector B such that exp(B) equals the argument.
+    ///
+    /// For <c>optionType="rotor"</c>, the basis vectors of the rotor must be Euclidean (e.g., e1, e2, e3 of the conformal model). The rotor R = exp(B1) exp(B2) is split into
+    /// two commuting rotations in orthogonal planes, and the angle of each rotation is computed using atan2().
+    /// This covers all rotors of algebras up to dimension 5. When the type has no grade 4 coordinates, the familiar
+    /// (simple) rotor log is generated.
+    ///
+    /// For <c>optionType="motor"</c>, the argument must be a rigid body motor M = exp(B1) exp(B2) where B1 is a rotation
+    /// (B1 B1 &lt;= 0) and B2 is a translation along the rotation axis (B2 B2 = 0), such as the motors of the conformal model.
+    ///
+    /// Unlike the <c>optionType="euclidean"</c> log (see LogEuclidean), these functions are not available for the general multivector.
+    /// </summary>
+    public class LogVersor : G25.CG.Shared.BaseFunctionGenerator
+    {
+        protected const int NB_ARGS = 1;
+        protected bool m_motor; ///< optionType="motor" or optionType="rotor"?
+        protected G25.SMV m_smv = null; ///< type of argument
+        protected G25.VariableType m_returnType; ///< return type
+        protected RefGA.Multivector m_grade0Value;
+        protected RefGA.Multivector m_grade2Value;
+        protected RefGA.Multivector m_grade4Value;
+        protected RefGA.Multivector m_grade2grade4Value; ///< grade 2 part of m_grade2Value * m_grade4Value
+        protected RefGA.Multivector m_returnValue; ///< returned value (symbolic multivector)
+        protected RefGA.Multivector m_arbitraryPlaneValue; ///< log of -1: 360 degree rotation in arbitrary Euclidean plane
+
+        protected const string scalarPartName = "_c_";
+        protected const string mulName = "_mul_";
+        protected const string kName = "_k_";
+
+        /// <returns>The value of the <c>type</c> option of <paramref name="F"/>, in lower case, or null when not set.</returns>
+        protected static string GetTypeOption(G25.fgs F)
+        {
+            string type = F.GetOption("type");
+            return (type == null) ? null : type.ToLower();
+        }
+
+        /// <summary>
+        /// Checks if this FunctionGenerator can implement a certain function.
+        /// </summary>
+        /// <param name="S">The specification of the algebra.</param>
+        /// <param name="F">The function to be implemented.</param>
+        /// <returns>true if 'F' can be implemented</returns>
+        public override bool CanImplement(Specification S, G25.fgs F)
+        {
+            if (!((F.Name == "log") && (F.MatchNbArguments(1)))) return false;
+
+            string type = GetTypeOption(F);
+            return (type == "motor") || (type == "rotor");
+        }
+
+        /// <summary>
+        /// If this FunctionGenerator can implement 'F', then this function should complete the (possible)
+        /// blanks in 'F'. This means:
+        ///  - Fill in F.m_returnTypeName if it is empty
+        ///  - Fill in F.m_argumentTypeNames (and m_argumentVariableNames) if it is empty.
+        /// </summary>
+        public override void CompleteFGS()
+        {
+            m_motor = (GetTypeOption(m_fgs) == "motor");
+
+            // fill in ArgumentTypeNames
+            if (m_fgs.ArgumentTypeNames.Length == 0)
+                throw new G25.UserException("The argument of " + m_fgs.Name + " with optionType=\"" + GetTypeOption(m_fgs) + "\" must be specified.");
+
+            // init argument pointers from the completed typenames (language sensitive);
+            m_fgs.InitArgumentPtrFromTypeNames(m_specification);
+
+            // get all function info
+            FloatType FT = m_specification.GetFloatType(m_fgs.FloatNames[0]);
+            bool computeMultivectorValue = true;
+            G25.CG.Shared.FuncArgInfo[] tmpFAI = G25.CG.Shared.FuncArgInfo.GetAllFuncArgInfo(m_specification, m_fgs, NB_ARGS, FT, m_specification.m_GMV.Name, computeMultivectorValue);
+
+            m_smv = tmpFAI[0].Type as G25.SMV;
+            if (m_smv == null)
+                throw new G25.UserException("The argument of " + m_fgs.Name + " with optionType=\"" + GetTypeOption(m_fgs) + "\" must be a specialized multivector.");
+
+            RefGA.Multivector value = tmpFAI[0].MultivectorValue[0];
+            if (!m_motor)
+            {
+                int euclBitmap = m_G25M.GetEuclideanBasisVectorBitmap();
+                foreach (RefGA.BasisBlade B in value.BasisBlades)
+                {
+                    if ((B.bitmap & ~euclBitmap) != 0)
+                        throw new G25.UserException("The rotor log (optionType=\"rotor\") requires the basis vectors of " + m_smv.Name + " to be Euclidean.");
+                }
+            }
+            if ((value.GradeUsage() & ~((1 << 0) | (1 << 2) | (1 << 4))) != 0)
+                throw new G25.UserException("The argument of " + m_fgs.Name + " with optionType=\"" + GetTypeOption(m_fgs) + "\" can only have grade 0, 2 and 4 coordinates.");
+
+            // get symbolic result
+            m_grade0Value = value.ExtractGrade(0);
+            m_grade2Value = value.ExtractGrade(2);
+            m_grade4Value = value.ExtractGrade(4);
+            m_grade2grade4Value = G25.CG.Shared.ProductCache.gp(m_grade2Value, m_grade4Value, m_M).ExtractGrade(2);
+            if (m_grade2Value.IsZero())
+                throw new G25.UserException("The argument of " + m_fgs.Name + " with optionType=\"" + GetTypeOption(m_fgs) + "\" must have grade 2 coordinates.");
+
+            // result = mul * grade2 + k * <grade2 grade4>_2
+            m_returnValue = RefGA.Multivector.Add(
+                RefGA.Multivector.gp(m_grade2Value, new RefGA.Multivector(mulName)),
+                RefGA.Multivector.gp(m_grade2grade4Value, new RefGA.Multivector(kName)));
+
+            m_arbitraryPlaneValue = GetArbitraryPlaneValue();
+
+            // get name of return type
+            if (m_fgs.m_returnTypeName.Length == 0)
+                m_fgs.m_returnTypeName = G25.CG.Shared.SpecializedReturnType.GetReturnType(m_specification, m_cgd, m_fgs, FT, m_returnValue).GetName();
+            m_returnType = m_specification.GetType(m_fgs.m_returnTypeName);
+        }
+
+        /// <summary>
+        /// Returns PI times an arbitrary Euclidean plane of the argument (a 360 degree rotation). This is the result
+        /// when the rotation part of the argument is -1, in which case the rotation plane cannot be recovered.
+        /// </summary>
+        protected RefGA.Multivector GetArbitraryPlaneValue()
+        {
+            int euclBitmap = m_G25M.GetEuclideanBasisVectorBitmap();
+            foreach (RefGA.BasisBlade B in m_grade2Value.BasisBlades)
+            {
+                if ((B.bitmap & ~euclBitmap) == 0)
+                    return new RefGA.Multivector(new RefGA.BasisBlade(B.bitmap, Math.PI));
+            }
+            throw new G25.UserException("The argument of " + m_fgs.Name + " with optionType=\"" + GetTypeOption(m_fgs) + "\" must have a Euclidean bivector coordinate.");
+        }
+
+        /// <summary>
+        /// Dependencies are only required for testing.
+        /// </summary>
+        public override void CheckDepencies()
+        {
+        }
+
+        /// <summary>
+        /// Returns the instructions for the log of a rigid body motor M = exp(B1) exp(B2) = c1 + s1 B1 + c1 B2 + s1 B1 B2,
+        /// where c1 = cos(a), s1 = sin(a) / a, B1 B1 = -a^2 and B2 B2 = 0.
+        ///
+        /// Since &lt;M&gt;_0 = c1, &lt;M&gt;_2 = s1 B1 + c1 B2 and &lt;M&gt;_4 = s1 B1 B2:
+        ///   - the sine of the rotation angle follows from &lt;&lt;M&gt;_2 &lt;M&gt;_2&gt;_0 = s1^2 B1 B1,
+        ///   - &lt;&lt;M&gt;_2 &lt;M&gt;_4&gt;_2 = s1^2 (B1 B1) B2, which gives B2,
+        ///   - B1 = (&lt;M&gt;_2 - c1 B2) / s1.
+        /// </summary>
+        protected List<Instruction> GetMotorLogInstructions(FloatType FT, int nbTabs)
+        {
+            List<Instruction> I = new List<Instruction>();
+            bool mustCast = false;
+            bool nPtr = false;
+            bool declareN = true;
+            const string sin2Name = "_sin2_";
+            const string sinName = "_sin_";
+
+            I.Add(new AssignInstruction(nbTabs, FT, FT, mustCast, m_grade0Value, scalarPartName, nPtr, declareN));
+            I.Add(new AssignInstruction(nbTabs, FT, FT, mustCast, RefGA.Multivector.gp(G25.CG.Shared.ProductCache.gp(m_grade2Value, m_grade2Value, m_M).ScalarPart(), -1.0), sin2Name, nPtr, declareN));
+
+            List<Instruction> specialI = new List<Instruction>();
+            List<Instruction> normalI = new List<Instruction>();
+
+            { // special cases: pure translation (or 360 degree rotation)
+                List<Instruction> ifI = new List<Instruction>();
+                List<Instruction> elseI = new List<Instruction>();
+                ifI.Add(new ReturnInstruction(nbTabs + 2, m_returnType, FT, mustCast, RefGA.Multivector.Subtract(m_arbitraryPlaneValue, m_grade2Value)));
+                elseI.Add(new ReturnInstruction(nbTabs + 2, m_returnType, FT, mustCast, m_grade2Value));
+                specialI.Add(new IfElseInstruction(nbTabs + 1, scalarPartName + " < " + FT.DoubleToString(m_specification, 0.0), ifI, elseI));
+            }
+
+            { // normal case
+                RefGA.Multivector sinValue = new RefGA.Multivector(sinName);
+                RefGA.Multivector mulValue = new RefGA.Multivector(mulName);
+                normalI.Add(new AssignInstruction(nbTabs + 1, FT, FT, mustCast, RefGA.Symbolic.UnaryScalarOp.Sqrt(new RefGA.Multivector(sin2Name)), sinName, nPtr, declareN));
+                normalI.Add(new AssignInstruction(nbTabs + 1, FT, FT, mustCast, RefGA.Symbolic.BinaryScalarOp.Atan2(sinValue, new RefGA.Multivector(scalarPartName)), mulName, nPtr, declareN, "/", sinValue));
+                // k = -(1 - c1 mul) / sin^2
+                // (Subtract(Multivector, double) would cancel the symbolic scalar c1 mul against the 1, so subtract a Multivector)
+                normalI.Add(new AssignInstruction(nbTabs + 1, FT, FT, mustCast, RefGA.Multivector.Subtract(RefGA.Multivector.gp(new RefGA.Multivector(scalarPartName), mulValue), new RefGA.Multivector(1.0)), kName, nPtr, declareN, "/", new RefGA.Multivector(sin2Name)));
+                normalI.Add(new ReturnInstruction(nbTabs + 1, m_returnType, FT, mustCast, m_returnValue));
+            }
+
+            I.Add(new IfElseInstruction(nbTabs, sin2Name + " <= " + FT.DoubleToString(m_specification, 0.0), specialI, normalI));
+            return I;
+        }
+
+        /// <summary>
+        /// Returns the instructions for the log of a Euclidean rotor R = exp(B1) exp(B2), where B1 and B2 are commuting
+        /// rotations in orthogonal planes. With ui = sin(ai) Bi / ai, ci = cos(ai) and Si = sin(ai)^2:
+        /// <code>
+        /// &lt;R&gt;_0 = c1 c2,  &lt;R&gt;_2 = c2 u1 + c1 u2,  &lt;R&gt;_4 = u1 u2
+        /// </code>
+        /// S1 and S2 are the roots of S^2 - (1 + &lt;R4 R4&gt;_0 - &lt;R&gt;_0^2) S + &lt;R4 R4&gt;_0, and
+        /// &lt;&lt;R&gt;_2 &lt;R&gt;_4&gt;_2 = -c1 S2 u1 - c2 S1 u2. Solving for u1 and u2 gives
+        /// <code>
+        /// B = ((mul1 c2 S1 - mul2 c1 S2) &lt;R&gt;_2 + (mul1 c1 - mul2 c2) &lt;&lt;R&gt;_2 &lt;R&gt;_4&gt;_2) / (S1 - S2)
+        /// </code>
+        /// where muli = ai / sin(ai). The sign ambiguity of c1 and c2 is resolved by choosing c2 &gt;= 0.
+        /// When S1 = S2 (isoclinic rotation), the decomposition is not unique and both planes are assumed to rotate by the same angle.
+        ///
+        /// When the rotor has no grade 4 part, this reduces to B = atan2(|&lt;R&gt;_2|, &lt;R&gt;_0) &lt;R&gt;_2 / |&lt;R&gt;_2|.
+        /// </summary>
+        protected List<Instruction> GetRotorLogInstructions(FloatType FT, int nbTabs)
+        {
+            List<Instruction> I = new List<Instruction>();
+            Specification S = m_specification;
+            bool mustCast = false;
+            bool nPtr = false;
+            bool declareN = true;
+            string zero = FT.DoubleToString(S, 0.0);
+            string one = FT.DoubleToString(S, 1.0);
+            string sqrtFunc = CodeUtil.OpNameToLangString(S, FT, "sqrt");
+            string atan2Func = CodeUtil.OpNameToLangString(S, FT, "atan2");
+
+            I.Add(new AssignInstruction(nbTabs, FT, FT, mustCast, m_grade0Value, scalarPartName, nPtr, declareN));
+
+            List<Instruction> specialI = new List<Instruction>();
+            List<Instruction> normalI = new List<Instruction>();
+            string specialCondition;
+
+            { // special cases: no rotation, or 360 degree rotation
+                List<Instruction> ifI = new List<Instruction>();
+                List<Instruction> elseI = new List<Instruction>();
+                ifI.Add(new ReturnInstruction(nbTabs + 2, m_returnType, FT, mustCast, m_arbitraryPlaneValue));
+                elseI.Add(new ReturnInstruction(nbTabs + 2, m_returnType, FT, mustCast, RefGA.Multivector.ZERO));
+                specialI.Add(new IfElseInstruction(nbTabs + 1, scalarPartName + " < " + zero, ifI, elseI));
+            }
+
+            if (m_grade4Value.IsZero())
+            { // simple rotor
+                const string sin2Name = "_sin2_";
+                const string sinName = "_sin_";
+                RefGA.Multivector sinValue = new RefGA.Multivector(sinName);
+                I.Add(new AssignInstruction(nbTabs, FT, FT, mustCast, RefGA.Multivector.gp(G25.CG.Shared.ProductCache.gp(m_grade2Value, m_grade2Value, m_M).ScalarPart(), -1.0), sin2Name, nPtr, declareN));
+                specialCondition = sin2Name + " <= " + zero;
+
+                normalI.Add(new AssignInstruction(nbTabs + 1, FT, FT, mustCast, RefGA.Symbolic.UnaryScalarOp.Sqrt(new RefGA.Multivector(sin2Name)), sinName, nPtr, declareN));
+                normalI.Add(new AssignInstruction(nbTabs + 1, FT, FT, mustCast, RefGA.Symbolic.BinaryScalarOp.Atan2(sinValue, new RefGA.Multivector(scalarPartName)), mulName, nPtr, declareN, "/", sinValue));
+                normalI.Add(new ReturnInstruction(nbTabs + 1, m_returnType, FT, mustCast, RefGA.Multivector.gp(m_grade2Value, new RefGA.Multivector(mulName))));
+            }
+            else
+            { // rotor in two planes
+                string tol = FT.DoubleToString(S, Math.Sqrt(FT.PrecisionEpsilon()));
+                I.Add(new AssignInstruction(nbTabs, FT, FT, mustCast, G25.CG.Shared.ProductCache.gp(m_grade4Value, m_grade4Value, m_M).ScalarPart(), "_r44_", nPtr, declareN));
+                I.Add(new VerbatimCodeInstruction(nbTabs,
+                    FT.type + " _sum_, _disc_, _S1_, _S2_, _c1_, _c2_, _mul1_, _mul2_, " + mulName + ", " + kName + ";\n" +
+                    "_sum_ = " + one + " + _r44_ - " + scalarPartName + " * " + scalarPartName + ";\n" +
+                    "_disc_ = _sum_ * _sum_ - " + FT.DoubleToString(S, 4.0) + " * _r44_;\n" +
+                    "_disc_ = (_disc_ > " + zero + ") ? " + sqrtFunc + "(_disc_) : " + zero + ";\n" +
+                    "_S1_ = " + FT.DoubleToString(S, 0.5) + " * (_sum_ + _disc_);\n" +
+                    "_S2_ = " + FT.DoubleToString(S, 0.5) + " * (_sum_ - _disc_);"));
+                specialCondition = "_S1_ <= " + zero;
+
+                normalI.Add(new VerbatimCodeInstruction(nbTabs + 1,
+                    "_c2_ = (_S2_ < " + one + ") ? " + sqrtFunc + "(" + one + " - _S2_) : " + zero + ";\n" +
+                    "_c1_ = (_c2_ > " + zero + ") ? " + scalarPartName + " / _c2_ : " + zero + ";\n" +
+                    "_mul1_ = " + atan2Func + "(" + sqrtFunc + "(_S1_), _c1_) / " + sqrtFunc + "(_S1_);\n" +
+                    "_mul2_ = (_S2_ > " + zero + ") ? " + atan2Func + "(" + sqrtFunc + "(_S2_), _c2_) / " + sqrtFunc + "(_S2_) : " + one + ";\n" +
+                    "if (_disc_ > " + tol + " * _sum_) {\n" +
+                    "\t" + mulName + " = (_mul1_ * _c2_ * _S1_ - _mul2_ * _c1_ * _S2_) / _disc_;\n" +
+                    "\t" + kName + " = (_mul1_ * _c1_ - _mul2_ * _c2_) / _disc_;\n" +
+                    "}\n" +
+                    "else { /* isoclinic: both planes rotate by the same angle */\n" +
+                    "\t" + mulName + " = (_c2_ > " + zero + ") ? _mul2_ / _c2_ : " + one + ";\n" +
+                    "\t" + kName + " = " + zero + ";\n" +
+                    "}"));
+                normalI.Add(new ReturnInstruction(nbTabs + 1, m_returnType, FT, mustCast, m_returnValue));
+            }
+
+            I.Add(new IfElseInstruction(nbTabs, specialCondition, specialI, normalI));
+            return I;
+        }
+
+        /// <summary>
+        /// Should write the declaration/definitions of 'F' to StringBuffer 'SB', taking into account parameters specified in specification 'S'.
+        /// </summary>
+        public override void WriteFunction()
+        {
+            foreach (string floatName in m_fgs.FloatNames)
+            {
+                FloatType FT = m_specification.GetFloatType(floatName);
+
+                bool computeMultivectorValue = true;
+                G25.CG.Shared.FuncArgInfo[] FAI = G25.CG.Shared.FuncArgInfo.GetAllFuncArgInfo(m_specification, m_fgs, NB_ARGS, FT, m_gmv.Name, computeMultivectorValue);
+
+                // generate comment
+                string what = (m_motor) ? "rigid body motor" : "Euclidean rotor";
+                Comment comment = new Comment(
+                    m_fgs.AddUserComment("Returns logarithm of " + FAI[0].TypeName + " using " + m_G25M.m_name + " metric, assuming a " + what + "."));
+
+                // setup instructions
+                int nbTabs = 1;
+                List<Instruction> I = (m_motor) ? GetMotorLogInstructions(FT, nbTabs) : GetRotorLogInstructions(FT, nbTabs);
+
+                // because of lack of overloading, function names include names of argument types
+                G25.fgs CF = G25.CG.Shared.Util.AppendTypenameToFuncName(m_specification, FT, m_fgs, FAI);
+
+                m_funcName[FT.type] = CF.OutputName;
+
+                bool staticFunc = Functions.OutputStaticFunctions(m_specification);
+                G25.CG.Shared.Functions.WriteFunction(m_specification, m_cgd, CF, m_specification.m_inlineFunctions, staticFunc, CF.OutputName, FAI, I, comment);
+            }
+        } // end of WriteFunction
+
+        // used for testing:
+        protected Dictionary<string, string> m_randomScalarFuncName = new Dictionary<string, string>();
+        protected Dictionary<string, string> m_randomBivectorFuncName = new Dictionary<string, string>();
+        protected Dictionary<string, string> m_extractGradeFuncName = new Dictionary<string, string>();
+        protected Dictionary<string, string> m_expBivectorFuncName = new Dictionary<string, string>();
+        protected Dictionary<string, string> m_subtractVersorFuncName = new Dictionary<string, string>();
+
+        /// <summary>
+        /// This function checks the dependencies for the _testing_ code of this function. If dependencies are
+        /// missing, the function adds the required functions (this is done simply by asking for them . . .).
+        /// </summary>
+        public override void CheckTestingDepencies()
+        {
+            foreach (string floatName in m_fgs.FloatNames)
+            {
+                FloatType FT = m_specification.GetFloatType(floatName);
+
+                string defaultReturnTypeName = null;
+                string bivectorName = (m_returnType as G25.SMV).Name;
+                m_randomScalarFuncName[FT.type] = G25.CG.Shared.Dependencies.GetDependency(m_specification, m_cgd, "random_" + FT.type, new string[0], FT.type, FT, null);
+                m_randomBivectorFuncName[FT.type] = G25.CG.Shared.Dependencies.GetDependency(m_specification, m_cgd, "random_" + bivectorName, new string[0], defaultReturnTypeName, FT, null);
+                m_extractGradeFuncName[FT.type] = G25.CG.Shared.Dependencies.GetDependency(m_specification, m_cgd, G25.CG.Shared.CANSparts.EXTRACT_GRADE, new String[] { m_specification.m_GMV.Name, G25.GroupBitmapType.GROUP_BITMAP }, m_specification.m_GMV.Name, FT, null);
+                m_expBivectorFuncName[FT.type] = G25.CG.Shared.Dependencies.GetDependency(m_specification, m_cgd, "exp", new string[] { bivectorName }, m_smv.Name, FT, m_G25M.m_name);
+                m_subtractVersorFuncName[FT.type] = G25.CG.Shared.Dependencies.GetDependency(m_specification, m_cgd, "subtract", new string[] { m_smv.Name, m_smv.Name }, m_smv.Name, FT, null);
+            }
+        }
+
+        /// <summary>
+        /// Writes the testing function for 'F' to 'm_defSB'.
+        /// The generated function returns success (1) or failure (0).
+        ///
+        /// The test (<c>testVersorLogSMV</c> template) checks that exp(log(exp(B))) = exp(B) for random bivectors B.
+        /// The tolerance is relative to the largest coordinate of exp(B), which grows with the translation part of motors.
+        /// </summary>
+        /// <returns>The list of name name of the int() function which tests the function.</returns>
+        public override List<string> WriteTestFunction()
+        {
+            StringBuilder defSB = (m_specification.m_inlineFunctions) ? m_cgd.m_inlineDefSB : m_cgd.m_defSB;
+
+            List<string> testFuncNames = new List<string>();
+            if (!(m_smv.CanConvertToGmv(m_specification) && m_specification.OutputCppOrC())) return testFuncNames;
+
+            foreach (string floatName in m_fgs.FloatNames)
+            {
+                FloatType FT = m_specification.GetFloatType(floatName);
+
+                string testFuncName = Util.GetTestingFunctionName(m_specification, m_cgd, m_funcName[FT.type]);
+                testFuncNames.Add(testFuncName);
+
+                System.Collections.Hashtable argTable = new System.Collections.Hashtable();
+                argTable["S"] = m_specification;
+                argTable["FT"] = FT;
+                argTable["gmvName"] = FT.GetMangledName(m_specification, m_specification.m_GMV.Name);
+                argTable["rotorType"] = m_smv;
+                argTable["rotorName"] = FT.GetMangledName(m_specification, m_smv.Name);
+                argTable["bivectorName"] = FT.GetMangledName(m_specification, m_fgs.m_returnTypeName);
+                argTable["testFuncName"] = testFuncName;
+                argTable["targetFuncName"] = m_funcName[FT.type];
+                argTable["randomScalarFuncName"] = m_randomScalarFuncName[FT.type];
+                argTable["randomBivectorFuncName"] = m_randomBivectorFuncName[FT.type];
+                argTable["extractGradeFuncName"] = m_extractGradeFuncName[FT.type];
+                argTable["expBivectorFunc"] = m_expBivectorFuncName[FT.type];
+                argTable["expTakesOrder"] = ExpTakesOrder(m_returnType as G25.SMV);
+                argTable["subtractRotorFuncName"] = m_subtractVersorFuncName[FT.type];
+                m_cgd.m_cog.EmitTemplate(defSB, "testVersorLogSMV", argTable);
+            }
+
+            return testFuncNames;
+        } // end of WriteTestFunction()
+
+        /// <returns>true when exp() of <paramref name="bivectorType"/> is a series evaluation, which takes an extra <c>order</c> argument
+        /// (i.e., when the square of the bivector is not a scalar, see SinCosExp).</returns>
+        protected bool ExpTakesOrder(G25.SMV bivectorType)
+        {
+            RefGA.Multivector value = G25.CG.Shared.Symbolic.SMVtoSymbolicMultivector(m_specification, bivectorType, "a", false);
+            try
+            {
+                RefGA.Symbolic.SymbolicUtil.EvaluateRandomSymbolicToScalar(G25.CG.Shared.ProductCache.gp(value, value, m_M));
+                return false;
+            }
+            catch (System.Exception)
+            {
+                return true;
+            }
+        }
+    } // end of class LogVersor
+} // end of namespace G25.CG.Shared.Func
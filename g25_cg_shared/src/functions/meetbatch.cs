@@ -0,0 +1,337 @@
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+// Copyright 2008-2010, Daniel Fontijne, University of Amsterdam -- fontijne@science.uva.nl
+
+using System;
+using System.Collections.Generic;
+using System.Text;
+
+namespace G25.CG.Shared.Func
+{
+    /// <summary>
+    /// Generates code for intersecting (meeting) arrays of specialized multivectors.
+    ///
+    /// The function should be called <c>"meetBatch"</c> or <c>"meetMatrix"</c>. Both arguments must be specialized
+    /// multivectors (e.g., a plane or sphere and a line). The meet is computed as <c>lc(dual(a), b)</c>,
+    /// the way the intersections are computed in the usage examples, but as one fused expression per coordinate
+    /// of the result: no intermediate dual is stored.
+    ///
+    /// <c>meetBatch</c> has the signature <c>void f(const A &amp;a, const B *b, R *dst, int nb, int *flags, float eps)</c>
+    /// and sets <c>dst[i]</c> to the meet of <c>a</c> and <c>b[i]</c>.
+    ///
+    /// <c>meetMatrix</c> has the signature <c>void f(const A *a, int nbA, const B *b, int nbB, R *dst, int *flags, float eps)</c>
+    /// and sets <c>dst[i * nbB + j]</c> to the meet of <c>a[i]</c> and <c>b[j]</c>. Like CgaPointDistanceBatch,
+    /// the loops are tiled such that a tile of <c>b</c> stays in the cache.
+    ///
+    /// The loops which compute the meets contain no branches, so they can be vectorized by the compiler.
+    /// When <c>flags</c> is not null, each result is classified afterwards (0 for a regular meet):
+    ///  - <c>flags[i] == 1</c>: the meet is degenerate (zero relative to the arguments, e.g. when they coincide).
+    ///  - <c>flags[i] == 2</c>: the meet lies at infinity (<c>ni . dst[i]</c> is zero relative to <c>dst[i]</c>,
+    ///    e.g. for a line parallel to a plane). Only generated when the algebra has an infinity basis vector
+    ///    (<c>"ni"</c>, unless specified otherwise by <c>optionInfinity="..."</c>).
+    /// The magnitudes are compared with relative tolerance <c>eps</c>.
+    ///
+    /// Only implemented for C and C++.
+    ///
+    /// Some examples of XML to request the functions:
+    /// <code>
+    /// <function name="meetBatch" arg1="plane" arg2="line" floatType="float"/>
+    /// <function name="meetMatrix" arg1="sphere" arg2="line" floatType="float"/>
+    /// </code>
+    ///
+    /// The metric can be specified using the <c>metric="metricName"</c> attribute.
+    /// </summary>
+    public class MeetBatch : G25.CG.Shared.BaseFunctionGenerator
+    {
+        protected const int NB_ARGS = 2;
+
+        /// <summary>Number of elements of the second array which are met with the first array in one go (meetMatrix).</summary>
+        public const int TILE_SIZE = 256;
+
+        /// <summary>Flag which is set when the meet is degenerate.</summary>
+        public const int FLAG_DEGENERATE = 1;
+
+        /// <summary>Flag which is set when the meet lies at infinity.</summary>
+        public const int FLAG_AT_INFINITY = 2;
+
+        protected const string A_NAME = "a";
+        protected const string NB_A_NAME = "nbA";
+        protected const string B_NAME = "b";
+        protected const string NB_NAME = "nb";
+        protected const string NB_B_NAME = "nbB";
+        protected const string DST_NAME = "dst";
+        protected const string FLAGS_NAME = "flags";
+        protected const string EPS_NAME = "eps";
+
+        protected G25.SMV m_smv1 = null; ///< type of the first argument
+        protected G25.SMV m_smv2 = null; ///< type of the second argument
+        protected G25.SMV m_returnSmv = null; ///< type of the result
+        protected RefGA.Multivector m_ni = null; ///< the infinity basis vector (null when the algebra has none)
+
+        /// <returns>true when F.Name == "meetBatch".</returns>
+        public static bool IsMeetBatch(G25.fgs F)
+        {
+            return (F.Name == "meetBatch");
+        }
+
+        /// <returns>true when F.Name == "meetMatrix".</returns>
+        public static bool IsMeetMatrix(G25.fgs F)
+        {
+            return (F.Name == "meetMatrix");
+        }
+
+        /// <summary>
+        /// Checks if this FunctionGenerator can implement a certain function.
+        /// </summary>
+        /// <param name="S">The specification of the algebra.</param>
+        /// <param name="F">The function to be implemented.</param>
+        /// <returns>true if 'F' can be implemented.</returns>
+        public override bool CanImplement(Specification S, G25.fgs F)
+        {
+            return (IsMeetBatch(F) || IsMeetMatrix(F)) &&
+                S.OutputCppOrC() &&
+                (F.m_argumentTypeNames.Length == NB_ARGS) && // all arguments must be explicitly listed
+                G25.CG.Shared.Functions.IsSmv(S, F, 0) &&
+                G25.CG.Shared.Functions.IsSmv(S, F, 1);
+        }
+
+        /// <summary>
+        /// Returns the symbolic meet <c>lc(dual(A), B)</c> (rounded when required by the metric).
+        /// </summary>
+        public static RefGA.Multivector GetMeetValue(G25.Metric G25M, RefGA.Multivector A, RefGA.Multivector B)
+        {
+            RefGA.Multivector value = G25.CG.Shared.ProductCache.ip(RefGA.Multivector.Dual(A, G25M.m_metric), B, G25M.m_metric, RefGA.BasisBlade.InnerProductType.LEFT_CONTRACTION);
+            if (G25M.m_round)
+                value = value.Round(1e-14);
+            return value;
+        }
+
+        /// <summary>
+        /// If this FunctionGenerator can implement 'F', then this function should complete the (possible)
+        /// blanks in 'F'. This means:
+        ///  - Fill in F.m_returnTypeName if it is empty
+        ///  - Fill in F.m_argumentTypeNames (and m_argumentVariableNames) if it is empty.
+        /// </summary>
+        public override void CompleteFGS()
+        {
+            // init argument pointers from the completed typenames (language sensitive);
+            m_fgs.InitArgumentPtrFromTypeNames(m_specification);
+
+            // get all function info
+            FloatType FT = m_specification.GetFloatType(m_fgs.FloatNames[0]);
+            bool computeMultivectorValue = true;
+            G25.CG.Shared.FuncArgInfo[] tmpFAI = G25.CG.Shared.FuncArgInfo.GetAllFuncArgInfo(m_specification, m_fgs, NB_ARGS, FT, m_specification.m_GMV.Name, computeMultivectorValue);
+
+            m_smv1 = (G25.SMV)tmpFAI[0].Type;
+            m_smv2 = (G25.SMV)tmpFAI[1].Type;
+
+            // the infinity test is only generated when the algebra has an infinity basis vector
+            string niName = (m_fgs.GetOption("infinity") != null) ? m_fgs.GetOption("infinity") : "ni";
+            int niIdx = m_specification.GetBasisVectorIndex(niName);
+            if (niIdx >= 0) m_ni = RefGA.Multivector.GetBasisVector(niIdx);
+            else if (m_fgs.GetOption("infinity") != null)
+                throw new G25.UserException("Unknown basis vector specified for infinity: " + niName, XML.FunctionToXmlString(m_specification, m_fgs));
+
+            // get name of return type
+            RefGA.Multivector meetValue = GetMeetValue(m_G25M, tmpFAI[0].MultivectorValue[0], tmpFAI[1].MultivectorValue[0]);
+            if (m_fgs.m_returnTypeName.Length == 0)
+                m_fgs.m_returnTypeName = G25.CG.Shared.SpecializedReturnType.GetReturnType(m_specification, m_cgd, m_fgs, FT, meetValue).GetName();
+            m_returnSmv = m_specification.GetType(m_fgs.m_returnTypeName) as G25.SMV;
+            if (m_returnSmv == null)
+                throw new G25.UserException("The return type of " + m_fgs.Name + " must be a specialized multivector.", XML.FunctionToXmlString(m_specification, m_fgs));
+        }
+
+        /// <summary>
+        /// The array arguments cannot be generated randomly, so no benchmark is generated.
+        /// </summary>
+        public override void CheckBenchmarkDepencies()
+        {
+        }
+
+        /// <returns>The sum of the squares of the coordinates of <paramref name="A"/> (symbolic).</returns>
+        protected static RefGA.Multivector GetSumOfSquares(RefGA.Multivector A)
+        {
+            // the Euclidean scalar product of A and its reverse squares each coordinate with a positive sign
+            return RefGA.Multivector.ScalarProduct(A, RefGA.Multivector.Reverse(A));
+        }
+
+        /// <returns>Declaration of the local variables used by the instructions of GetFlagsInstructions() (and <c>aN2</c>).
+        /// <c>ni2</c> is only declared when the algebra has an infinity basis vector.</returns>
+        protected string GetFlagsVariablesDecl(FloatType FT)
+        {
+            return FT.type + " aN2, ab2, n2" + ((m_ni != null) ? ", ni2;" : ";");
+        }
+
+        /// <summary>
+        /// Returns the instructions which set <c>flags[flagIdx]</c> for result <paramref name="dstValue"/>
+        /// of arguments with (symbolic) squared magnitudes <paramref name="aN2value"/> and <paramref name="bN2value"/>.
+        /// Uses the local variables <c>ab2</c>, <c>n2</c> and <c>ni2</c> (see GetFlagsVariablesDecl()).
+        /// </summary>
+        protected List<G25.CG.Shared.Instruction> GetFlagsInstructions(FloatType FT, int nbTabs, RefGA.Multivector dstValue, RefGA.Multivector aN2value, RefGA.Multivector bN2value, string flagIdx)
+        {
+            List<G25.CG.Shared.Instruction> I = new List<G25.CG.Shared.Instruction>();
+            bool mustCast = false;
+            bool ptr = false;
+            bool declareDst = false;
+            string flag = FLAGS_NAME + "[" + flagIdx + "]";
+
+            I.Add(new AssignInstruction(nbTabs, FT, FT, mustCast, GetSumOfSquares(dstValue), "n2", ptr, declareDst));
+            I.Add(new AssignInstruction(nbTabs, FT, FT, mustCast, RefGA.Multivector.gp(aN2value, bN2value), "ab2", ptr, declareDst));
+            I.Add(new VerbatimCodeInstruction(nbTabs, flag + " = (n2 <= " + EPS_NAME + " * " + EPS_NAME + " * ab2) ? " + FLAG_DEGENERATE + " : 0;"));
+            if (m_ni != null)
+            {
+                RefGA.Multivector niDstValue = G25.CG.Shared.ProductCache.ip(m_ni, dstValue, m_M, RefGA.BasisBlade.InnerProductType.LEFT_CONTRACTION);
+                if (m_G25M.m_round)
+                    niDstValue = niDstValue.Round(1e-14);
+                I.Add(new AssignInstruction(nbTabs, FT, FT, mustCast, GetSumOfSquares(niDstValue), "ni2", ptr, declareDst));
+                I.Add(new VerbatimCodeInstruction(nbTabs, "if ((" + flag + " == 0) && (ni2 <= " + EPS_NAME + " * " + EPS_NAME + " * n2)) " + flag + " = " + FLAG_AT_INFINITY + ";"));
+            }
+            return I;
+        }
+
+        /// <summary>
+        /// Returns the instructions of <c>meetBatch</c>.
+        /// </summary>
+        protected List<G25.CG.Shared.Instruction> GetMeetBatchInstructions(FloatType FT, G25.CG.Shared.FuncArgInfo[] FAI)
+        {
+            List<G25.CG.Shared.Instruction> I = new List<G25.CG.Shared.Instruction>();
+            int nbTabs = 1;
+            bool mustCast = false;
+            bool ptr = false;
+            bool declareDst = false;
+            RefGA.Multivector aValue = G25.CG.Shared.Symbolic.SMVtoSymbolicMultivector(m_specification, m_smv1, FAI[0].Name, FAI[0].Pointer);
+            RefGA.Multivector bValue = G25.CG.Shared.Symbolic.SMVtoSymbolicMultivector(m_specification, m_smv2, B_NAME + "[i]", ptr);
+            RefGA.Multivector dstValue = G25.CG.Shared.Symbolic.SMVtoSymbolicMultivector(m_specification, m_returnSmv, DST_NAME + "[i]", ptr);
+
+            I.Add(new VerbatimCodeInstruction(nbTabs, GetFlagsVariablesDecl(FT)));
+            I.Add(new VerbatimCodeInstruction(nbTabs, "int i;"));
+            I.Add(new VerbatimCodeInstruction(nbTabs, "for (i = 0; i < " + NB_NAME + "; i++) {"));
+            I.Add(new AssignInstruction(nbTabs + 1, m_returnSmv, FT, mustCast, GetMeetValue(m_G25M, aValue, bValue), DST_NAME + "[i]", ptr, declareDst));
+            I.Add(new VerbatimCodeInstruction(nbTabs, "}"));
+
+            I.Add(new CommentInstruction(nbTabs, "classify the results (in a separate loop, such that the loop above stays free of branches)"));
+            I.Add(new VerbatimCodeInstruction(nbTabs, "if (!" + FLAGS_NAME + ") return;"));
+            I.Add(new AssignInstruction(nbTabs, FT, FT, mustCast, GetSumOfSquares(aValue), "aN2", ptr, declareDst));
+            I.Add(new VerbatimCodeInstruction(nbTabs, "for (i = 0; i < " + NB_NAME + "; i++) {"));
+            I.AddRange(GetFlagsInstructions(FT, nbTabs + 1, dstValue, new RefGA.Multivector("aN2"), GetSumOfSquares(bValue), "i"));
+            I.Add(new VerbatimCodeInstruction(nbTabs, "}"));
+            return I;
+        }
+
+        /// <summary>
+        /// Returns the instructions of <c>meetMatrix</c>.
+        /// </summary>
+        protected List<G25.CG.Shared.Instruction> GetMeetMatrixInstructions(FloatType FT)
+        {
+            List<G25.CG.Shared.Instruction> I = new List<G25.CG.Shared.Instruction>();
+            int nbTabs = 1;
+            bool mustCast = false;
+            bool ptr = false;
+            bool declareDst = false;
+            RefGA.Multivector aValue = G25.CG.Shared.Symbolic.SMVtoSymbolicMultivector(m_specification, m_smv1, A_NAME + "[i]", ptr);
+            RefGA.Multivector bValue = G25.CG.Shared.Symbolic.SMVtoSymbolicMultivector(m_specification, m_smv2, B_NAME + "[j]", ptr);
+            RefGA.Multivector dstValue = G25.CG.Shared.Symbolic.SMVtoSymbolicMultivector(m_specification, m_returnSmv, "row[j]", ptr);
+            string dstTypeName = FT.GetMangledName(m_specification, m_returnSmv.Name);
+
+            I.Add(new VerbatimCodeInstruction(nbTabs, dstTypeName + " *row;"));
+            I.Add(new VerbatimCodeInstruction(nbTabs, GetFlagsVariablesDecl(FT)));
+            I.Add(new VerbatimCodeInstruction(nbTabs, "size_t rowIdx;"));
+            I.Add(new VerbatimCodeInstruction(nbTabs, "int i, j, j0, j1;"));
+            I.Add(new CommentInstruction(nbTabs, "meet one tile of " + B_NAME + " with all of " + A_NAME + ", such that the tile stays in the cache"));
+            I.Add(new VerbatimCodeInstruction(nbTabs, "for (j0 = 0; j0 < " + NB_B_NAME + "; j0 += " + TILE_SIZE + ") {"));
+            I.Add(new VerbatimCodeInstruction(nbTabs + 1, "j1 = (j0 + " + TILE_SIZE + " < " + NB_B_NAME + ") ? (j0 + " + TILE_SIZE + ") : " + NB_B_NAME + ";"));
+            I.Add(new VerbatimCodeInstruction(nbTabs + 1, "for (i = 0; i < " + NB_A_NAME + "; i++) {"));
+            I.Add(new CommentInstruction(nbTabs + 2, "compute the offset in size_t, such that nbA * nbB may exceed the range of int"));
+            I.Add(new VerbatimCodeInstruction(nbTabs + 2, "row = " + DST_NAME + " + (size_t)i * (size_t)" + NB_B_NAME + ";"));
+            I.Add(new VerbatimCodeInstruction(nbTabs + 2, "for (j = j0; j < j1; j++) {"));
+            I.Add(new AssignInstruction(nbTabs + 3, m_returnSmv, FT, mustCast, GetMeetValue(m_G25M, aValue, bValue), "row[j]", ptr, declareDst));
+            I.Add(new VerbatimCodeInstruction(nbTabs + 2, "}"));
+            I.Add(new VerbatimCodeInstruction(nbTabs + 1, "}"));
+            I.Add(new VerbatimCodeInstruction(nbTabs, "}"));
+
+            I.Add(new CommentInstruction(nbTabs, "classify the results (in a separate loop, such that the loops above stay free of branches)"));
+            I.Add(new VerbatimCodeInstruction(nbTabs, "if (!" + FLAGS_NAME + ") return;"));
+            I.Add(new VerbatimCodeInstruction(nbTabs, "for (i = 0; i < " + NB_A_NAME + "; i++) {"));
+            I.Add(new VerbatimCodeInstruction(nbTabs + 1, "rowIdx = (size_t)i * (size_t)" + NB_B_NAME + ";"));
+            I.Add(new VerbatimCodeInstruction(nbTabs + 1, "row = " + DST_NAME + " + rowIdx;"));
+            I.Add(new AssignInstruction(nbTabs + 1, FT, FT, mustCast, GetSumOfSquares(aValue), "aN2", ptr, declareDst));
+            I.Add(new VerbatimCodeInstruction(nbTabs + 1, "for (j = 0; j < " + NB_B_NAME + "; j++) {"));
+            I.AddRange(GetFlagsInstructions(FT, nbTabs + 2, dstValue, new RefGA.Multivector("aN2"), GetSumOfSquares(bValue), "rowIdx + j"));
+            I.Add(new VerbatimCodeInstruction(nbTabs + 1, "}"));
+            I.Add(new VerbatimCodeInstruction(nbTabs, "}"));
+            return I;
+        }
+
+        /// <summary>
+        /// Writes the declaration/definitions of 'F' to StringBuffer 'SB', taking into account parameters specified in specification 'S'.
+        /// </summary>
+        public override void WriteFunction()
+        {
+            foreach (string floatName in m_fgs.FloatNames)
+            {
+                FloatType FT = m_specification.GetFloatType(floatName);
+
+                bool computeMultivectorValue = false;
+                G25.CG.Shared.FuncArgInfo[] FAI = G25.CG.Shared.FuncArgInfo.GetAllFuncArgInfo(m_specification, m_fgs, NB_ARGS, FT, m_specification.m_GMV.Name, computeMultivectorValue);
+
+                // because of lack of overloading, function names include names of argument types
+                G25.fgs CF = G25.CG.Shared.Util.AppendTypenameToFuncName(m_specification, FT, m_fgs, FAI);
+                m_funcName[FT.type] = CF.OutputName;
+
+                string type1Name = FT.GetMangledName(m_specification, m_smv1.Name);
+                string type2Name = FT.GetMangledName(m_specification, m_smv2.Name);
+                string dstTypeName = FT.GetMangledName(m_specification, m_returnSmv.Name);
+                string flagsArgs = "int *" + FLAGS_NAME + ", " + FT.type + " " + EPS_NAME;
+                string flagsComment = "When " + FLAGS_NAME + " is not null, " + FLAGS_NAME + "[k] is set to " + FLAG_DEGENERATE + " when result k is degenerate (zero relative to the arguments, up to " + EPS_NAME + ")" +
+                    ((m_ni != null) ? ", to " + FLAG_AT_INFINITY + " when it lies at infinity," : "") + " and to 0 otherwise.";
+
+                string funcDecl;
+                Comment comment;
+                List<G25.CG.Shared.Instruction> I;
+                if (IsMeetBatch(m_fgs))
+                {
+                    string refStr = (m_specification.OutputC()) ? "*" : "&";
+                    funcDecl = "void " + CF.OutputName + "(const " + type1Name + " " + refStr + FAI[0].Name + ", " +
+                        "const " + type2Name + " *" + B_NAME + ", " + dstTypeName + " *" + DST_NAME + ", int " + NB_NAME + ", " + flagsArgs + ")";
+                    comment = new Comment(m_fgs.AddUserComment("Sets " + DST_NAME + "[i] to the meet lc(dual(" + FAI[0].Name + "), " + B_NAME + "[i]) for i = 0 ... " + NB_NAME + "-1, using " + m_G25M.m_name + " metric.\n" +
+                        flagsComment));
+                    I = GetMeetBatchInstructions(FT, FAI);
+                }
+                else
+                {
+                    funcDecl = "void " + CF.OutputName + "(const " + type1Name + " *" + A_NAME + ", int " + NB_A_NAME + ", " +
+                        "const " + type2Name + " *" + B_NAME + ", int " + NB_B_NAME + ", " + dstTypeName + " *" + DST_NAME + ", " + flagsArgs + ")";
+                    comment = new Comment(m_fgs.AddUserComment("Sets " + DST_NAME + "[i * " + NB_B_NAME + " + j] to the meet lc(dual(" + A_NAME + "[i]), " + B_NAME + "[j]), for i = 0 ... " + NB_A_NAME + "-1 and j = 0 ... " + NB_B_NAME + "-1, using " + m_G25M.m_name + " metric.\n" +
+                        DST_NAME + " (and " + FLAGS_NAME + ") must have room for " + NB_A_NAME + " * " + NB_B_NAME + " elements.\n" +
+                        flagsComment));
+                    I = GetMeetMatrixInstructions(FT);
+                }
+
+                // write declaration
+                comment.Write(m_cgd.m_declSB, m_specification, 0);
+                m_cgd.m_declSB.AppendLine(funcDecl + ";");
+
+                // write definition (never inline: the loops are potentially large)
+                StringBuilder defSB = m_cgd.m_defSB;
+                defSB.AppendLine(funcDecl + " {");
+                G25.CG.Shared.Instrumentation.WriteInstrumentationCode(defSB, m_specification, m_cgd, CF.OutputName, FT, FAI);
+                foreach (G25.CG.Shared.Instruction instr in I)
+                    instr.Write(defSB, m_specification, m_cgd);
+                defSB.AppendLine("}");
+            }
+        } // end of WriteFunction
+
+    } // end of class MeetBatch
+} // end of namespace G25.CG.Shared.Func
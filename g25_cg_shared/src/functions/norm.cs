@@ -47,7 +47,6 @@ namespace G25.CG.Shared.Func
         protected RefGA.Multivector m_returnValue; ///< returned value (symbolic multivector)
         protected bool m_isNorm2; ///< squared norm (true)? or regular norm (false)
         protected G25.SMV m_smv = null; ///< if function over SMV, type goes here
-        protected Dictionary<string, string> m_funcName = new Dictionary<string, string>();  ///< generated function name with full mangling, etc
 
         /// <summary>
         /// Checks if this FunctionGenerator can implement a certain function.
@@ -35,7 +35,6 @@ namespace G25.CG.Shared.Func
         protected RefGA.Multivector m_returnValue; ///< returned value (symbolic multivector)
         protected G25.SMV m_smv1 = null; ///< if function over SMV, type goes here
         protected G25.SMV m_smv2 = null; ///< if function over SMV, type goes here
-        protected Dictionary<string, string> m_funcName = new Dictionary<string, string>();  ///< generated function name with full mangling, etc
 
         /// <summary>
         /// Checks if this FunctionGenerator can implement a certain function.
@@ -77,7 +76,7 @@ namespace G25.CG.Shared.Func
             else
             {
                 // compute return value
-                m_returnValue = RefGA.Multivector.op(tmpFAI[0].MultivectorValue[0], tmpFAI[1].MultivectorValue[0]);
+                m_returnValue = G25.CG.Shared.ProductCache.op(tmpFAI[0].MultivectorValue[0], tmpFAI[1].MultivectorValue[0]);
 
                 // get name of return type
                 if (m_fgs.m_returnTypeName.Length == 0)
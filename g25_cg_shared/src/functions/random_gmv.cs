@@ -37,7 +37,6 @@ namespace G25.CG.Shared.Func
         protected Dictionary<string, string> m_scalarGpFunc = new Dictionary<string, string>(); ///< = mangled name of geometric product of GMV and scalar
         protected Dictionary<string, string> m_normFunc = new Dictionary<string, string>(); ///< = mangled name of norm func
         protected Dictionary<string, string> m_GMVname = new Dictionary<string, string>(); ///< = mangled name of GMV
-        protected Dictionary<string, string> m_funcName = new Dictionary<string, string>();  ///< generated function name with full mangling, etc
 
 
         /// <returns>true when F.Name == "random_versor"</returns>
@@ -155,6 +154,12 @@ namespace G25.CG.Shared.Func
 
                 // source
                 m_cgd.m_cog.EmitTemplate(defSB, "randomBladeVersor", argTable);
+
+                // bulk generation
+                if (m_specification.OutputCpp())
+                    RandomScalar.WriteBatchFunction(m_specification, m_cgd, funcName, (string)argTable["mvType"],
+                        ", " + FT.type + " scale, int grade, int basisVectorBitmap", "scale, grade, basisVectorBitmap",
+                        RandomScalar.UsesMersenneTwister(m_specification, FT));
             }
         } // end of WriteFunction
 
@@ -210,6 +215,18 @@ namespace G25.CG.Shared.Func
                 argTable["reverseFuncName"] = m_reverseFuncName[FT.type];
                 argTable["gpFuncName"] = m_gpFuncName[FT.type];
                 m_cgd.m_cog.EmitTemplate(defSB, "testRandomGMV", argTable);
+
+                // test the bulk generation
+                if (m_specification.OutputCpp())
+                {
+                    string batchTestFuncName = testFuncName + "_batch";
+                    testFuncNames.Add(batchTestFuncName);
+
+                    RandomScalar.WriteBatchTestFunction(m_specification, m_cgd, defSB, FT, batchTestFuncName,
+                        m_funcName[FT.type], (string)argTable["gmvName"], "gmv",
+                        ", " + FT.DoubleToString(m_specification, 1.0) + ", 2, -1", // scale, grade, basisVectorBitmap
+                        m_randomScalarFuncName[FT.type], RandomScalar.UsesMersenneTwister(m_specification, FT));
+                }
             }
 
             return testFuncNames;
@@ -111,7 +111,7 @@ namespace G25.CG.Shared.Func
                 generatorType = "java.util.Random";
             else if (m_generatorType == PRGtype.LIBC)
                 generatorType = "c library rand() function";
-            else if (m_generatorType == PRGtype.LIBC)
+            else if (m_generatorType == PRGtype.MT)
                 generatorType = "mersenne twister method";
 
             // get comment
@@ -211,9 +211,124 @@ namespace G25.CG.Shared.Func
             
             defSB.AppendLine("}\n");
 
+            // variants with explicit generator state
+            if (m_specification.OutputCppOrC() && (m_generatorType == PRGtype.MT))
+                WriteStateFunctions(declSB, defSB, inlineStr, funcName, comment);
+
+            // bulk generation
+            if (m_specification.OutputCpp())
+                WriteBatchFunction(m_specification, m_cgd, funcName, m_functionNameFloatType, "", "", m_generatorType == PRGtype.MT);
 
         } // end of WriteFunction
 
+        /// <summary>
+        /// Writes <c>random_float_r(genrand_state *state)</c> and <c>random_float_seed_r(genrand_state *state, unsigned int seed)</c>,
+        /// which use an explicit mersenne twister state instead of the default state of the calling thread.
+        /// This allows multiple threads (or tasks) to each have their own reproducible random sequence.
+        /// Only for C and C++.
+        /// </summary>
+        protected void WriteStateFunctions(StringBuilder declSB, StringBuilder defSB, string inlineStr, string funcName, string comment)
+        {
+            string stateComment = comment + ", using generator state 'state'";
+            new Comment(stateComment).Write(declSB, m_specification, 0);
+            declSB.AppendLine(m_functionNameFloatType + " " + funcName + "_r(genrand_state *state);");
+
+            defSB.AppendLine(inlineStr + m_functionNameFloatType + " " + funcName + "_r(genrand_state *state) {");
+            if (m_functionNameFloatType == "float")
+                defSB.AppendLine("\treturn (" + m_functionNameFloatType + ")genrand_real2_r(state);");
+            else defSB.AppendLine("\treturn (" + m_functionNameFloatType + ")genrand_res53_r(state);");
+            defSB.AppendLine("}\n");
+
+            string seedComment = "Seeds random number generator state 'state' for " + m_functionNameFloatType;
+            new Comment(seedComment).Write(declSB, m_specification, 0);
+            declSB.AppendLine("void " + funcName + "_seed_r(genrand_state *state, unsigned int seed);");
+
+            defSB.AppendLine(inlineStr + "void " + funcName + "_seed_r(genrand_state *state, unsigned int seed) {");
+            defSB.AppendLine("\tinit_genrand_r(state, seed);");
+            defSB.AppendLine("}\n");
+        }
+
+        /// <summary>
+        /// Number of values per chunk of the <c>_batch</c> functions. Each chunk is seeded separately,
+        /// so changing this value changes the generated values.
+        /// </summary>
+        public const int BATCH_CHUNK_SIZE = 256;
+
+        /// <returns>true when <c>random_</c> + <paramref name="FT"/> is generated using the mersenne twister (<c>optionGen="mt"</c>).</returns>
+        public static bool UsesMersenneTwister(Specification S, FloatType FT)
+        {
+            foreach (G25.fgs F in S.m_functions)
+            {
+                if ((F.Name == RANDOM + FT.type) && (Array.IndexOf(F.FloatNames, FT.type) >= 0))
+                    return (F.GetOption("Gen") == "mt");
+            }
+            return false;
+        }
+
+        /// <summary>
+        /// Writes <c>void funcName_batch(returnType *dst, int nb, unsigned int seed, int offset, ...)</c>, which fills
+        /// an array with values returned by <c>funcName(...)</c> (see the <c>randomBatch</c> template).
+        /// 
+        /// When the mersenne twister is used, the values are generated in chunks of BATCH_CHUNK_SIZE,
+        /// and each chunk is seeded with <c>seed</c> and the index of the chunk. The chunks are independent,
+        /// so they can be generated in parallel (OpenMP) and each value only depends on <c>seed</c> and its index.
+        /// Only for C++.
+        /// </summary>
+        /// <param name="S">Specification of algebra.</param>
+        /// <param name="cgd">Declaration goes into <c>cgd.m_declSB</c>, definition into <c>cgd.m_defSB</c>.</param>
+        /// <param name="funcName">Name of the function which generates a single value.</param>
+        /// <param name="returnType">Type returned by <paramref name="funcName"/>.</param>
+        /// <param name="argDecl">Declaration of the extra arguments, starting with <c>", "</c> (can be empty).</param>
+        /// <param name="argCall">The extra arguments, as passed to <paramref name="funcName"/>.</param>
+        /// <param name="mersenneTwister">Whether <paramref name="funcName"/> uses the mersenne twister.</param>
+        public static void WriteBatchFunction(Specification S, CGdata cgd, string funcName, string returnType, string argDecl, string argCall, bool mersenneTwister)
+        {
+            System.Collections.Hashtable argTable = new System.Collections.Hashtable();
+            argTable["S"] = S;
+            argTable["funcName"] = funcName;
+            argTable["returnType"] = returnType;
+            argTable["argDecl"] = argDecl;
+            argTable["argCall"] = argCall;
+            argTable["mersenneTwister"] = mersenneTwister;
+            argTable["chunkSize"] = BATCH_CHUNK_SIZE;
+
+            cgd.m_cog.EmitTemplate(cgd.m_declSB, "randomBatchHeader", argTable);
+            cgd.m_cog.EmitTemplate(cgd.m_defSB, "randomBatch", argTable);
+        }
+
+        /// <summary>
+        /// Writes a function which tests <c>funcName_batch()</c> (see the <c>testRandomBatch</c> template):
+        /// the same seed must give the same values. When the mersenne twister is used, a batch which starts at
+        /// an offset must give the same values as a batch which starts at 0, and the state of the calling thread must not change.
+        /// Only for C++.
+        /// </summary>
+        /// <param name="S">Specification of algebra.</param>
+        /// <param name="cgd">Used for emitting the template.</param>
+        /// <param name="defSB">Where the test function goes.</param>
+        /// <param name="FT">Float type of the values.</param>
+        /// <param name="testFuncName">Name of the test function.</param>
+        /// <param name="funcName">Name of the function which generates a single value.</param>
+        /// <param name="valueType">Type returned by <paramref name="funcName"/>.</param>
+        /// <param name="valueKind"><c>"float"</c>, <c>"gmv"</c> or <c>"smv"</c>; determines how values are compared.</param>
+        /// <param name="argValues">Values of the extra arguments, starting with <c>", "</c> (can be empty).</param>
+        /// <param name="randomScalarFuncName">Name of the random scalar function of <paramref name="FT"/>.</param>
+        /// <param name="mersenneTwister">Whether <paramref name="funcName"/> uses the mersenne twister.</param>
+        public static void WriteBatchTestFunction(Specification S, CGdata cgd, StringBuilder defSB, FloatType FT, string testFuncName, 
+            string funcName, string valueType, string valueKind, string argValues, string randomScalarFuncName, bool mersenneTwister)
+        {
+            System.Collections.Hashtable argTable = new System.Collections.Hashtable();
+            argTable["S"] = S;
+            argTable["FT"] = FT;
+            argTable["testFuncName"] = testFuncName;
+            argTable["targetFuncName"] = funcName;
+            argTable["valueType"] = valueType;
+            argTable["valueKind"] = valueKind;
+            argTable["argValues"] = argValues;
+            argTable["randomScalarFuncName"] = randomScalarFuncName;
+            argTable["mersenneTwister"] = mersenneTwister;
+            cgd.m_cog.EmitTemplate(defSB, "testRandomBatch", argTable);
+        }
+
         /// <summary>
         /// This function checks the dependencies for the _testing_ code of this function. If dependencies are
         /// missing, the function adds the required functions (this is done simply by asking for them . . .).
@@ -247,6 +362,29 @@ namespace G25.CG.Shared.Func
                 "testFuncName=", testFuncName,
                 "randomScalarFuncName=", funcName);
 
+            // test the variants with explicit generator state
+            if (m_specification.OutputCppOrC() && (m_generatorType == PRGtype.MT))
+            {
+                string stateTestFuncName = "test_" + m_fgs.OutputName + "_r_" + m_functionNameFloatType;
+                testFuncNames.Add(stateTestFuncName);
+
+                m_cgd.m_cog.EmitTemplate(defSB, "testRandomScalarState",
+                    "S=", m_specification,
+                    "FT=", FT,
+                    "testFuncName=", stateTestFuncName,
+                    "randomScalarFuncName=", funcName);
+            }
+
+            // test the bulk generation
+            if (m_specification.OutputCpp())
+            {
+                string batchTestFuncName = "test_" + m_fgs.OutputName + "_batch_" + m_functionNameFloatType;
+                testFuncNames.Add(batchTestFuncName);
+
+                WriteBatchTestFunction(m_specification, m_cgd, defSB, FT, batchTestFuncName,
+                    funcName, m_functionNameFloatType, "float", "", funcName, m_generatorType == PRGtype.MT);
+            }
+
             return testFuncNames;
         }
 
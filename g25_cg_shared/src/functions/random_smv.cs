@@ -49,6 +49,7 @@ namespace G25.CG.Shared.Func
         public string m_SMVname;
         protected Dictionary<string, string> m_randomScalarFunc = new Dictionary<string, string>(); ///< = mangled name of random scalar func 
         protected Dictionary<string, string> m_normFunc = new Dictionary<string, string>(); ///< = mangled name of norm func of m_SMVname
+        protected Dictionary<string, string> m_funcName = new Dictionary<string, string>(); ///< = output name of the generated function (per float type)
         protected const string MINIMUM_NORM = "minimumNorm";
         protected const string LARGEST_COORDINATE = "largestCoordinate";
 
@@ -227,7 +228,7 @@ namespace G25.CG.Shared.Func
                         }
                     }
                     randomVector = new RefGA.Multivector(B);
-                    randomSMV = RefGA.Multivector.gp(randomSMV, randomVector, m_G25M.m_metric);
+                    randomSMV = G25.CG.Shared.ProductCache.gp(randomSMV, randomVector, m_G25M.m_metric);
                 }
 
                 // round value if required by metric
@@ -408,9 +409,48 @@ namespace G25.CG.Shared.Func
                 string returnTypeName = FT.GetMangledName(m_specification, m_SMVname);
                 bool staticFunc = Functions.OutputStaticFunctions(m_specification);
                 G25.CG.Shared.Functions.WriteFunction(m_specification, m_cgd, CF, m_specification.m_inlineFunctions, staticFunc, returnTypeName, CF.OutputName, returnArgument, FAI, I, comment);
+
+                m_funcName[FT.type] = CF.OutputName;
+
+                // bulk generation
+                if (m_specification.OutputCpp())
+                    RandomScalar.WriteBatchFunction(m_specification, m_cgd, CF.OutputName, returnTypeName,
+                        ", " + FT.type + " " + FAI[0].Name, FAI[0].Name,
+                        RandomScalar.UsesMersenneTwister(m_specification, FT));
             }
         } // end of WriteFunction
 
+        /// <summary>
+        /// Writes the testing function for 'F' to 'm_defSB'.
+        /// The generated function returns success (1) or failure (0).
+        /// 
+        /// Only the bulk generation (C++ only) is tested.
+        /// </summary>
+        /// <returns>The list of name name of the int() function which tests the function.</returns>
+        public override List<string> WriteTestFunction()
+        {
+            if (!m_specification.OutputCpp()) return null;
+
+            StringBuilder defSB = (m_specification.m_inlineFunctions) ? m_cgd.m_inlineDefSB : m_cgd.m_defSB;
+
+            List<string> testFuncNames = new List<string>();
+
+            foreach (string floatName in m_fgs.FloatNames)
+            {
+                FloatType FT = m_specification.GetFloatType(floatName);
+
+                string testFuncName = Util.GetTestingFunctionName(m_specification, m_cgd, m_funcName[FT.type]) + "_batch";
+                testFuncNames.Add(testFuncName);
+
+                RandomScalar.WriteBatchTestFunction(m_specification, m_cgd, defSB, FT, testFuncName,
+                    m_funcName[FT.type], FT.GetMangledName(m_specification, m_SMVname), "smv",
+                    ", " + FT.DoubleToString(m_specification, 1.0), // scale
+                    m_randomScalarFunc[FT.type], RandomScalar.UsesMersenneTwister(m_specification, FT));
+            }
+
+            return testFuncNames;
+        } // end of WriteTestFunction()
+
 
     } // end of class RandomSMV
 } // end of namespace G25.CG.Shared.Func
@@ -37,6 +37,12 @@ namespace G25.CG.Shared.Func
     /// If the sign of the square is known, much more effective code can be genererated, avoiding 
     /// a (slow and inprecise) series evaluation.
     /// 
+    /// For C and C++, the exponential of a specialized bivector which does not square to a scalar
+    /// (e.g., a conformal motor bivector) uses the invariant decomposition when the algebra admits it:
+    /// the bivector is split into two commuting bivectors which do square to scalars, and the
+    /// exponential is computed in closed form (see WriteInvariantDecompositionExp()). The series
+    /// evaluation is only used as a fallback for degenerate cases.
+    /// 
     /// The metric can be specified using the <c>metric="metricName"</c> attribute.
     /// </summary>
     public class SinCosExp : G25.CG.Shared.BaseFunctionGenerator
@@ -73,6 +79,7 @@ namespace G25.CG.Shared.Func
 
         // constants, intermediate results
         protected const int NB_ARGS = 1;
+        protected const int MAX_SERIES_ORDER = 100; ///< upper limit of the order of the series when it is chosen from the magnitude of the argument (order < 0)
         protected bool m_gmvFunc; ///< is this a function over GMVs?
         protected bool m_scalarSquare; ///< is the argument an SMV which squares to a scalar?
         protected G25.VariableType m_returnType; ///< type of returned value
@@ -82,6 +89,10 @@ namespace G25.CG.Shared.Func
         protected RefGA.Multivector m_mulValue;
         protected string m_alphaName = "_alpha";
         protected string m_mulName = "_mul";
+        protected bool m_invariantDecomposition; ///< is the exp() of the (SMV) bivector computed using the invariant decomposition?
+
+        /// <summary>Suffix of the name of the series evaluation which is used as a fallback by the invariant decomposition.</summary>
+        public const string SERIES_SUFFIX = "_series";
 
         protected string m_inputTypeName;
         protected string m_returnTypeName;
@@ -94,12 +105,10 @@ namespace G25.CG.Shared.Func
         protected Dictionary<string, string> m_gpFuncRdouble = new Dictionary<string, string>(); ///< = mangled name of geometric product of (returnType, double) 
         protected Dictionary<string, string> m_addFuncRR = new Dictionary<string, string>(); ///< = mangled name of add of (returnType, returnType)
         protected Dictionary<string, string> m_subFuncRR = new Dictionary<string, string>(); ///< = mangled name of subtract of (returnType, returnType)
-        protected Dictionary<string, string> m_normE2funcR = new Dictionary<string, string>(); ///< = mangled name of norm2 of (returnType)
         protected Dictionary<string, string> m_SASfuncI = new Dictionary<string, string>(); ///<  = Scale and add scalar (input type)
         protected Dictionary<string, string> m_copyInputTypeToReturnType = new Dictionary<string, string>(); ///<  = copy input type to return type
 
         protected G25.SMV m_smv = null; ///< if function over SMV, type goes here
-        protected Dictionary<string, string> m_funcName = new Dictionary<string, string>();  ///< generated function name with full mangling, etc
 
 
         /// <summary>
@@ -150,7 +159,7 @@ namespace G25.CG.Shared.Func
                 try  // exceptions are caught below -> in that case, do a series for the SMV
                 { // sin/cos/sinh/cosh/exp(smv bivector)
                     RefGA.Multivector value = tmpFAI[0].MultivectorValue[0];
-                    RefGA.Multivector squareValue = RefGA.Multivector.gp(value, value, m_M);
+                    RefGA.Multivector squareValue = G25.CG.Shared.ProductCache.gp(value, value, m_M);
 
                     String userSetSquare = m_fgs.GetOption("square");
                     if (userSetSquare != null) m_signOfSquare = (int)Math.Sign(Double.Parse(userSetSquare));
@@ -223,6 +232,10 @@ namespace G25.CG.Shared.Func
                     ComputeReturnTypeExpSmv(tmpFAI, FT);
                     m_inputTypeName = tmpFAI[0].TypeName;
                     m_fgs.m_returnTypeName = m_returnTypeName;
+
+                    // exp(bivector): try to use the invariant decomposition
+                    m_invariantDecomposition = IsExp(m_fgs) && m_specification.OutputCppOrC() && (m_returnType is G25.SMV) &&
+                        CanUseInvariantDecomposition(tmpFAI[0].MultivectorValue[0]);
                 }
 
             }
@@ -254,7 +267,6 @@ namespace G25.CG.Shared.Func
                     m_gpFuncRdouble[floatName] = G25.CG.Shared.Dependencies.GetDependency(m_specification, m_cgd, "gp", new String[] { m_returnTypeName, FT.type }, FT, null);
                     m_addFuncRR[floatName] = G25.CG.Shared.Dependencies.GetDependency(m_specification, m_cgd, "add", new String[] { m_returnTypeName, m_returnTypeName }, FT, null);
                     m_subFuncRR[floatName] = G25.CG.Shared.Dependencies.GetDependency(m_specification, m_cgd, "subtract", new String[] { m_returnTypeName, m_returnTypeName }, FT, null);
-                    m_normE2funcR[floatName] = G25.CG.Shared.Dependencies.GetDependency(m_specification, m_cgd, "norm2", new String[] { m_returnTypeName }, FT, m_G25M.m_name) + G25.CG.Shared.CANSparts.RETURNS_SCALAR;
                     m_SASfuncI[floatName] = G25.CG.Shared.Dependencies.GetDependency(m_specification, m_cgd, "sas", new String[] { m_inputTypeName, FT.type, FT.type }, FT, null);
 
                     if (IsSin(m_fgs) || IsSinh(m_fgs))
@@ -294,7 +306,12 @@ namespace G25.CG.Shared.Func
                 if (m_gmvFunc || (!m_scalarSquare))
                 {
                     // sin, cos, exp of GMV, or of SMV which does not square to scalar:
-                    WriteFunction(FT, CF);
+                    if (m_invariantDecomposition)
+                    {
+                        WriteFunction(FT, CF, CF.OutputName + SERIES_SUFFIX, "Series evaluation; used by " + CF.OutputName + "() when the closed form is ill-conditioned.");
+                        WriteInvariantDecompositionExp(FT, CF);
+                    }
+                    else WriteFunction(FT, CF, CF.OutputName, m_fgs.Comment);
                 }
                 else
                 {
@@ -431,7 +448,9 @@ namespace G25.CG.Shared.Func
         /// </summary>
         /// <param name="FT"></param>
         /// <param name="CF"></param>
-        protected void WriteFunction(FloatType FT, G25.fgs CF)
+        /// <param name="funcName">Name of the emitted function (usually CF.OutputName).</param>
+        /// <param name="userComment">Comment of the emitted function.</param>
+        protected void WriteFunction(FloatType FT, G25.fgs CF, string funcName, string userComment)
         {
             // get template name
             string templateName = "not set";
@@ -452,7 +471,7 @@ namespace G25.CG.Shared.Func
             System.Collections.Hashtable args = new System.Collections.Hashtable();
             args["S"] = m_specification;
             args["FT"] = FT;
-            args["funcName"] = CF.OutputName;
+            args["funcName"] = funcName;
             args["inputType"] = FT.GetMangledName(m_specification, m_inputTypeName);
             args["returnType"] = FT.GetMangledName(m_specification, m_returnTypeName);
             args["gpFuncII"] = m_gpFuncII[FT.type];
@@ -462,8 +481,8 @@ namespace G25.CG.Shared.Func
             args["gpFuncRdouble"] = m_gpFuncRdouble[FT.type];
             args["addFuncRR"] = m_addFuncRR[FT.type];
             args["subFuncRR"] = m_subFuncRR[FT.type];
-            args["normE2funcR"] = m_normE2funcR[FT.type];
             args["SASfuncI"] = m_SASfuncI[FT.type];
+            args["maxOrder"] = MAX_SERIES_ORDER;
             args["sqrtFunc"] = sqrtFunc;
             args["cosFunc"] = cosFunc;
             args["sinFunc"] = sinFunc;
@@ -489,7 +508,7 @@ namespace G25.CG.Shared.Func
                 args["scalarTmp1"] = accessStr[smv.GetElementIdx(RefGA.BasisBlade.ONE)];
             }
 
-            args["userComment"] = m_fgs.Comment;
+            args["userComment"] = userComment;
 
             m_cgd.m_cog.EmitTemplate(m_cgd.m_defSB, templateName, args);
 
@@ -499,6 +518,160 @@ namespace G25.CG.Shared.Func
             m_funcName[FT.type] = CF.OutputName;
         }
 
+        /// <summary>
+        /// Checks whether the exponential of <paramref name="value"/> can be computed using the invariant decomposition.
+        /// 
+        /// The decomposition splits bivector B into B = B1 + B2 where B1 and B2 commute, and square to scalars.
+        /// This is possible when W = (B ^ B) / 2 = B1 B2 squares to a scalar (e.g., in algebras of dimension 5 or lower).
+        /// </summary>
+        /// <param name="value">Symbolic value of the argument.</param>
+        /// <returns>true when <paramref name="value"/> is a bivector and W squares to a scalar.</returns>
+        protected bool CanUseInvariantDecomposition(RefGA.Multivector value)
+        {
+            if (value.IsZero() || (value.Grade() != 2)) return false;
+            RefGA.Multivector W = RefGA.Multivector.gp(G25.CG.Shared.ProductCache.op(value, value), 0.5);
+            if (W.IsZero()) return false; // simple bivector; handled by the scalar square case
+            return IsScalarValued(G25.CG.Shared.ProductCache.gp(W, W, m_M));
+        }
+
+        /// <returns>true when symbolic multivector <paramref name="A"/> consistently evaluates to a scalar.</returns>
+        protected static bool IsScalarValued(RefGA.Multivector A)
+        {
+            const double EPS = 1e-6;
+            const int NB_ITER = 10;
+            RefGA.Symbolic.RandomSymbolicEvaluator RSE = new RefGA.Symbolic.RandomSymbolicEvaluator(-100.0, 100.0);
+            for (int i = 0; i < NB_ITER; i++)
+            {
+                RSE.reset();
+                RefGA.Multivector E = A.SymbolicEval(RSE);
+                RefGA.Multivector theRest = RefGA.Multivector.Subtract(E, E.RealScalarPart());
+                if (Math.Abs(theRest.Norm_e().RealScalarPart()) > Math.Abs(E.Norm_e().RealScalarPart()) * EPS)
+                    return false;
+            }
+            return true;
+        }
+
+        /// <summary>
+        /// Returns code which sets <paramref name="cosName"/> to cos(alpha) and <paramref name="sincName"/> to sin(alpha) / alpha,
+        /// where alpha^2 = -<paramref name="squareName"/> (or the hyperbolic versions when the square is positive).
+        /// I.e., exp(B) = cosName + sincName * B when B * B = squareName.
+        /// </summary>
+        protected string GetCosSincCode(FloatType FT, string squareName, string cosName, string sincName)
+        {
+            string sqrtFunc = CodeUtil.OpNameToLangString(m_specification, FT, "sqrt");
+            string zero = FT.DoubleToString(m_specification, 0.0);
+            string one = FT.DoubleToString(m_specification, 1.0);
+            return
+                "if (" + squareName + " < " + zero + ") {\n" +
+                "\t" + m_alphaName + " = " + sqrtFunc + "(-" + squareName + ");\n" +
+                "\t" + cosName + " = " + CodeUtil.OpNameToLangString(m_specification, FT, "cos") + "(" + m_alphaName + ");\n" +
+                "\t" + sincName + " = " + CodeUtil.OpNameToLangString(m_specification, FT, "sin") + "(" + m_alphaName + ") / " + m_alphaName + ";\n" +
+                "}\n" +
+                "else if (" + squareName + " > " + zero + ") {\n" +
+                "\t" + m_alphaName + " = " + sqrtFunc + "(" + squareName + ");\n" +
+                "\t" + cosName + " = " + CodeUtil.OpNameToLangString(m_specification, FT, "cosh") + "(" + m_alphaName + ");\n" +
+                "\t" + sincName + " = " + CodeUtil.OpNameToLangString(m_specification, FT, "sinh") + "(" + m_alphaName + ") / " + m_alphaName + ";\n" +
+                "}\n" +
+                "else " + cosName + " = " + sincName + " = " + one + ";";
+        }
+
+        /// <summary>
+        /// Emits the closed form exp() of a specialized bivector, using the invariant decomposition.
+        /// 
+        /// Bivector B is split into B = B1 + B2, where B1 B2 = B2 B1 = W = (B ^ B) / 2.
+        /// The squares l1 and l2 of B1 and B2 are the roots of l^2 - s l + W^2 = 0, with s = &lt;B B&gt;_0.
+        /// With exp(Bi) = ci + si Bi and B1 = B (l1 - W) / (l1 - l2), B2 = B (W - l2) / (l1 - l2):
+        /// <code>
+        /// exp(B) = c1 c2 + ((c2 s1 l1 - c1 s2 l2) B + (c1 s2 - c2 s1) B W) / (l1 - l2) + s1 s2 W
+        /// </code>
+        /// When W = 0 the bivector is simple and exp(B) = c + s B. When l1 and l2 (nearly) coincide while W != 0,
+        /// the series evaluation (named CF.OutputName + SERIES_SUFFIX) is used.
+        /// 
+        /// The function has the same signature as the series evaluation (the <c>order</c> argument is passed on to the fallback).
+        /// </summary>
+        protected void WriteInvariantDecompositionExp(FloatType FT, G25.fgs CF)
+        {
+            Specification S = m_specification;
+            StringBuilder defSB = m_cgd.m_defSB;
+            string inputTypeName = FT.GetMangledName(S, m_inputTypeName);
+            string returnTypeName = FT.GetMangledName(S, m_returnTypeName);
+            string seriesFuncName = CF.OutputName + SERIES_SUFFIX;
+            string xName = "x";
+            bool xPtr = S.OutputC();
+            int nbTabs = 1;
+            bool mustCast = false;
+            bool ptr = false;
+            bool declare = false;
+
+            // symbolic values
+            RefGA.Multivector B = G25.CG.Shared.Symbolic.SMVtoSymbolicMultivector(S, m_smv, xName, xPtr);
+            RefGA.Multivector W = RefGA.Multivector.gp(G25.CG.Shared.ProductCache.op(B, B), 0.5);
+            RefGA.Multivector BW = G25.CG.Shared.ProductCache.gp(B, W, m_M);
+            RefGA.Multivector sValue = G25.CG.Shared.ProductCache.gp(B, B, m_M).ScalarPart();
+            RefGA.Multivector w2Value = G25.CG.Shared.ProductCache.gp(W, W, m_M).ScalarPart();
+            RefGA.Multivector wn2Value = RefGA.Multivector.scp(W, W.Reverse()); // Euclidean, only used to detect W == 0
+            RefGA.Multivector returnValue = RefGA.Multivector.Add(
+                RefGA.Multivector.Add(new RefGA.Multivector("_a"), RefGA.Multivector.gp(B, new RefGA.Multivector("_b"))),
+                RefGA.Multivector.Add(RefGA.Multivector.gp(BW, new RefGA.Multivector("_c")), RefGA.Multivector.gp(W, new RefGA.Multivector("_d"))));
+
+            string zero = FT.DoubleToString(S, 0.0);
+            string one = FT.DoubleToString(S, 1.0);
+            string half = FT.DoubleToString(S, 0.5);
+            string tol = FT.DoubleToString(S, Math.Sqrt(FT.PrecisionEpsilon()));
+            string fabsFunc = CodeUtil.OpNameToLangString(S, FT, "abs");
+            string seriesCall = (S.OutputC())
+                ? "{\n\t" + seriesFuncName + "(" + G25.fgs.RETURN_ARG_NAME + ", " + xName + ", order);\n\treturn;\n}"
+                : "return " + seriesFuncName + "(" + xName + ", order);";
+
+            List<G25.CG.Shared.Instruction> I = new List<G25.CG.Shared.Instruction>();
+            I.Add(new VerbatimCodeInstruction(nbTabs, FT.type + " _s, _w2, _wn2, _disc, _l1, _l2, _c1, _s1, _c2, _s2, _a, _b, _c, _d, " + m_alphaName + ";"));
+            I.Add(new AssignInstruction(nbTabs, FT, FT, mustCast, sValue, "_s", ptr, declare));
+            I.Add(new AssignInstruction(nbTabs, FT, FT, mustCast, w2Value, "_w2", ptr, declare));
+            I.Add(new AssignInstruction(nbTabs, FT, FT, mustCast, wn2Value, "_wn2", ptr, declare));
+            I.Add(new VerbatimCodeInstruction(nbTabs,
+                "if (_wn2 == " + zero + ") {\n" +
+                "\t/* " + xName + " is simple: " + xName + " * " + xName + " = _s */\n" +
+                "\t" + GetCosSincCode(FT, "_s", "_a", "_b").Replace("\n", "\n\t") + "\n" +
+                "\t_c = _d = " + zero + ";\n" +
+                "}\n" +
+                "else {\n" +
+                "\t/* the squares _l1, _l2 of the commuting components of " + xName + " are the roots of l^2 - _s l + _w2 */\n" +
+                "\t_disc = _s * _s - " + FT.DoubleToString(S, 4.0) + " * _w2;\n" +
+                "\t_disc = (_disc > " + zero + ") ? " + CodeUtil.OpNameToLangString(S, FT, "sqrt") + "(_disc) : " + zero + ";\n" +
+                "\tif (_disc <= " + tol + " * (" + one + " + " + fabsFunc + "(_s))) " + seriesCall.Replace("\n", "\n\t") + "\n" +
+                "\t_l1 = " + half + " * (_s + _disc);\n" +
+                "\t_l2 = " + half + " * (_s - _disc);\n" +
+                "\t" + GetCosSincCode(FT, "_l1", "_c1", "_s1").Replace("\n", "\n\t") + "\n" +
+                "\t" + GetCosSincCode(FT, "_l2", "_c2", "_s2").Replace("\n", "\n\t") + "\n" +
+                "\t_a = _c1 * _c2;\n" +
+                "\t_b = (_c2 * _s1 * _l1 - _c1 * _s2 * _l2) / _disc;\n" +
+                "\t_c = (_c1 * _s2 - _c2 * _s1) / _disc;\n" +
+                "\t_d = _s1 * _s2;\n" +
+                "}"));
+            I.Add(new ReturnInstruction(nbTabs, m_returnType, FT, mustCast, returnValue));
+
+            // declaration
+            System.Collections.Hashtable args = new System.Collections.Hashtable();
+            args["S"] = S;
+            args["FT"] = FT;
+            args["funcName"] = CF.OutputName;
+            args["inputType"] = inputTypeName;
+            args["returnType"] = returnTypeName;
+            args["mathFuncName"] = m_fgs.Name;
+            args["maxOrder"] = MAX_SERIES_ORDER;
+            args["userComment"] = "Uses a closed form (invariant decomposition of the bivector). " + m_fgs.Comment;
+            m_cgd.m_cog.EmitTemplate(m_cgd.m_declSB, "seriesDecl", args);
+
+            // definition
+            defSB.AppendLine("");
+            if (S.OutputC())
+                defSB.AppendLine("void " + CF.OutputName + "(" + returnTypeName + " *" + G25.fgs.RETURN_ARG_NAME + ", const " + inputTypeName + " *" + xName + ", int order) {");
+            else defSB.AppendLine(returnTypeName + " " + CF.OutputName + "(const " + inputTypeName + " &" + xName + ", int order /* = -1 */) {");
+            foreach (G25.CG.Shared.Instruction inst in I)
+                inst.Write(defSB, S, m_cgd);
+            defSB.AppendLine("}");
+        }
+
         // used for testing:
         protected Dictionary<string, string> m_randomScalarFuncName = new Dictionary<string, string>();
         protected Dictionary<string, string> m_randomSmvFuncName = new Dictionary<string, string>();
@@ -536,7 +709,9 @@ namespace G25.CG.Shared.Func
                 {
                     string defaultReturnTypeName = null;
                     m_randomSmvFuncName[FT.type] = G25.CG.Shared.Dependencies.GetDependency(m_specification, m_cgd, "random_" + m_smv.Name, new String[0], defaultReturnTypeName, FT, null);
-                    m_gpSinCosExpFuncName[FT.type] = G25.CG.Shared.Dependencies.GetDependency(m_specification, m_cgd, m_fgs.Name, new String[] { m_specification.m_GMV.Name }, m_specification.m_GMV.Name, FT, m_G25M.m_name);
+                    if (m_invariantDecomposition) // compared to the series evaluation, for the sum of two random bivectors
+                        m_addGmvFuncName[FT.type] = G25.CG.Shared.Dependencies.GetDependency(m_specification, m_cgd, "add", new String[] { m_specification.m_GMV.Name, m_specification.m_GMV.Name }, m_specification.m_GMV.Name, FT, null);
+                    else m_gpSinCosExpFuncName[FT.type] = G25.CG.Shared.Dependencies.GetDependency(m_specification, m_cgd, m_fgs.Name, new String[] { m_specification.m_GMV.Name }, m_specification.m_GMV.Name, FT, m_G25M.m_name);
                 }
             }
         }
@@ -544,6 +719,10 @@ namespace G25.CG.Shared.Func
         /// <summary>
         /// Writes the testing function for 'F' to 'm_defSB'.
         /// The generated function returns success (1) or failure (0).
+        /// 
+        /// When exp() of a specialized bivector uses the invariant decomposition, it is compared to the
+        /// series evaluation (<c>testExpInvariantDecomposition</c> template). The random specialized
+        /// bivectors are often simple, so the test also uses the sum of two of them.
         /// </summary>
         /// <returns>The list of name name of the int() function which tests the function.</returns>
         public override List<string> WriteTestFunction()
@@ -584,6 +763,26 @@ namespace G25.CG.Shared.Func
                         m_cgd.m_cog.EmitTemplate(defSB, "testSinhCoshExpGMV", argTable);
                     }
                 }
+                else if (m_invariantDecomposition && m_smv.CanConvertToGmv(m_specification)) // closed form SMV test
+                {
+                    testFuncNames.Add(testFuncName);
+                    System.Collections.Hashtable argTable = new System.Collections.Hashtable();
+                    argTable["S"] = m_specification;
+                    argTable["FT"] = FT;
+                    argTable["gmvName"] = FT.GetMangledName(m_specification, m_specification.m_GMV.Name);
+                    argTable["smv"] = m_smv;
+                    argTable["smvName"] = FT.GetMangledName(m_specification, m_smv.Name);
+                    argTable["resultSmvName"] = FT.GetMangledName(m_specification, m_fgs.m_returnTypeName);
+                    argTable["testFuncName"] = testFuncName;
+                    argTable["targetFuncName"] = m_funcName[FT.type];
+                    argTable["seriesFuncName"] = m_funcName[FT.type] + SERIES_SUFFIX;
+                    argTable["randomScalarFuncName"] = m_randomScalarFuncName[FT.type];
+                    argTable["randomSmvFuncName"] = m_randomSmvFuncName[FT.type];
+                    argTable["addGmvFuncName"] = m_addGmvFuncName[FT.type];
+                    argTable["subtractGmvFuncName"] = m_subtractGmvFuncName[FT.type];
+
+                    m_cgd.m_cog.EmitTemplate(defSB, "testExpInvariantDecomposition", argTable);
+                }
                 else if ((m_smv != null) && m_smv.CanConvertToGmv(m_specification)) // SMV test
                 {
                     testFuncNames.Add(testFuncName);
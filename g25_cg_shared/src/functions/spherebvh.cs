@@ -0,0 +1,593 @@
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+// Copyright 2008-2010, Daniel Fontijne, University of Amsterdam -- fontijne@science.uva.nl
+
+using System;
+using System.Collections.Generic;
+using System.Text;
+
+namespace G25.CG.Shared.Func
+{
+    /// <summary>
+    /// Generates a bounding volume hierarchy over arrays of conformal model spheres (or points).
+    ///
+    /// The function should be called <c>"sphereBVH"</c>. All arguments must be specialized multivectors:
+    ///  - The first argument is the type of the objects (typically <c>dualSphere</c>). The bounding volumes of the
+    ///    hierarchy are of the same type, so it must have the <c>no</c>, Euclidean and <c>ni</c> coordinates.
+    ///  - The second argument is the type of the query points (typically <c>normalizedPoint</c>).
+    ///  - The optional third argument is the type of the ray directions (typically <c>vectorE3GA</c>).
+    ///    When it is present, ray queries are generated as well.
+    ///
+    /// The generated code consists of a node type and a hierarchy type (e.g., <c>dualSphereBVHnode</c>
+    /// and <c>dualSphereBVH</c>) and the functions
+    ///  - <c>dualSphereBVH_build()</c>: builds the hierarchy top-down. Each node is split at the median center
+    ///    along the axis of largest extent, so the hierarchy is balanced.
+    ///  - <c>dualSphereBVH_queryPoint()</c> and <c>dualSphereBVH_queryPoints()</c>: find the objects which contain a point.
+    ///  - <c>dualSphereBVH_queryRay()</c> and <c>dualSphereBVH_queryRays()</c>: find the objects which are intersected by a ray.
+    ///
+    /// All intersection tests are inner products of the query with the (normalized) bounding spheres:
+    /// <c>p . S</c> is half the squared radius minus half the squared distance of <c>p</c> to the center,
+    /// so no Euclidean centers or radii are stored. The batched queries store their hits in one array
+    /// (<c>hitStart</c> holds the start of the hits of each query). No memory is allocated: the caller provides all storage.
+    ///
+    /// The origin and infinity basis vectors are <c>"no"</c> and <c>"ni"</c>, unless specified
+    /// otherwise by <c>optionOrigin="..."</c> and <c>optionInfinity="..."</c>.
+    ///
+    /// Only implemented for C and C++.
+    ///
+    /// Some examples of XML to request the functions:
+    /// <code>
+    /// <function name="sphereBVH" arg1="dualSphere" arg2="normalizedPoint" floatType="float"/>
+    /// <function name="sphereBVH" arg1="dualSphere" arg2="normalizedPoint" arg3="vectorE3GA" floatType="double"/>
+    /// </code>
+    /// </summary>
+    public class SphereBVH : G25.CG.Shared.BaseFunctionGenerator
+    {
+        protected const int NB_ARGS_POINT = 2;
+        protected const int NB_ARGS_RAY = 3;
+
+        /// <summary>Nodes with at most this many objects are not split.</summary>
+        public const int LEAF_SIZE = 4;
+
+        /// <summary>Size of the traversal stack. The hierarchy is balanced, so this suffices for any number of objects.</summary>
+        public const int STACK_SIZE = 64;
+
+        protected G25.SMV m_smvObj = null; ///< type of the objects (and bounding volumes)
+        protected G25.SMV m_smvPoint = null; ///< type of the query points
+        protected G25.SMV m_smvDir = null; ///< type of the ray directions (null when no ray queries are generated)
+
+        protected RefGA.Multivector m_no; ///< origin basis vector
+        protected RefGA.Multivector m_ni; ///< infinity basis vector
+        protected RefGA.Multivector[] m_e; ///< Euclidean basis vectors
+
+        // names of the generated types and functions for the current floating point type (set by WriteFunction())
+        protected string m_objType, m_pointType, m_dirType, m_nodeType, m_bvhType;
+
+        /// <summary>
+        /// Checks if this FunctionGenerator can implement a certain function.
+        /// </summary>
+        /// <param name="S">The specification of the algebra.</param>
+        /// <param name="F">The function to be implemented.</param>
+        /// <returns>true if 'F' can be implemented.</returns>
+        public override bool CanImplement(Specification S, G25.fgs F)
+        {
+            if ((F.Name != "sphereBVH") || (!S.OutputCppOrC())) return false;
+            if ((F.m_argumentTypeNames.Length != NB_ARGS_POINT) && (F.m_argumentTypeNames.Length != NB_ARGS_RAY)) return false; // all arguments must be explicitly listed
+            for (int i = 0; i < F.m_argumentTypeNames.Length; i++)
+                if (!G25.CG.Shared.Functions.IsSmv(S, F, i)) return false;
+            return true;
+        }
+
+        /// <returns>the index of the basis vector named by option <paramref name="optionName"/> of <paramref name="F"/> (or <paramref name="defaultName"/>).</returns>
+        protected static int GetBasisVectorIndex(Specification S, G25.fgs F, string optionName, string defaultName)
+        {
+            string name = (F.GetOption(optionName) != null) ? F.GetOption(optionName) : defaultName;
+            int bvIdx = S.GetBasisVectorIndex(name);
+            if (bvIdx < 0)
+                throw new G25.UserException("Unknown basis vector specified for " + optionName + ": " + name,
+                    XML.FunctionToXmlString(S, F));
+            return bvIdx;
+        }
+
+        /// <summary>
+        /// If this FunctionGenerator can implement 'F', then this function should complete the (possible)
+        /// blanks in 'F'. This means:
+        ///  - Fill in F.m_returnTypeName if it is empty
+        ///  - Fill in F.m_argumentTypeNames (and m_argumentVariableNames) if it is empty.
+        /// </summary>
+        public override void CompleteFGS()
+        {
+            // init argument pointers from the completed typenames (language sensitive);
+            m_fgs.InitArgumentPtrFromTypeNames(m_specification);
+
+            // get all function info
+            FloatType FT = m_specification.GetFloatType(m_fgs.FloatNames[0]);
+            bool computeMultivectorValue = false;
+            G25.CG.Shared.FuncArgInfo[] tmpFAI = G25.CG.Shared.FuncArgInfo.GetAllFuncArgInfo(m_specification, m_fgs, m_fgs.NbArguments, FT, m_specification.m_GMV.Name, computeMultivectorValue);
+
+            m_smvObj = (G25.SMV)tmpFAI[0].Type;
+            m_smvPoint = (G25.SMV)tmpFAI[1].Type;
+            m_smvDir = (tmpFAI.Length == NB_ARGS_RAY) ? (G25.SMV)tmpFAI[2].Type : null;
+
+            // get the basis vectors
+            int noIdx = GetBasisVectorIndex(m_specification, m_fgs, "origin", "no");
+            int niIdx = GetBasisVectorIndex(m_specification, m_fgs, "infinity", "ni");
+            m_no = RefGA.Multivector.GetBasisVector(noIdx);
+            m_ni = RefGA.Multivector.GetBasisVector(niIdx);
+            int euclBitmap = m_G25M.GetEuclideanBasisVectorBitmap() & ~((1 << noIdx) | (1 << niIdx));
+            List<RefGA.Multivector> E = new List<RefGA.Multivector>();
+            for (int i = 0; i < m_specification.m_dimension; i++)
+                if ((euclBitmap & (1 << i)) != 0) E.Add(RefGA.Multivector.GetBasisVector(i));
+            m_e = E.ToArray();
+            if (m_e.Length == 0)
+                throw new G25.UserException("The metric of " + m_fgs.Name + " has no Euclidean basis vectors.", XML.FunctionToXmlString(m_specification, m_fgs));
+
+            // the bounding volumes are stored in the object type, so it must be able to hold a sphere
+            foreach (RefGA.BasisBlade B in GetVolumeValue().BasisBlades)
+            {
+                if (m_smvObj.GetElementIdx(B) < 0)
+                    throw new G25.UserException("Type " + m_smvObj.Name + " cannot hold the bounding spheres of " + m_fgs.Name + " (it lacks coordinate " + new RefGA.BasisBlade(B.bitmap).ToString(m_specification.m_basisVectorNames) + ").",
+                        XML.FunctionToXmlString(m_specification, m_fgs));
+            }
+
+            // the build function is void, the query functions return the number of hits
+            m_fgs.ReturnTypeName = IntegerType.INTEGER;
+        }
+
+        /// <summary>
+        /// The array arguments cannot be generated randomly, so no benchmark is generated.
+        /// </summary>
+        public override void CheckBenchmarkDepencies()
+        {
+        }
+
+        /// <returns>The inner product of <paramref name="A"/> and <paramref name="B"/> (rounded when required by the metric).</returns>
+        protected RefGA.Multivector Dot(RefGA.Multivector A, RefGA.Multivector B)
+        {
+            RefGA.Multivector value = RefGA.Multivector.ScalarProduct(A, B, m_M);
+            if (m_G25M.m_round)
+                value = value.Round(1e-14);
+            return value;
+        }
+
+        /// <returns>The normalized sphere with center <c>m[0] ... m[dim-1]</c> and squared radius <c>R2</c> (symbolic).</returns>
+        protected RefGA.Multivector GetVolumeValue()
+        {
+            RefGA.Multivector center = RefGA.Multivector.ZERO;
+            for (int k = 0; k < m_e.Length; k++)
+                center = RefGA.Multivector.Add(center, RefGA.Multivector.gp(m_e[k], new RefGA.Multivector("m[" + k + "]")));
+            RefGA.Multivector niScale = RefGA.Multivector.gp(RefGA.Multivector.Subtract(Dot(center, center), new RefGA.Multivector("R2")), 0.5);
+            return RefGA.Multivector.Add(RefGA.Multivector.Add(m_no, center), RefGA.Multivector.gp(m_ni, niScale));
+        }
+
+        /// <summary>
+        /// Writes the definition of a function to m_cgd.m_defSB, and (when <paramref name="comment"/> is not null)
+        /// its declaration to m_cgd.m_declSB. Functions without a comment are static helper functions.
+        /// </summary>
+        protected void WriteFunction(FloatType FT, string funcName, string funcDecl, Comment comment, List<G25.CG.Shared.Instruction> I)
+        {
+            if (comment != null)
+            {
+                comment.Write(m_cgd.m_declSB, m_specification, 0);
+                m_cgd.m_declSB.AppendLine(funcDecl + ";");
+            }
+            else funcDecl = "static " + funcDecl;
+
+            // write definition (never inline: the loops are potentially large)
+            StringBuilder defSB = m_cgd.m_defSB;
+            defSB.AppendLine(funcDecl + " {");
+            if (comment != null)
+                G25.CG.Shared.Instrumentation.WriteInstrumentationCode(defSB, m_specification, m_cgd, funcName, FT, null);
+            foreach (G25.CG.Shared.Instruction instr in I)
+                instr.Write(defSB, m_specification, m_cgd);
+            defSB.AppendLine("}");
+        }
+
+        /// <summary>
+        /// Writes the node and hierarchy types to m_cgd.m_declSB.
+        /// </summary>
+        protected void WriteTypes()
+        {
+            StringBuilder SB = m_cgd.m_declSB;
+            bool C = m_specification.OutputC();
+
+            new Comment("A node of a " + m_bvhType + ".").Write(SB, m_specification, 0);
+            SB.AppendLine((C) ? "typedef struct {" : "struct " + m_nodeType + " {");
+            SB.AppendLine("\t/** bounding volume: a normalized " + m_objType + " which encloses all objects below the node */");
+            SB.AppendLine("\t" + m_objType + " bv;");
+            SB.AppendLine("\t/** leaf: index of the first object in objectIdx; inner node: index of the first child (the second child follows it) */");
+            SB.AppendLine("\tint first;");
+            SB.AppendLine("\t/** leaf: number of objects; inner node: 0 */");
+            SB.AppendLine("\tint count;");
+            SB.AppendLine((C) ? "} " + m_nodeType + ";" : "};");
+            SB.AppendLine("");
+
+            new Comment("A bounding volume hierarchy over an array of " + m_objType + ". See " + m_bvhType + "_build().").Write(SB, m_specification, 0);
+            SB.AppendLine((C) ? "typedef struct {" : "struct " + m_bvhType + " {");
+            SB.AppendLine("\t/** the objects (not copied: they must stay valid while the hierarchy is used) */");
+            SB.AppendLine("\tconst " + m_objType + " *objects;");
+            SB.AppendLine("\t/** number of objects */");
+            SB.AppendLine("\tint nbObjects;");
+            SB.AppendLine("\t/** the nodes; node 0 is the root */");
+            SB.AppendLine("\t" + m_nodeType + " *nodes;");
+            SB.AppendLine("\t/** number of nodes */");
+            SB.AppendLine("\tint nbNodes;");
+            SB.AppendLine("\t/** indices of the objects, ordered such that the objects of each leaf are adjacent */");
+            SB.AppendLine("\tint *objectIdx;");
+            SB.AppendLine((C) ? "} " + m_bvhType + ";" : "};");
+            SB.AppendLine("");
+        }
+
+        /// <summary>
+        /// Writes the static helper functions which extract the center and radius of an object,
+        /// set the bounding volume of a node, and build the hierarchy recursively.
+        /// </summary>
+        protected void WriteBuildHelpers(FloatType FT)
+        {
+            List<G25.CG.Shared.Instruction> I;
+            int dim = m_e.Length;
+            bool mustCast = false;
+            bool declareDst = false;
+            bool ptr = true;
+            string zero = FT.DoubleToString(m_specification, 0.0);
+            string sqrtFunc = CodeUtil.OpNameToLangString(m_specification, FT, "sqrt");
+            RefGA.Multivector oValue = G25.CG.Shared.Symbolic.SMVtoSymbolicMultivector(m_specification, m_smvObj, "o", ptr);
+            RefGA.Multivector w = new RefGA.Multivector("w");
+
+            { // center 'c' and squared radius 'r2' of an object
+                I = new List<G25.CG.Shared.Instruction>();
+                I.Add(new VerbatimCodeInstruction(1, FT.type + " w;"));
+                I.Add(new AssignInstruction(1, FT, FT, mustCast, RefGA.Multivector.gp(Dot(oValue, m_ni), -1.0), "w", !ptr, declareDst));
+                for (int k = 0; k < dim; k++)
+                    I.Add(new AssignInstruction(1, FT, FT, mustCast, Dot(oValue, m_e[k]), "c[" + k + "]", !ptr, declareDst, "/", w));
+                I.Add(new AssignInstruction(1, FT, FT, mustCast, Dot(oValue, oValue), "*r2", !ptr, declareDst, "/", RefGA.Multivector.gp(w, w)));
+                WriteFunction(FT, m_bvhType + "_sphereParams", "void " + m_bvhType + "_sphereParams(const " + m_objType + " *o, " + FT.type + " c[" + dim + "], " + FT.type + " *r2)", null, I);
+            }
+
+            { // set the bounding volume of a node
+                I = new List<G25.CG.Shared.Instruction>();
+                I.Add(new AssignInstruction(1, m_smvObj, FT, mustCast, GetVolumeValue(), "node->bv", !ptr, declareDst));
+                WriteFunction(FT, m_bvhType + "_setVolume", "void " + m_bvhType + "_setVolume(" + m_nodeType + " *node, const " + FT.type + " m[" + dim + "], " + FT.type + " R2)", null, I);
+            }
+
+            { // center coordinate of an object
+                I = new List<G25.CG.Shared.Instruction>();
+                I.Add(new VerbatimCodeInstruction(1, FT.type + " c[" + dim + "], r2;"));
+                I.Add(new VerbatimCodeInstruction(1, m_bvhType + "_sphereParams(bvh->objects + objIdx, c, &r2);"));
+                I.Add(new VerbatimCodeInstruction(1, "return c[axis];"));
+                WriteFunction(FT, m_bvhType + "_center", FT.type + " " + m_bvhType + "_center(const " + m_bvhType + " *bvh, int objIdx, int axis)", null, I);
+            }
+
+            { // quickselect on the object indices
+                I = new List<G25.CG.Shared.Instruction>();
+                I.Add(new CommentInstruction(1, "reorders objectIdx[lo ... hi] such that objectIdx[k] is the object with the median center along 'axis', with smaller centers before it and larger ones after it"));
+                I.Add(new VerbatimCodeInstruction(1, "int *idx = bvh->objectIdx;"));
+                I.Add(new VerbatimCodeInstruction(1, "int i, j, tmp;"));
+                I.Add(new VerbatimCodeInstruction(1, FT.type + " pivot;"));
+                I.Add(new VerbatimCodeInstruction(1, "while (lo < hi) {"));
+                I.Add(new VerbatimCodeInstruction(2, "pivot = " + m_bvhType + "_center(bvh, idx[(lo + hi) / 2], axis);"));
+                I.Add(new VerbatimCodeInstruction(2, "i = lo;"));
+                I.Add(new VerbatimCodeInstruction(2, "j = hi;"));
+                I.Add(new VerbatimCodeInstruction(2, "do {"));
+                I.Add(new VerbatimCodeInstruction(3, "while (" + m_bvhType + "_center(bvh, idx[i], axis) < pivot) i++;"));
+                I.Add(new VerbatimCodeInstruction(3, "while (pivot < " + m_bvhType + "_center(bvh, idx[j], axis)) j--;"));
+                I.Add(new VerbatimCodeInstruction(3, "if (i <= j) {"));
+                I.Add(new VerbatimCodeInstruction(4, "tmp = idx[i]; idx[i] = idx[j]; idx[j] = tmp;"));
+                I.Add(new VerbatimCodeInstruction(4, "i++;"));
+                I.Add(new VerbatimCodeInstruction(4, "j--;"));
+                I.Add(new VerbatimCodeInstruction(3, "}"));
+                I.Add(new VerbatimCodeInstruction(2, "} while (i <= j);"));
+                I.Add(new VerbatimCodeInstruction(2, "if (k <= j) hi = j;"));
+                I.Add(new VerbatimCodeInstruction(2, "else if (k >= i) lo = i;"));
+                I.Add(new VerbatimCodeInstruction(2, "else break;"));
+                I.Add(new VerbatimCodeInstruction(1, "}"));
+                WriteFunction(FT, m_bvhType + "_select", "void " + m_bvhType + "_select(" + m_bvhType + " *bvh, int lo, int hi, int k, int axis)", null, I);
+            }
+
+            { // build node 'nodeIdx' over objectIdx[first ... first + count - 1]
+                // the radius is enlarged slightly, such that rounding errors do not cause objects to stick out of the bounding volumes
+                string slack = FT.DoubleToString(m_specification, 1.0 + ((FT.type == "float") ? 1e-5 : 1e-12));
+                I = new List<G25.CG.Shared.Instruction>();
+                I.Add(new VerbatimCodeInstruction(1, m_nodeType + " *node = bvh->nodes + nodeIdx;"));
+                I.Add(new VerbatimCodeInstruction(1, FT.type + " c[" + dim + "], m[" + dim + "], lo[" + dim + "], hi[" + dim + "], r2, d, R = " + zero + ";"));
+                I.Add(new VerbatimCodeInstruction(1, "int i, k, axis, mid, child;"));
+                I.Add(new CommentInstruction(1, "the center of the bounding sphere is the mean of the centers of the objects"));
+                I.Add(new VerbatimCodeInstruction(1, "for (k = 0; k < " + dim + "; k++) m[k] = " + zero + ";"));
+                I.Add(new VerbatimCodeInstruction(1, "for (i = first; i < first + count; i++) {"));
+                I.Add(new VerbatimCodeInstruction(2, m_bvhType + "_sphereParams(bvh->objects + bvh->objectIdx[i], c, &r2);"));
+                I.Add(new VerbatimCodeInstruction(2, "for (k = 0; k < " + dim + "; k++) {"));
+                I.Add(new VerbatimCodeInstruction(3, "m[k] += c[k];"));
+                I.Add(new VerbatimCodeInstruction(3, "if ((i == first) || (c[k] < lo[k])) lo[k] = c[k];"));
+                I.Add(new VerbatimCodeInstruction(3, "if ((i == first) || (c[k] > hi[k])) hi[k] = c[k];"));
+                I.Add(new VerbatimCodeInstruction(2, "}"));
+                I.Add(new VerbatimCodeInstruction(1, "}"));
+                I.Add(new VerbatimCodeInstruction(1, "for (k = 0; k < " + dim + "; k++) m[k] /= (" + FT.type + ")count;"));
+                I.Add(new CommentInstruction(1, "the radius is the largest distance from that center to the far side of an object"));
+                I.Add(new VerbatimCodeInstruction(1, "for (i = first; i < first + count; i++) {"));
+                I.Add(new VerbatimCodeInstruction(2, m_bvhType + "_sphereParams(bvh->objects + bvh->objectIdx[i], c, &r2);"));
+                I.Add(new VerbatimCodeInstruction(2, "d = " + zero + ";"));
+                I.Add(new VerbatimCodeInstruction(2, "for (k = 0; k < " + dim + "; k++) d += (c[k] - m[k]) * (c[k] - m[k]);"));
+                I.Add(new VerbatimCodeInstruction(2, "d = " + sqrtFunc + "(d) + ((r2 > " + zero + ") ? " + sqrtFunc + "(r2) : " + zero + ");"));
+                I.Add(new VerbatimCodeInstruction(2, "if (d > R) R = d;"));
+                I.Add(new VerbatimCodeInstruction(1, "}"));
+                I.Add(new VerbatimCodeInstruction(1, "R *= " + slack + ";"));
+                I.Add(new VerbatimCodeInstruction(1, m_bvhType + "_setVolume(node, m, R * R);"));
+                I.Add(new VerbatimCodeInstruction(1, "if (count <= " + LEAF_SIZE + ") {"));
+                I.Add(new VerbatimCodeInstruction(2, "node->first = first;"));
+                I.Add(new VerbatimCodeInstruction(2, "node->count = count;"));
+                I.Add(new VerbatimCodeInstruction(2, "return;"));
+                I.Add(new VerbatimCodeInstruction(1, "}"));
+                I.Add(new CommentInstruction(1, "split at the median center along the axis with the largest extent"));
+                I.Add(new VerbatimCodeInstruction(1, "axis = 0;"));
+                I.Add(new VerbatimCodeInstruction(1, "for (k = 1; k < " + dim + "; k++)"));
+                I.Add(new VerbatimCodeInstruction(2, "if ((hi[k] - lo[k]) > (hi[axis] - lo[axis])) axis = k;"));
+                I.Add(new VerbatimCodeInstruction(1, "mid = first + count / 2;"));
+                I.Add(new VerbatimCodeInstruction(1, m_bvhType + "_select(bvh, first, first + count - 1, mid, axis);"));
+                I.Add(new VerbatimCodeInstruction(1, "child = bvh->nbNodes;"));
+                I.Add(new VerbatimCodeInstruction(1, "bvh->nbNodes += 2;"));
+                I.Add(new VerbatimCodeInstruction(1, "node->first = child;"));
+                I.Add(new VerbatimCodeInstruction(1, "node->count = 0;"));
+                I.Add(new VerbatimCodeInstruction(1, m_bvhType + "_buildNode(bvh, child, first, mid - first);"));
+                I.Add(new VerbatimCodeInstruction(1, m_bvhType + "_buildNode(bvh, child + 1, mid, first + count - mid);"));
+                WriteFunction(FT, m_bvhType + "_buildNode", "void " + m_bvhType + "_buildNode(" + m_bvhType + " *bvh, int nodeIdx, int first, int count)", null, I);
+            }
+        }
+
+        /// <summary>
+        /// Writes <c>build()</c>.
+        /// </summary>
+        protected void WriteBuild(FloatType FT)
+        {
+            bool C = m_specification.OutputC();
+            string funcName = m_bvhType + "_build";
+            string bvhAcc = (C) ? "bvh->" : "bvh.";
+            string funcDecl = "void " + funcName + "(" + m_bvhType + " " + ((C) ? "*" : "&") + "bvh, const " + m_objType + " *objects, int nbObjects, " + m_nodeType + " *nodes, int *objectIdx)";
+            Comment comment = new Comment(m_fgs.AddUserComment("Builds a bounding volume hierarchy over objects[0] ... objects[nbObjects-1].\n" +
+                "nodes must have room for 2 * nbObjects nodes, objectIdx for nbObjects indices. The objects are not copied.\n" +
+                "The objects must have a non-zero weight (imaginary spheres never contain a point, but they are enclosed as points)."));
+
+            List<G25.CG.Shared.Instruction> I = new List<G25.CG.Shared.Instruction>();
+            I.Add(new VerbatimCodeInstruction(1, "int i;"));
+            I.Add(new VerbatimCodeInstruction(1, bvhAcc + "objects = objects;"));
+            I.Add(new VerbatimCodeInstruction(1, bvhAcc + "nbObjects = nbObjects;"));
+            I.Add(new VerbatimCodeInstruction(1, bvhAcc + "nodes = nodes;"));
+            I.Add(new VerbatimCodeInstruction(1, bvhAcc + "nbNodes = 0;"));
+            I.Add(new VerbatimCodeInstruction(1, bvhAcc + "objectIdx = objectIdx;"));
+            I.Add(new VerbatimCodeInstruction(1, "if (nbObjects <= 0) return;"));
+            I.Add(new VerbatimCodeInstruction(1, "for (i = 0; i < nbObjects; i++) objectIdx[i] = i;"));
+            I.Add(new VerbatimCodeInstruction(1, bvhAcc + "nbNodes = 1;"));
+            I.Add(new VerbatimCodeInstruction(1, m_bvhType + "_buildNode(" + ((C) ? "bvh" : "&bvh") + ", 0, 0, nbObjects);"));
+            WriteFunction(FT, funcName, funcDecl, comment, I);
+        }
+
+        /// <summary>
+        /// Returns the instructions which traverse the hierarchy. Nodes for which <paramref name="volumeTest"/> fails are skipped;
+        /// the objects of the leaves for which <paramref name="objectTest"/> succeeds are hits.
+        /// Both tests are expressions; <c>node</c> and <c>obj</c> refer to the current node and object.
+        /// The (optional) <paramref name="setup"/> instructions go between the declarations and the traversal.
+        /// </summary>
+        protected List<G25.CG.Shared.Instruction> GetTraversalInstructions(List<G25.CG.Shared.Instruction> setup, string volumeTest, string objectTest)
+        {
+            string bvhAcc = (m_specification.OutputC()) ? "bvh->" : "bvh.";
+            List<G25.CG.Shared.Instruction> I = new List<G25.CG.Shared.Instruction>();
+            I.Add(new VerbatimCodeInstruction(1, "int stack[" + STACK_SIZE + "];"));
+            I.Add(new VerbatimCodeInstruction(1, "int sp = 0, nbHits = 0, i;"));
+            I.Add(new VerbatimCodeInstruction(1, "const " + m_nodeType + " *node;"));
+            I.Add(new VerbatimCodeInstruction(1, "const " + m_objType + " *obj;"));
+            if (setup != null) I.AddRange(setup);
+            I.Add(new VerbatimCodeInstruction(1, "if (" + bvhAcc + "nbNodes == 0) return 0;"));
+            I.Add(new VerbatimCodeInstruction(1, "stack[sp++] = 0;"));
+            I.Add(new VerbatimCodeInstruction(1, "while (sp > 0) {"));
+            I.Add(new VerbatimCodeInstruction(2, "node = " + bvhAcc + "nodes + stack[--sp];"));
+            I.Add(new VerbatimCodeInstruction(2, "if (!(" + volumeTest + ")) continue;"));
+            I.Add(new VerbatimCodeInstruction(2, "if (node->count == 0) {"));
+            I.Add(new VerbatimCodeInstruction(3, "stack[sp++] = node->first;"));
+            I.Add(new VerbatimCodeInstruction(3, "stack[sp++] = node->first + 1;"));
+            I.Add(new VerbatimCodeInstruction(2, "}"));
+            I.Add(new VerbatimCodeInstruction(2, "else {"));
+            I.Add(new VerbatimCodeInstruction(3, "for (i = node->first; i < node->first + node->count; i++) {"));
+            I.Add(new VerbatimCodeInstruction(4, "obj = " + bvhAcc + "objects + " + bvhAcc + "objectIdx[i];"));
+            I.Add(new VerbatimCodeInstruction(4, "if (" + objectTest + ") {"));
+            I.Add(new VerbatimCodeInstruction(5, "if (nbHits < maxHits) hits[nbHits] = " + bvhAcc + "objectIdx[i];"));
+            I.Add(new VerbatimCodeInstruction(5, "nbHits++;"));
+            I.Add(new VerbatimCodeInstruction(4, "}"));
+            I.Add(new VerbatimCodeInstruction(3, "}"));
+            I.Add(new VerbatimCodeInstruction(2, "}"));
+            I.Add(new VerbatimCodeInstruction(1, "}"));
+            I.Add(new VerbatimCodeInstruction(1, "return nbHits;"));
+            return I;
+        }
+
+        /// <summary>
+        /// Returns the instructions of a batched query, which calls <paramref name="queryCall"/> for each of the
+        /// <paramref name="nbName"/> queries and stores the hits consecutively.
+        /// <paramref name="queryCall"/> should end with the arguments <c>hits</c> and <c>maxHits</c> of the single query.
+        /// </summary>
+        protected List<G25.CG.Shared.Instruction> GetBatchInstructions(string nbName, string queryCall)
+        {
+            List<G25.CG.Shared.Instruction> I = new List<G25.CG.Shared.Instruction>();
+            I.Add(new VerbatimCodeInstruction(1, "int i, nbHits = 0;"));
+            I.Add(new VerbatimCodeInstruction(1, "for (i = 0; i < " + nbName + "; i++) {"));
+            I.Add(new VerbatimCodeInstruction(2, "hitStart[i] = nbHits;"));
+            I.Add(new CommentInstruction(2, "once 'hits' is full, the hits are only counted"));
+            I.Add(new VerbatimCodeInstruction(2, "nbHits += " + queryCall + "hits + ((nbHits < maxHits) ? nbHits : maxHits), (nbHits < maxHits) ? (maxHits - nbHits) : 0);"));
+            I.Add(new VerbatimCodeInstruction(1, "}"));
+            I.Add(new VerbatimCodeInstruction(1, "hitStart[" + nbName + "] = nbHits;"));
+            I.Add(new VerbatimCodeInstruction(1, "return nbHits;"));
+            return I;
+        }
+
+        /// <summary>
+        /// Writes the point queries (and their static helper functions).
+        /// </summary>
+        protected void WritePointQueries(FloatType FT)
+        {
+            bool C = m_specification.OutputC();
+            bool mustCast = false;
+            bool ptr = true;
+            string zero = FT.DoubleToString(m_specification, 0.0);
+            string refStr = (C) ? "*" : "&";
+            string bvhArg = "const " + m_bvhType + " " + refStr + "bvh";
+            string pArg = (C) ? "p" : "&p";
+            List<G25.CG.Shared.Instruction> I;
+
+            RefGA.Multivector pValue = G25.CG.Shared.Symbolic.SMVtoSymbolicMultivector(m_specification, m_smvPoint, "p", ptr);
+            RefGA.Multivector bvValue = G25.CG.Shared.Symbolic.SMVtoSymbolicMultivector(m_specification, m_smvObj, "node->bv", !ptr);
+            RefGA.Multivector oValue = G25.CG.Shared.Symbolic.SMVtoSymbolicMultivector(m_specification, m_smvObj, "o", ptr);
+
+            { // p . bv: non-negative when 'p' is inside the bounding volume of 'node'
+                I = new List<G25.CG.Shared.Instruction>();
+                I.Add(new ReturnInstruction(1, FT, FT, mustCast, Dot(pValue, bvValue)));
+                WriteFunction(FT, m_bvhType + "_pointVolume", FT.type + " " + m_bvhType + "_pointVolume(const " + m_nodeType + " *node, const " + m_pointType + " *p)", null, I);
+            }
+
+            { // (p . o) / w: non-negative when 'p' is inside object 'o'
+                I = new List<G25.CG.Shared.Instruction>();
+                // (ReturnInstruction ignores the post operation for floats, so the quotient is assigned to 'd' first)
+                I.Add(new VerbatimCodeInstruction(1, FT.type + " w, d;"));
+                I.Add(new AssignInstruction(1, FT, FT, mustCast, RefGA.Multivector.gp(Dot(oValue, m_ni), -1.0), "w", !ptr, false));
+                I.Add(new AssignInstruction(1, FT, FT, mustCast, Dot(pValue, oValue), "d", !ptr, false, "/", new RefGA.Multivector("w")));
+                I.Add(new VerbatimCodeInstruction(1, "return d;"));
+                WriteFunction(FT, m_bvhType + "_pointObject", FT.type + " " + m_bvhType + "_pointObject(const " + m_objType + " *o, const " + m_pointType + " *p)", null, I);
+            }
+
+            { // single query
+                string funcName = m_bvhType + "_queryPoint";
+                string funcDecl = "int " + funcName + "(" + bvhArg + ", const " + m_pointType + " " + refStr + "p, int *hits, int maxHits)";
+                Comment comment = new Comment(m_fgs.AddUserComment("Finds the objects of bvh which contain point p.\n" +
+                    "The indices of (at most) maxHits of them are stored in hits, in no particular order.")).SetReturnComment("the number of objects which contain p (can be larger than maxHits).");
+                I = GetTraversalInstructions(null, m_bvhType + "_pointVolume(node, " + pArg + ") >= " + zero, m_bvhType + "_pointObject(obj, " + pArg + ") >= " + zero);
+                WriteFunction(FT, funcName, funcDecl, comment, I);
+            }
+
+            { // batched query
+                string funcName = m_bvhType + "_queryPoints";
+                string funcDecl = "int " + funcName + "(" + bvhArg + ", const " + m_pointType + " *points, int nbPoints, int *hitStart, int *hits, int maxHits)";
+                Comment comment = new Comment(m_fgs.AddUserComment("Batched version of " + m_bvhType + "_queryPoint(): finds the objects which contain points[0] ... points[nbPoints-1].\n" +
+                    "The hits of points[i] are stored in hits[hitStart[i]] ... hits[hitStart[i + 1] - 1]; hitStart must have room for nbPoints + 1 elements.\n" +
+                    "When the total number of hits is larger than maxHits, only the first maxHits hits are stored.")).SetReturnComment("the total number of hits (can be larger than maxHits).");
+                I = GetBatchInstructions("nbPoints", m_bvhType + "_queryPoint(bvh, " + ((C) ? "points + i" : "points[i]") + ", ");
+                WriteFunction(FT, funcName, funcDecl, comment, I);
+            }
+        }
+
+        /// <summary>
+        /// Writes the ray queries (and their static helper functions).
+        ///
+        /// Along the ray <c>x(t) = origin + t direction</c>, the inner product with a normalized sphere is
+        /// <c>f0 + t f1 - t^2 (direction . direction) / 2</c>, with <c>f0 = origin . S</c> and
+        /// <c>f1 = direction . S - direction . origin</c>. The ray hits the sphere when this is non-negative for some <c>t &gt;= 0</c>.
+        /// </summary>
+        protected void WriteRayQueries(FloatType FT)
+        {
+            bool C = m_specification.OutputC();
+            bool mustCast = false;
+            bool ptr = true;
+            bool declareDst = false;
+            string zero = FT.DoubleToString(m_specification, 0.0);
+            string two = FT.DoubleToString(m_specification, 2.0);
+            string refStr = (C) ? "*" : "&";
+            string bvhArg = "const " + m_bvhType + " " + refStr + "bvh";
+            string rayArgs = "const " + m_pointType + " *origin, const " + m_dirType + " *direction, " + FT.type + " dDotO, " + FT.type + " dd";
+            string rayCallArgs = ((C) ? "origin, direction" : "&origin, &direction") + ", dDotO, dd";
+            List<G25.CG.Shared.Instruction> I;
+
+            RefGA.Multivector originValue = G25.CG.Shared.Symbolic.SMVtoSymbolicMultivector(m_specification, m_smvPoint, "origin", ptr);
+            RefGA.Multivector dirValue = G25.CG.Shared.Symbolic.SMVtoSymbolicMultivector(m_specification, m_smvDir, "direction", ptr);
+            RefGA.Multivector bvValue = G25.CG.Shared.Symbolic.SMVtoSymbolicMultivector(m_specification, m_smvObj, "node->bv", !ptr);
+            RefGA.Multivector oValue = G25.CG.Shared.Symbolic.SMVtoSymbolicMultivector(m_specification, m_smvObj, "o", ptr);
+            RefGA.Multivector w = new RefGA.Multivector("w");
+
+            { // decides whether the ray hits a normalized sphere, given f0, f1 and dd
+                I = new List<G25.CG.Shared.Instruction>();
+                I.Add(new CommentInstruction(1, "either the origin is inside the sphere, or the maximum (at t = f1 / dd) is in front of the origin and inside the sphere"));
+                I.Add(new VerbatimCodeInstruction(1, "return (f0 >= " + zero + ") || ((f1 > " + zero + ") && (f0 + f1 * f1 / (" + two + " * dd) >= " + zero + "));"));
+                WriteFunction(FT, m_bvhType + "_rayHit", "int " + m_bvhType + "_rayHit(" + FT.type + " f0, " + FT.type + " f1, " + FT.type + " dd)", null, I);
+            }
+
+            { // ray versus bounding volume
+                I = new List<G25.CG.Shared.Instruction>();
+                I.Add(new VerbatimCodeInstruction(1, FT.type + " f0, f1;"));
+                I.Add(new AssignInstruction(1, FT, FT, mustCast, Dot(originValue, bvValue), "f0", !ptr, declareDst));
+                I.Add(new AssignInstruction(1, FT, FT, mustCast, RefGA.Multivector.Subtract(Dot(dirValue, bvValue), new RefGA.Multivector("dDotO")), "f1", !ptr, declareDst));
+                I.Add(new VerbatimCodeInstruction(1, "return " + m_bvhType + "_rayHit(f0, f1, dd);"));
+                WriteFunction(FT, m_bvhType + "_rayVolume", "int " + m_bvhType + "_rayVolume(const " + m_nodeType + " *node, " + rayArgs + ")", null, I);
+            }
+
+            { // ray versus object (normalized by its weight)
+                I = new List<G25.CG.Shared.Instruction>();
+                I.Add(new VerbatimCodeInstruction(1, FT.type + " w, f0, f1;"));
+                I.Add(new AssignInstruction(1, FT, FT, mustCast, RefGA.Multivector.gp(Dot(oValue, m_ni), -1.0), "w", !ptr, declareDst));
+                I.Add(new AssignInstruction(1, FT, FT, mustCast, Dot(originValue, oValue), "f0", !ptr, declareDst, "/", w));
+                I.Add(new AssignInstruction(1, FT, FT, mustCast, Dot(dirValue, oValue), "f1", !ptr, declareDst, "/", w));
+                I.Add(new VerbatimCodeInstruction(1, "return " + m_bvhType + "_rayHit(f0, f1 - dDotO, dd);"));
+                WriteFunction(FT, m_bvhType + "_rayObject", "int " + m_bvhType + "_rayObject(const " + m_objType + " *o, " + rayArgs + ")", null, I);
+            }
+
+            { // single query
+                string funcName = m_bvhType + "_queryRay";
+                string funcDecl = "int " + funcName + "(" + bvhArg + ", const " + m_pointType + " " + refStr + "origin, const " + m_dirType + " " + refStr + "direction, int *hits, int maxHits)";
+                Comment comment = new Comment(m_fgs.AddUserComment("Finds the objects of bvh which are hit by the ray origin + t direction (t >= 0), including the objects which contain origin.\n" +
+                    "The indices of (at most) maxHits of them are stored in hits, in no particular order.")).SetReturnComment("the number of objects hit by the ray (can be larger than maxHits).");
+
+                // the origin and direction are references in C++
+                RefGA.Multivector originArgValue = G25.CG.Shared.Symbolic.SMVtoSymbolicMultivector(m_specification, m_smvPoint, "origin", C);
+                RefGA.Multivector dirArgValue = G25.CG.Shared.Symbolic.SMVtoSymbolicMultivector(m_specification, m_smvDir, "direction", C);
+                List<G25.CG.Shared.Instruction> setup = new List<G25.CG.Shared.Instruction>();
+                setup.Add(new VerbatimCodeInstruction(1, FT.type + " dDotO, dd;"));
+                setup.Add(new AssignInstruction(1, FT, FT, mustCast, Dot(dirArgValue, originArgValue), "dDotO", !ptr, declareDst));
+                setup.Add(new AssignInstruction(1, FT, FT, mustCast, Dot(dirArgValue, dirArgValue), "dd", !ptr, declareDst));
+                I = GetTraversalInstructions(setup, m_bvhType + "_rayVolume(node, " + rayCallArgs + ")", m_bvhType + "_rayObject(obj, " + rayCallArgs + ")");
+                WriteFunction(FT, funcName, funcDecl, comment, I);
+            }
+
+            { // batched query
+                string funcName = m_bvhType + "_queryRays";
+                string funcDecl = "int " + funcName + "(" + bvhArg + ", const " + m_pointType + " *origins, const " + m_dirType + " *directions, int nbRays, int *hitStart, int *hits, int maxHits)";
+                Comment comment = new Comment(m_fgs.AddUserComment("Batched version of " + m_bvhType + "_queryRay(): finds the objects which are hit by the rays origins[i] + t directions[i], for i = 0 ... nbRays-1.\n" +
+                    "The hits of ray i are stored in hits[hitStart[i]] ... hits[hitStart[i + 1] - 1]; hitStart must have room for nbRays + 1 elements.\n" +
+                    "When the total number of hits is larger than maxHits, only the first maxHits hits are stored.")).SetReturnComment("the total number of hits (can be larger than maxHits).");
+                I = GetBatchInstructions("nbRays", m_bvhType + "_queryRay(bvh, " + ((C) ? "origins + i, directions + i" : "origins[i], directions[i]") + ", ");
+                WriteFunction(FT, funcName, funcDecl, comment, I);
+            }
+        }
+
+        /// <summary>
+        /// Writes the declaration/definitions of 'F' to StringBuffer 'SB', taking into account parameters specified in specification 'S'.
+        /// </summary>
+        public override void WriteFunction()
+        {
+            foreach (string floatName in m_fgs.FloatNames)
+            {
+                FloatType FT = m_specification.GetFloatType(floatName);
+
+                m_objType = FT.GetMangledName(m_specification, m_smvObj.Name);
+                m_pointType = FT.GetMangledName(m_specification, m_smvPoint.Name);
+                m_dirType = (m_smvDir == null) ? null : FT.GetMangledName(m_specification, m_smvDir.Name);
+                m_nodeType = FT.GetMangledName(m_specification, m_smvObj.Name + "BVHnode");
+                m_bvhType = FT.GetMangledName(m_specification, m_smvObj.Name + "BVH");
+                m_funcName[FT.type] = m_bvhType + "_build";
+
+                WriteTypes();
+                WriteBuildHelpers(FT);
+                WriteBuild(FT);
+                WritePointQueries(FT);
+                if (m_smvDir != null)
+                    WriteRayQueries(FT);
+            }
+        } // end of WriteFunction
+
+    } // end of class SphereBVH
+} // end of namespace G25.CG.Shared.Func
@@ -26,15 +26,18 @@ namespace G25.CG.Shared.Func
     /// The function name should be <c>"unit"</c>.
     /// 
     /// The metric can be specified using the <c>metric="metricName"</c> attribute.
+    /// 
+    /// The function <c>"unitInPlace"</c> (C and C++, general multivector only) overwrites its 
+    /// argument with the unit instead of returning a new multivector.
     /// </summary>
     public class Unit : G25.CG.Shared.BaseFunctionGenerator
     {
         protected const int NB_ARGS = 1;
         protected bool m_gmvFunc; ///< is this a function over GMVs?
+        protected bool m_inPlace; ///< is this the in-place variant (over GMVs)?
         protected RefGA.Multivector m_nValue;
         protected RefGA.Multivector m_returnValue; ///< returned value (symbolic multivector)
         protected G25.SMV m_smv = null; ///< if function over SMV, type goes here
-        protected Dictionary<string, string> m_funcName = new Dictionary<string, string>();  ///< generated function name with full mangling, etc
         protected G25.VariableType m_returnType; ///< return type
         protected const string normName = "_n_";
 
@@ -47,7 +50,7 @@ namespace G25.CG.Shared.Func
         /// <returns>true if 'F' can be implemented</returns>
         public override bool CanImplement(Specification S, G25.fgs F)
         {
-            return ((F.Name == "unit") && (F.MatchNbArguments(1)));
+            return (((F.Name == "unit") || ((F.Name == "unitInPlace") && S.OutputCppOrC())) && (F.MatchNbArguments(1)));
         }
 
         /// <summary>
@@ -71,6 +74,9 @@ namespace G25.CG.Shared.Func
             G25.CG.Shared.FuncArgInfo[] tmpFAI = G25.CG.Shared.FuncArgInfo.GetAllFuncArgInfo(m_specification, m_fgs, NB_ARGS, FT, m_specification.m_GMV.Name, computeMultivectorValue);
 
             m_gmvFunc = !tmpFAI[0].IsScalarOrSMV();
+            m_inPlace = (m_fgs.Name == "unitInPlace");
+            if (m_inPlace && (!m_gmvFunc))
+                throw new G25.UserException("The argument of " + m_fgs.Name + " must be the general multivector.");
 
             // compute intermediate results, set return type
             if (m_gmvFunc) m_fgs.m_returnTypeName = m_gmv.Name; // unit(gmv) = gmv
@@ -81,7 +87,7 @@ namespace G25.CG.Shared.Func
                 // get symbolic result
                 RefGA.Multivector value = tmpFAI[0].MultivectorValue[0];
                 RefGA.Multivector reverseValue = RefGA.Multivector.Reverse(value);
-                RefGA.Multivector n2Value = RefGA.Multivector.gp(reverseValue, value, m_M);
+                RefGA.Multivector n2Value = G25.CG.Shared.ProductCache.gp(reverseValue, value, m_M);
                 m_nValue = n2Value;
                 if (!m_M.IsPositiveDefinite())
                     m_nValue = RefGA.Symbolic.UnaryScalarOp.Abs(m_nValue);
@@ -133,7 +139,12 @@ namespace G25.CG.Shared.Func
                     m_fgs.AddUserComment("Returns unit of " + FAI[0].TypeName + " using " + m_G25M.m_name + " metric."));
 
                 // if scalar or specialized: generate specialized function
-                if (m_gmvFunc)
+                if (m_inPlace)
+                {
+                    comment = new Comment(m_fgs.AddUserComment("Sets " + FAI[0].Name + " to its unit using " + m_G25M.m_name + " metric."));
+                    m_funcName[FT.type] = G25.CG.Shared.GmvCASNparts.WriteDivInPlaceFunction(m_specification, m_cgd, FT, m_G25M, FAI, m_fgs, comment, G25.CG.Shared.CANSparts.DIVCODETYPE.UNIT);
+                }
+                else if (m_gmvFunc)
                 {
                     m_funcName[FT.type] = G25.CG.Shared.GmvCASNparts.WriteDivFunction(m_specification, m_cgd, FT, m_G25M, FAI, m_fgs, comment, G25.CG.Shared.CANSparts.DIVCODETYPE.UNIT);
                 }
@@ -176,12 +187,22 @@ namespace G25.CG.Shared.Func
         protected Dictionary<string, string> m_spFuncName = new Dictionary<string, string>();
         protected Dictionary<string, string> m_randomSmvFuncName = new Dictionary<string, string>();
 
+        /// <summary>
+        /// The in-place variant overwrites its argument, so it is not benchmarked.
+        /// </summary>
+        public override void CheckBenchmarkDepencies()
+        {
+            if (m_inPlace) return;
+            base.CheckBenchmarkDepencies();
+        }
+
         /// <summary>
         /// This function checks the dependencies for the _testing_ code of this function. If dependencies are
         /// missing, the function adds the required functions (this is done simply by asking for them . . .).
         /// </summary>
         public override void CheckTestingDepencies()
         {
+            if (m_inPlace) return; // the in-place variant shares its code with the regular function
             //bool returnTrueName = true;
             foreach (string floatName in m_fgs.FloatNames)
             {
@@ -213,6 +234,7 @@ namespace G25.CG.Shared.Func
             StringBuilder defSB = (m_specification.m_inlineFunctions) ? m_cgd.m_inlineDefSB : m_cgd.m_defSB;
 
             List<string> testFuncNames = new List<string>();
+            if (m_inPlace) return testFuncNames;
 
 
             foreach (string floatName in m_fgs.FloatNames)
@@ -0,0 +1,394 @@
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+// Copyright 2008-2010, Daniel Fontijne, University of Amsterdam -- fontijne@science.uva.nl
+
+using System;
+using System.Collections.Generic;
+using System.Text;
+
+namespace G25.CG.Shared.Func
+{
+    /// <summary>
+    /// Generates code for converting a (unit) versor to an outermorphism.
+    ///
+    /// The function should be called <c>"versorToOM"</c> or <c>"unitVersorToOM"</c>.
+    /// <c>"unitVersorToOM"</c> assumes the versor is unit (which avoids having to invert it).
+    ///
+    /// The only argument is the versor, which must be a specialized multivector. The return type is the
+    /// outermorphism type (general or specialized). When no return type is specified, the general outermorphism is used.
+    ///
+    /// The generated function computes the images of the domain vectors of the outermorphism under the versor
+    /// and sets the outermorphism from these images (using the regular set function of the outermorphism,
+    /// see OMinit.WriteSetVectorImages()). Applying the returned outermorphism (<c>applyOM</c>) then gives the same result
+    /// as applying the versor (<c>applyVersor</c>), but is much cheaper when the same versor is applied to many multivectors.
+    ///
+    /// Only implemented for C and C++.
+    ///
+    /// The metric can be specified using the <c>metric="metricName"</c> attribute.
+    /// </summary>
+    public class VersorToOM : G25.CG.Shared.BaseFunctionGenerator
+    {
+        protected const int NB_ARGS = 1;
+        protected const string NORM_SQUARED_NAME = "_n2_";
+        protected const string INVERSE_NORM_SQUARED_NAME = "_in2_";
+
+        protected bool m_isUnit; ///< set to true when the versor is unit
+        protected G25.OM m_om; ///< the outermorphism type (return type)
+        protected G25.SMV m_versorSmv; ///< the versor type
+        protected RefGA.Multivector[] m_imageValue; ///< symbolic value of the images of the domain vectors of m_om
+        protected RefGA.Multivector m_n2Value; ///< symbolic value of norm squared of versor (null when m_isUnit)
+
+        /// <returns>true when <c>F.Name == "versorToOM"</c>.</returns>
+        public static bool IsVersorToOM(G25.fgs F)
+        {
+            return F.Name == "versorToOM";
+        }
+
+        /// <returns>true when <c>F.Name == "unitVersorToOM"</c>.</returns>
+        public static bool IsUnitVersorToOM(G25.fgs F)
+        {
+            return F.Name == "unitVersorToOM";
+        }
+
+        /// <summary>
+        /// Checks if this FunctionGenerator can implement a certain function.
+        /// </summary>
+        /// <param name="S">The specification of the algebra.</param>
+        /// <param name="F">The function to be implemented.</param>
+        /// <returns>true if 'F' can be implemented</returns>
+        public override bool CanImplement(Specification S, G25.fgs F)
+        {
+            return (IsVersorToOM(F) || IsUnitVersorToOM(F)) &&
+                S.OutputCppOrC() &&
+                F.MatchNbArguments(NB_ARGS) &&
+                G25.CG.Shared.Functions.IsSmv(S, F, 0); // argument 0 must be a specialized multivector
+        }
+
+        /// <summary>
+        /// If this FunctionGenerator can implement 'F', then this function should complete the (possible)
+        /// blanks in 'F'. This means:
+        ///  - Fill in F.m_returnTypeName if it is empty
+        ///  - Fill in F.m_argumentTypeNames (and m_argumentVariableNames) if it is empty.
+        /// </summary>
+        public override void CompleteFGS()
+        {
+            m_isUnit = IsUnitVersorToOM(m_fgs);
+
+            // init argument pointers from the completed typenames (language sensitive);
+            m_fgs.InitArgumentPtrFromTypeNames(m_specification);
+
+            // get outermorphism type
+            if (m_fgs.m_returnTypeName.Length == 0)
+            {
+                if (m_specification.m_GOM == null)
+                    throw new G25.UserException("No general outermorphism type defined, while it is required because the return type was unspecified.");
+                m_fgs.m_returnTypeName = m_specification.m_GOM.Name;
+            }
+            m_om = m_specification.GetType(m_fgs.m_returnTypeName) as G25.OM;
+            if (m_om == null)
+                throw new G25.UserException("The return type of " + m_fgs.Name + " must be an outermorphism.");
+
+            // get symbolic images of domain vectors
+            FloatType FT = m_specification.GetFloatType(m_fgs.FloatNames[0]);
+            bool computeMultivectorValue = true;
+            G25.CG.Shared.FuncArgInfo[] tmpFAI = G25.CG.Shared.FuncArgInfo.GetAllFuncArgInfo(m_specification, m_fgs, NB_ARGS, FT, m_specification.m_GMV.Name, computeMultivectorValue);
+            m_versorSmv = (G25.SMV)tmpFAI[0].Type;
+            m_imageValue = GetVectorImages(m_G25M, m_om, tmpFAI[0].MultivectorValue[0], m_isUnit, out m_n2Value);
+        }
+
+        /// <summary>
+        /// Computes the images of the domain vectors of <paramref name="om"/> under a versor: <c>V * v * reverse(V)</c>.
+        /// When the versor is not unit, the images must still be divided by the norm squared of the versor.
+        /// </summary>
+        /// <param name="G25M">The metric.</param>
+        /// <param name="om">The outermorphism type.</param>
+        /// <param name="versorValue">Symbolic value of the versor.</param>
+        /// <param name="unit">Whether the versor is unit.</param>
+        /// <param name="n2Value">Set to the symbolic value of the norm squared of the versor, or null when <paramref name="unit"/> is true.</param>
+        /// <returns>The symbolic image of each vector in <c>om.DomainVectors</c>.</returns>
+        public static RefGA.Multivector[] GetVectorImages(G25.Metric G25M, G25.OM om, RefGA.Multivector versorValue, bool unit, out RefGA.Multivector n2Value)
+        {
+            RefGA.Multivector reverseVersorValue = RefGA.Multivector.Reverse(versorValue);
+
+            RefGA.Multivector[] imageValue = new RefGA.Multivector[om.DomainVectors.Length];
+            for (int d = 0; d < om.DomainVectors.Length; d++)
+            {
+                RefGA.Multivector domainVectorValue = new RefGA.Multivector(om.DomainVectors[d]);
+                imageValue[d] = G25.CG.Shared.ProductCache.gp(
+                    G25.CG.Shared.ProductCache.gp(versorValue, domainVectorValue, G25M.m_metric),
+                    reverseVersorValue, G25M.m_metric).ExtractGrade(1);
+                if (G25M.m_round)
+                    imageValue[d] = imageValue[d].Round(1e-14);
+            }
+
+            n2Value = null;
+            if (!unit)
+            {
+                n2Value = G25.CG.Shared.ProductCache.ip(reverseVersorValue, versorValue, G25M.m_metric, RefGA.BasisBlade.InnerProductType.LEFT_CONTRACTION).ExtractGrade(0);
+                if (G25M.m_round)
+                    n2Value = n2Value.Round(1e-14);
+            }
+
+            return imageValue;
+        }
+
+        /// <returns>The specialized multivector type used for the images of the domain vectors of <paramref name="om"/>.</returns>
+        public static G25.SMV GetRangeVectorType(Specification S, G25.FloatType FT, CGdata cgd, G25.OM om)
+        {
+            if (om is G25.GOM) return G25.CG.Shared.OMinit.GetRangeVectorType(S, FT, cgd, (G25.GOM)om);
+            else return G25.CG.Shared.OMinit.GetRangeVectorType(S, FT, cgd, (G25.SOM)om);
+        }
+
+        /// <summary>
+        /// Returns instructions which set outermorphism <paramref name="omName"/> from the images of its domain vectors
+        /// (see GetVectorImages()). The images are assigned to local variables, which are passed to the set function of the outermorphism.
+        /// </summary>
+        /// <param name="S">Specification of algebra.</param>
+        /// <param name="cgd">Missing range vector types are added here.</param>
+        /// <param name="FT">Floating point type.</param>
+        /// <param name="om">The outermorphism type.</param>
+        /// <param name="imageValue">Symbolic images of the domain vectors.</param>
+        /// <param name="n2Value">Norm squared of the versor (the images are divided by it, see DivideByNormSquared()). Can be null.</param>
+        /// <param name="omName">Name of the outermorphism variable.</param>
+        /// <param name="omPtr">Whether the outermorphism variable is a pointer.</param>
+        /// <param name="nbTabs">How many tabs to put in front of the code.</param>
+        public static List<Instruction> GetSetOMinstructions(Specification S, CGdata cgd, G25.FloatType FT, G25.OM om,
+            RefGA.Multivector[] imageValue, RefGA.Multivector n2Value, string omName, bool omPtr, int nbTabs)
+        {
+            List<Instruction> I = new List<Instruction>();
+            bool mustCast = false;
+
+            G25.SMV rangeVectorType = GetRangeVectorType(S, FT, cgd, om);
+            string rangeVectorTypeName = FT.GetMangledName(S, rangeVectorType.Name);
+
+            string[] imageNames = new string[om.DomainVectors.Length];
+            for (int d = 0; d < om.DomainVectors.Length; d++)
+            {
+                // AssignInstruction cannot declare specialized multivectors, so declare them up front
+                imageNames[d] = "i" + om.DomainVectors[d].ToLangString(S.m_basisVectorNames);
+                I.Add(new VerbatimCodeInstruction(nbTabs, rangeVectorTypeName + " " + imageNames[d] + ";"));
+            }
+
+            if (n2Value != null)
+            {
+                bool n2Ptr = false;
+                bool declareN2 = true;
+                bool useInverseN2 = false;
+                imageValue = (RefGA.Multivector[])imageValue.Clone();
+                for (int d = 0; d < om.DomainVectors.Length; d++)
+                {
+                    imageValue[d] = DivideByNormSquared(imageValue[d], n2Value);
+                    useInverseN2 |= UsesSymbol(imageValue[d], INVERSE_NORM_SQUARED_NAME);
+                }
+
+                if (useInverseN2)
+                {
+                    I.Add(new AssignInstruction(nbTabs, FT, FT, mustCast, n2Value, NORM_SQUARED_NAME, n2Ptr, declareN2));
+                    I.Add(new AssignInstruction(nbTabs, FT, FT, mustCast, RefGA.Multivector.ONE, INVERSE_NORM_SQUARED_NAME, n2Ptr, declareN2, "/", new RefGA.Multivector(NORM_SQUARED_NAME)));
+                }
+            }
+
+            StringBuilder setArgs = new StringBuilder();
+            for (int d = 0; d < om.DomainVectors.Length; d++)
+            {
+                string imageName = imageNames[d];
+                bool imagePtr = false;
+                bool declareImage = false;
+                I.Add(new AssignInstruction(nbTabs, rangeVectorType, FT, mustCast, imageValue[d], imageName, imagePtr, declareImage));
+
+                if (d > 0) setArgs.Append(", ");
+                if (S.OutputC()) setArgs.Append("&");
+                setArgs.Append(imageName);
+            }
+
+            string setCode;
+            if (S.OutputC())
+                setCode = FT.GetMangledName(S, om.Name) + "_setVectorImages(" + ((omPtr) ? "" : "&") + omName + ", " + setArgs.ToString() + ");";
+            else setCode = omName + ((omPtr) ? "->" : ".") + "set(" + setArgs.ToString() + ");";
+            I.Add(new VerbatimCodeInstruction(nbTabs, setCode));
+
+            return I;
+        }
+
+        /// <summary>
+        /// Divides symbolic image <paramref name="imageValue"/> by the norm squared of the versor.
+        /// Coordinates which are equal to plus or minus <paramref name="n2Value"/> become 1 or -1; the other coordinates
+        /// are multiplied by <c>INVERSE_NORM_SQUARED_NAME</c>, which holds the reciprocal of the norm squared.
+        /// Zero coordinates are not present in <paramref name="imageValue"/>, so they remain constant zeros.
+        /// </summary>
+        protected static RefGA.Multivector DivideByNormSquared(RefGA.Multivector imageValue, RefGA.Multivector n2Value)
+        {
+            RefGA.Multivector inverseN2Value = new RefGA.Multivector(INVERSE_NORM_SQUARED_NAME);
+            RefGA.Multivector result = RefGA.Multivector.ZERO;
+            foreach (RefGA.BasisBlade B in imageValue.BasisBlades)
+            {
+                RefGA.Multivector coordValue = new RefGA.Multivector(new RefGA.BasisBlade(B, 0));
+                RefGA.Multivector quotientValue;
+                if (RefGA.Multivector.Subtract(coordValue, n2Value).IsZero())
+                    quotientValue = new RefGA.Multivector(new RefGA.BasisBlade(B.bitmap, 1.0));
+                else if (RefGA.Multivector.Add(coordValue, n2Value).IsZero())
+                    quotientValue = new RefGA.Multivector(new RefGA.BasisBlade(B.bitmap, -1.0));
+                else quotientValue = RefGA.Multivector.gp(new RefGA.Multivector(B), inverseN2Value);
+                result = RefGA.Multivector.Add(result, quotientValue);
+            }
+            return result;
+        }
+
+        /// <returns>true when symbol <paramref name="name"/> occurs in the symbolic scale of one of the basis blades of <paramref name="A"/>.</returns>
+        protected static bool UsesSymbol(RefGA.Multivector A, string name)
+        {
+            foreach (RefGA.BasisBlade B in A.BasisBlades)
+            {
+                if (B.symScale == null) continue;
+                foreach (Object[] product in B.symScale)
+                    foreach (Object factor in product)
+                        if ((factor is string) && ((string)factor == name)) return true;
+            }
+            return false;
+        }
+
+        /// <summary>
+        /// Writes the declaration/definitions of 'F' to StringBuffer 'SB', taking into account parameters specified in specification 'S'.
+        /// </summary>
+        public override void WriteFunction()
+        {
+            foreach (string floatName in m_fgs.FloatNames)
+            {
+                FloatType FT = m_specification.GetFloatType(floatName);
+
+                bool computeMultivectorValue = false;
+                G25.CG.Shared.FuncArgInfo[] FAI = G25.CG.Shared.FuncArgInfo.GetAllFuncArgInfo(m_specification, m_fgs, NB_ARGS, FT, m_specification.m_GMV.Name, computeMultivectorValue);
+
+                // generate comment
+                string warningComment = (m_isUnit) ? " Only gives the correct result when the versor has a positive squared norm.\n" : "";
+                Comment comment = new Comment(
+                    m_fgs.AddUserComment("Returns the outermorphism which applies " + FAI[0].Name + " (" + FAI[0].Name + " * X * " + ((m_isUnit) ? "reverse" : "inverse") + "(" + FAI[0].Name + ")) using " + m_G25M.m_name + " metric." + warningComment));
+
+                // because of lack of overloading, function names include names of argument types
+                G25.fgs CF = G25.CG.Shared.Util.AppendTypenameToFuncName(m_specification, FT, m_fgs, FAI);
+                m_funcName[FT.type] = CF.OutputName;
+
+                string omTypeName = FT.GetMangledName(m_specification, m_om.Name);
+                string dstName = G25.fgs.RETURN_ARG_NAME;
+                bool dstPtr = m_specification.OutputC();
+                int nbTabs = 1;
+
+                // setup instructions
+                List<G25.CG.Shared.Instruction> I = new List<G25.CG.Shared.Instruction>();
+                if (!dstPtr) I.Add(new VerbatimCodeInstruction(nbTabs, omTypeName + " " + dstName + ";"));
+                I.AddRange(GetSetOMinstructions(m_specification, m_cgd, FT, m_om, m_imageValue, m_n2Value, dstName, dstPtr, nbTabs));
+
+                G25.CG.Shared.FuncArgInfo returnArgument = null;
+                if (m_specification.OutputC())
+                    returnArgument = new G25.CG.Shared.FuncArgInfo(m_specification, CF, -1, FT, m_om.Name, computeMultivectorValue);
+                else I.Add(new VerbatimCodeInstruction(nbTabs, "return " + dstName + ";"));
+
+                bool staticFunc = Functions.OutputStaticFunctions(m_specification);
+                G25.CG.Shared.Functions.WriteFunction(m_specification, m_cgd, CF, m_specification.m_inlineFunctions, staticFunc, omTypeName, CF.OutputName, returnArgument, FAI, I, comment);
+            }
+        } // end of WriteFunction
+
+        /// <summary>
+        /// Adds the names of the functions which the testing code uses to generate random versors of type <paramref name="versorSmv"/> 
+        /// to <paramref name="argTable"/> (see the <c>testVersorToOM</c> and <c>testApplyVersorBatch</c> templates).
+        /// The random versors are the exponential of a random bivector, scaled by a random scalar when they do not have to be unit.
+        /// The exponential series is evaluated by the testing code itself: the special cases of <c>exp()</c> for the general multivector
+        /// only apply when the square of the argument is a scalar.
+        /// The functions are added to the missing dependencies when required.
+        /// </summary>
+        /// <param name="S">Specification of algebra.</param>
+        /// <param name="cgd">Missing dependencies go here.</param>
+        /// <param name="FT">Floating point type.</param>
+        /// <param name="G25M">The metric.</param>
+        /// <param name="versorSmv">The versor type.</param>
+        /// <param name="argTable">The names of the functions are added to this table.</param>
+        public static void GetRandomVersorTestDependencies(Specification S, CGdata cgd, G25.FloatType FT, G25.Metric G25M, G25.SMV versorSmv, System.Collections.Hashtable argTable)
+        {
+            string gmvName = S.m_GMV.Name;
+            string defaultReturnTypeName = null;
+            argTable["randomScalarFuncName"] = G25.CG.Shared.Dependencies.GetDependency(S, cgd, "random_" + FT.type, new String[0], FT.type, FT, null);
+            argTable["randomVersorSmvFuncName"] = G25.CG.Shared.Dependencies.GetDependency(S, cgd, "random_" + versorSmv.Name, new String[0], defaultReturnTypeName, FT, null);
+            argTable["extractGradeFuncName"] = G25.CG.Shared.Dependencies.GetDependency(S, cgd, G25.CG.Shared.CANSparts.EXTRACT_GRADE, new String[] { gmvName, G25.GroupBitmapType.GROUP_BITMAP }, gmvName, FT, null);
+            argTable["addGmvFuncName"] = G25.CG.Shared.Dependencies.GetDependency(S, cgd, "add", new String[] { gmvName, gmvName }, gmvName, FT, null);
+            argTable["gpGmvFuncName"] = G25.CG.Shared.Dependencies.GetDependency(S, cgd, "gp", new String[] { gmvName, gmvName }, gmvName, FT, G25M.m_name);
+            argTable["gpGmvScalarFuncName"] = G25.CG.Shared.Dependencies.GetDependency(S, cgd, "gp", new String[] { gmvName, FT.type }, gmvName, FT, null);
+            argTable["subtractGmvFuncName"] = G25.CG.Shared.Dependencies.GetDependency(S, cgd, "subtract", new String[] { gmvName, gmvName }, gmvName, FT, null);
+            argTable["applyVersorGmvFuncName"] = G25.CG.Shared.Dependencies.GetDependency(S, cgd, "applyVersor", new String[] { gmvName, gmvName }, defaultReturnTypeName, FT, G25M.m_name);
+        }
+
+        // used for testing:
+        protected Dictionary<string, System.Collections.Hashtable> m_testArgTable = new Dictionary<string, System.Collections.Hashtable>();
+
+        /// <summary>
+        /// This function checks the dependencies for the _testing_ code of this function. If dependencies are
+        /// missing, the function adds the required functions (this is done simply by asking for them . . .).
+        /// </summary>
+        public override void CheckTestingDepencies()
+        {
+            if (!(m_om is G25.GOM)) return; // only the general outermorphism can be applied to the general multivector
+
+            foreach (string floatName in m_fgs.FloatNames)
+            {
+                FloatType FT = m_specification.GetFloatType(floatName);
+
+                string gmvName = m_specification.m_GMV.Name;
+                System.Collections.Hashtable argTable = new System.Collections.Hashtable();
+                GetRandomVersorTestDependencies(m_specification, m_cgd, FT, m_G25M, m_versorSmv, argTable);
+                argTable["randomBladeFuncName"] = G25.CG.Shared.Dependencies.GetDependency(m_specification, m_cgd, "random_blade", new String[0], gmvName, FT, null);
+                argTable["applyOMgmvFuncName"] = G25.CG.Shared.Dependencies.GetDependency(m_specification, m_cgd, "applyOM", new String[] { m_om.Name, gmvName }, gmvName, FT, null);
+                m_testArgTable[FT.type] = argTable;
+            }
+        }
+
+        /// <summary>
+        /// Writes the testing function for 'F' to 'm_defSB'.
+        /// The generated function returns success (1) or failure (0).
+        ///
+        /// The test (<c>testVersorToOM</c> template) checks that applying the outermorphism to random blades
+        /// gives the same result as applying the versor to them. Only when the return type is the general outermorphism.
+        /// </summary>
+        /// <returns>The list of name name of the int() function which tests the function.</returns>
+        public override List<string> WriteTestFunction()
+        {
+            StringBuilder defSB = (m_specification.m_inlineFunctions) ? m_cgd.m_inlineDefSB : m_cgd.m_defSB;
+
+            List<string> testFuncNames = new List<string>();
+            if (!(m_om is G25.GOM)) return testFuncNames;
+
+            foreach (string floatName in m_fgs.FloatNames)
+            {
+                FloatType FT = m_specification.GetFloatType(floatName);
+
+                string testFuncName = Util.GetTestingFunctionName(m_specification, m_cgd, m_funcName[FT.type]);
+                testFuncNames.Add(testFuncName);
+
+                System.Collections.Hashtable argTable = m_testArgTable[FT.type];
+                argTable["S"] = m_specification;
+                argTable["FT"] = FT;
+                argTable["gmvName"] = FT.GetMangledName(m_specification, m_specification.m_GMV.Name);
+                argTable["omName"] = FT.GetMangledName(m_specification, m_om.Name);
+                argTable["versorType"] = m_versorSmv;
+                argTable["versorName"] = FT.GetMangledName(m_specification, m_versorSmv.Name);
+                argTable["unit"] = m_isUnit;
+                argTable["testFuncName"] = testFuncName;
+                argTable["targetFuncName"] = m_funcName[FT.type];
+                m_cgd.m_cog.EmitTemplate(defSB, "testVersorToOM", argTable);
+            }
+
+            return testFuncNames;
+        } // end of WriteTestFunction()
+
+    } // end of class VersorToOM
+} // end of namespace G25.CG.Shared.Func
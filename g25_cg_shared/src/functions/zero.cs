@@ -38,7 +38,6 @@ namespace G25.CG.Shared.Func
         protected const int NB_ARGS = 2;
         protected bool m_gmvFunc; ///< is this a function over GMVs?
         protected G25.SMV m_smv = null; ///< if function over SMV, type goes here
-        protected Dictionary<string, string> m_funcName = new Dictionary<string, string>();  ///< generated function name with full mangling, etc
 
         /// <summary>
         /// Checks if this FunctionGenerator can implement a certain function.
@@ -0,0 +1,101 @@
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+// Copyright 2008-2010, Daniel Fontijne, University of Amsterdam -- fontijne@science.uva.nl
+
+using System;
+using System.Collections.Generic;
+using System.Text;
+
+namespace G25.CG.Shared
+{
+    /// <summary>
+    /// Generates the per-function instrumentation code (see Specification.m_instrumentation).
+    ///
+    /// Each instrumented function gets a static <c>InstrumentationSite</c> and an <c>InstrumentationScope</c>
+    /// which counts the call (and times it, when <c>NS_INSTRUMENTATION_TIMING</c> is defined).
+    /// For functions over general multivectors, the group usage of the first two general multivector
+    /// arguments is recorded as well. All code is guarded by <c>#ifdef NS_INSTRUMENTATION</c>, so it
+    /// costs nothing unless that macro is defined. The support code is in the <c>InstrumentationHeader</c>
+    /// and <c>InstrumentationSource</c> templates.
+    /// </summary>
+    public static class Instrumentation
+    {
+        /// <summary>
+        /// Number of general multivector arguments whose group usage is recorded.
+        /// The group usages are packed into a single 32 bit key, 16 bits each.
+        /// </summary>
+        public const int MAX_NB_GU_ARGS = 2;
+
+        /// <returns>Name of the macro which enables instrumentation (e.g., <c>C3GA_INSTRUMENTATION</c>).</returns>
+        public static string GetMacroName(Specification S)
+        {
+            return S.m_namespace.ToUpper() + "_INSTRUMENTATION";
+        }
+
+        /// <summary>
+        /// Returns the instruction which instruments function <paramref name="functionName"/>.
+        /// Must be the first instruction of the function.
+        /// </summary>
+        /// <param name="S">Specification of algebra.</param>
+        /// <param name="functionName">Name of the function (used in the report).</param>
+        /// <param name="FT">Floating point type of the function (can be null).</param>
+        /// <param name="FAI">Arguments of the function.</param>
+        /// <returns>The instrumentation code, or a NOPinstruction when instrumentation is disabled.</returns>
+        public static Instruction GetInstrumentationInstruction(Specification S, string functionName, FloatType FT, FuncArgInfo[] FAI)
+        {
+            if ((!S.OutputCpp()) || (!S.m_instrumentation)) return new NOPinstruction();
+
+            // name shown in report, e.g. "gp(mv, normalizedPoint)"
+            StringBuilder displayName = new StringBuilder(functionName + "(");
+            StringBuilder guCode = new StringBuilder();
+            int nbGuArgs = 0;
+            int nbArgs = (FAI == null) ? 0 : FAI.Length;
+            for (int i = 0; i < nbArgs; i++)
+            {
+                if (i > 0) displayName.Append(", ");
+                displayName.Append(FAI[i].TypeName);
+
+                if (FAI[i].IsGMV() && (!FAI[i].Array) && (nbGuArgs < MAX_NB_GU_ARGS))
+                {
+                    if (nbGuArgs > 0) guCode.Append(" | ");
+                    guCode.Append("((unsigned int)" + FAI[i].Name + ((FAI[i].Pointer) ? "->" : ".") + "gu() << " + (16 * nbGuArgs) + ")");
+                    nbGuArgs++;
+                }
+            }
+            displayName.Append(")");
+
+            string floatTypeName = (FT == null) ? "" : FT.type;
+
+            StringBuilder SB = new StringBuilder();
+            SB.AppendLine("#ifdef " + GetMacroName(S));
+            SB.AppendLine("\tstatic InstrumentationSite instrumentationSite = {" + Util.StringToCode(displayName.ToString()) + ", " + Util.StringToCode(floatTypeName) + ", " + nbGuArgs + "};");
+            SB.AppendLine("\tInstrumentationScope instrumentationScope(instrumentationSite" + ((nbGuArgs > 0) ? (", " + guCode.ToString()) : "") + ");");
+            SB.Append("#endif");
+
+            int nbTabs = 0; // preprocessor directives go in the first column
+            return new VerbatimCodeInstruction(nbTabs, SB.ToString());
+        }
+
+        /// <summary>
+        /// Writes the instrumentation code for function <paramref name="functionName"/> to <paramref name="SB"/>.
+        /// Used by functions which are not written as a list of instructions.
+        /// </summary>
+        public static void WriteInstrumentationCode(StringBuilder SB, Specification S, CGdata cgd, string functionName, FloatType FT, FuncArgInfo[] FAI)
+        {
+            if ((!S.OutputCpp()) || (!S.m_instrumentation)) return;
+            GetInstrumentationInstruction(S, functionName, FT, FAI).Write(SB, S, cgd);
+        }
+    } // end of class Instrumentation
+} // end of namespace G25.CG.Shared
@@ -202,6 +202,96 @@ namespace G25.CG.Shared
             return rangeVectorType;
         }
 
+        /// <summary>
+        /// Name of the member variable of a lazy GOM which holds the bitmap of up-to-date grade matrices (bit g for grade g).
+        /// </summary>
+        public const string VALID_GRADES_NAME = "m_validGrades";
+
+        /// <returns>The value of VALID_GRADES_NAME when all grade matrices of <paramref name="om"/> are up to date.</returns>
+        public static int GetAllGradesValidBitmap(G25.OM om)
+        {
+            return (1 << om.Domain.Length) - 1;
+        }
+
+        /// <summary>
+        /// Bit of VALID_GRADES_NAME which is set while a thread computes the missing grade matrices of a lazy GOM.
+        /// It guards the computation such that it is done only once when the GOM is shared between threads.
+        /// </summary>
+        public const int COMPUTING_GRADES_BIT = 1 << 30;
+
+        /// <returns>The value of VALID_GRADES_NAME when only the grade 0 and grade 1 matrices are up to date.</returns>
+        public static int GetVectorGradeValidBitmap()
+        {
+            return (1 << 0) | (1 << 1);
+        }
+
+        /// <returns>true when <paramref name="om"/> is a general outermorphism with lazily computed grade matrices.</returns>
+        public static bool IsLazyGom(G25.OM om)
+        {
+            return (om is G25.GOM) && om.Lazy;
+        }
+
+        /// <summary>
+        /// Returns code which makes sure that the matrices of grade 1 up to <paramref name="grade"/> of outermorphism
+        /// <paramref name="omName"/> are up to date. Returns "" when the outermorphism is not lazy.
+        /// </summary>
+        public static string GetValidateGradeCode(Specification S, G25.OM om, string omName, bool omPtr, int grade)
+        {
+            if ((!IsLazyGom(om)) || (grade < 2)) return "";
+            return omName + ((omPtr) ? "->" : ".") + "validateGrade(" + grade + ");";
+        }
+
+        /// <summary>
+        /// Returns the instruction which makes sure that the matrices of outermorphism <paramref name="omName"/> required to apply
+        /// it to <paramref name="inputValue"/> are up to date (see GetValidateGradeCode()). Returns a NOPinstruction when
+        /// nothing has to be done.
+        /// </summary>
+        public static Instruction GetValidateGradeInstruction(Specification S, G25.OM om, string omName, bool omPtr, RefGA.Multivector inputValue, int nbTabs)
+        {
+            int maxGrade = 0;
+            foreach (RefGA.BasisBlade B in inputValue.BasisBlades)
+                maxGrade = Math.Max(maxGrade, B.Grade());
+            string code = GetValidateGradeCode(S, om, omName, omPtr, maxGrade);
+            if (code.Length == 0) return new NOPinstruction();
+            else return new VerbatimCodeInstruction(nbTabs, code);
+        }
+
+        /// <summary>
+        /// Returns code which sets the padding coordinates of the aligned layout of <paramref name="gom"/> to zero
+        /// (see G25.OM.SetAlignedLayout()). Returns "" when there is no padding.
+        /// </summary>
+        public static string GetClearPaddingCode(Specification S, FloatType FT, G25.GOM gom)
+        {
+            string matrixStr = (S.OutputC()) ? G25.fgs.RETURN_ARG_NAME + "->m" : "m_m";
+            return GetClearPaddingCode(S, FT, gom, matrixStr);
+        }
+
+        /// <summary>
+        /// Returns code which sets the padding coordinates of the aligned layout of <paramref name="gom"/> to zero.
+        /// The grade 'g' matrix is accessed as <paramref name="matrixStr"/> + g (e.g., <c>"_dst.m_m"</c>).
+        /// Returns "" when there is no padding.
+        /// </summary>
+        public static string GetClearPaddingCode(Specification S, FloatType FT, G25.GOM gom, string matrixStr)
+        {
+            StringBuilder SB = new StringBuilder();
+            int cnt = 0;
+            for (int g = 1; g < gom.Domain.Length; g++)
+            {
+                for (int d = 0; d < gom.DomainForGrade(g).Length; d++)
+                {
+                    for (int r = gom.RangeForGrade(g).Length; r < gom.ColumnStride(g); r++)
+                    {
+                        if ((cnt > 0) && ((cnt % 8) == 0)) SB.Append("\n\t");
+                        SB.Append(matrixStr + g + "[" + gom.getCoordinateIndex(g, d, r) + "] = ");
+                        cnt++;
+                    }
+                }
+            }
+            if (cnt == 0) return "";
+            SB.Append(FT.DoubleToString(S, 0.0) + ";");
+            return SB.ToString();
+        }
+
         /// <summary>
         /// Returns a dictionary (value -> coordinateAccessString) that can be used to initialize a general OM to identity.
         /// 
@@ -225,7 +315,7 @@ namespace G25.CG.Shared
                         if (D.bitmap == R.bitmap)
                         {
                             double val = D.scale / R.scale;
-                            string coordStr = refStr + matrixName + g + "[" + (r * S.m_GOM.Domain[g].Length + d) + "]";
+                            string coordStr = refStr + matrixName + g + "[" + S.m_GOM.getCoordinateIndex(g, d, r) + "]";
                             if (!nonZero.ContainsKey(val)) nonZero[val] = new List<string>();
                             nonZero[val].Add(coordStr);
                             continue; // no need to search other blades in range
@@ -334,6 +424,18 @@ namespace G25.CG.Shared
                 string dstName = (S.OutputC()) ? G25.fgs.RETURN_ARG_NAME : SmvUtil.THIS;
                 bool dstPtr = S.OutputCppOrC();
                 bool declareDst = false;
+
+                // clear the padding of the aligned layout, such that the vectorized kernels never read garbage
+                if (gom.AlignedLayout)
+                {
+                    string padCode = GetClearPaddingCode(S, FT, gom);
+                    if (padCode.Length > 0)
+                    {
+                        mainI.Add(new G25.CG.Shared.CommentInstruction(nbTabs, "Clear padding of aligned matrices"));
+                        mainI.Add(new G25.CG.Shared.VerbatimCodeInstruction(nbTabs, padCode));
+                    }
+                }
+
                 for (int g = 1; g < gom.Domain.Length; g++)
                 {
 
@@ -347,10 +449,14 @@ namespace G25.CG.Shared
                         {
                             bladeI[domainBlade.bitmap] = new List<G25.CG.Shared.Instruction>();
 
-                            string funcCallCode = funcNames[g] + "_" + d + "(";
-                            if (S.OutputC()) funcCallCode += G25.fgs.RETURN_ARG_NAME;
-                            funcCallCode += ");";
-                            mainI.Add(new G25.CG.Shared.VerbatimCodeInstruction(nbTabs, funcCallCode));
+                            // lazy GOM: the higher grades are computed on first use (see validateGrade())
+                            if (!gom.Lazy)
+                            {
+                                string funcCallCode = funcNames[g] + "_" + d + "(";
+                                if (S.OutputC()) funcCallCode += G25.fgs.RETURN_ARG_NAME;
+                                funcCallCode += ");";
+                                mainI.Add(new G25.CG.Shared.VerbatimCodeInstruction(nbTabs, funcCallCode));
+                            }
                         }
 
                         // follow the plan
@@ -368,6 +474,9 @@ namespace G25.CG.Shared
                         symbolicBBvalues[domainBlade.bitmap] = G25.CG.Shared.Symbolic.SMVtoSymbolicMultivector(S, smvOM, dstName, dstPtr);
                     }
                 }
+
+                if (gom.Lazy)
+                    mainI.Add(new G25.CG.Shared.VerbatimCodeInstruction(nbTabs, VALID_GRADES_NAME + " = " + GetVectorGradeValidBitmap() + ";"));
             }
 
             // output grade > 1 functions
@@ -505,6 +614,11 @@ namespace G25.CG.Shared
                     }
                 }
 
+                // a lazy source must be up to date before it is copied
+                string validateCode = GetValidateGradeCode(S, srcOm, "src", S.OutputC(), srcOm.Domain.Length - 1);
+                if (validateCode.Length > 0)
+                    defSB.AppendLine("\t" + validateCode);
+
                 // append copy statements
                 defSB.Append(copySB);
 
@@ -527,6 +641,15 @@ namespace G25.CG.Shared
                     defSB.AppendLine(FT.DoubleToString(S, 0.0) + ";");
                 }
 
+                // padding and valid grades of a general outermorphism destination (aligned and lazy GOMs are C++ only, so 'dst' is 'this')
+                if ((dstOm is G25.GOM) && dstOm.AlignedLayout)
+                {
+                    string padCode = GetClearPaddingCode(S, FT, (G25.GOM)dstOm);
+                    if (padCode.Length > 0) defSB.AppendLine("\t" + padCode);
+                }
+                if (IsLazyGom(dstOm))
+                    defSB.AppendLine("\t" + VALID_GRADES_NAME + " = " + GetAllGradesValidBitmap(dstOm) + ";");
+
                 defSB.AppendLine("}");
             }
         }
@@ -1448,6 +1448,7 @@ namespace G25.CG.Shared
         /// 
         /// The generated function first compute the norm squared using the requested metric,
         /// and then divides the input multivector by it.
+        /// For C and C++, unit and versorInverse are generated by GetVersorDivCodeCppOrC().
         /// 
         /// The returned code is only the body. The function declaration is not included.
         /// </summary>
@@ -1469,23 +1470,21 @@ namespace G25.CG.Shared
         private static string GetDivCodeCppOrC(Specification S, G25.CG.Shared.CGdata cgd, G25.FloatType FT,
             G25.Metric M, G25.CG.Shared.FuncArgInfo[] FAI, string resultName, DIVCODETYPE funcType)
         {
+            if ((funcType == DIVCODETYPE.UNIT) || (funcType == DIVCODETYPE.VERSOR_INVERSE))
+            {
+                bool inPlace = false;
+                return GetVersorDivCodeCppOrC(S, cgd, FT, M, FAI[0].Name, resultName, funcType, inPlace);
+            }
+
             G25.GMV gmv = S.m_GMV;
 
             StringBuilder SB = new StringBuilder();
 
-            string normFuncName = G25.CG.Shared.Dependencies.GetDependency(S, cgd, (funcType == DIVCODETYPE.UNIT) ? "norm" : "norm2", new String[] { gmv.Name }, FT, M.m_name);
-            string normVarName = (funcType == DIVCODETYPE.UNIT) ? "n" : "n2";
-
             string agu = (S.OutputC()) ? FAI[0].Name + "->gu" : FAI[0].Name + ".gu()";
             string ac = (S.OutputC()) ? FAI[0].Name + "->c" : FAI[0].Name + ".getC()";
             string resultCoordPtr = (S.OutputC()) ? resultName + "->c" : "c";
 
             SB.AppendLine("int idx = 0;");
-            if ((funcType == DIVCODETYPE.UNIT) || (funcType == DIVCODETYPE.VERSOR_INVERSE))
-            {
-                // compute norm
-                SB.AppendLine(FT.type + " " + normVarName + " = " + normFuncName + G25.CG.Shared.CANSparts.RETURNS_SCALAR + "(" + FAI[0].Name + ");");
-            }
 
             // copy group usage
             if (S.OutputC())
@@ -1498,8 +1497,7 @@ namespace G25.CG.Shared
                 SB.AppendLine(FT.type + " c[" + (1 << S.m_dimension) + "];");
             }
 
-            // for each group present, copy and scale (for versor inverse, modulate with reverse)
-            // for each group, test if present
+            // for each group present, copy and divide
             int nbGroups = gmv.NbGroups;
             for (int g = 0; g < nbGroups; g++)
             {
@@ -1508,17 +1506,8 @@ namespace G25.CG.Shared
                 // get func name
                 string funcName = GetCopyDivPartFunctionName(S, FT, g);
 
-                // get multiplier, normVarName string (depends on whether this is unit or versor inverse)
-                string normString;
-                if ((funcType == DIVCODETYPE.UNIT) || (funcType == DIVCODETYPE.VERSOR_INVERSE))
-                {
-                    double m = (funcType == DIVCODETYPE.UNIT) ? 1 : gmv.Group(g)[0].Reverse().scale / gmv.Group(g)[0].scale;
-                    normString = ((m < 0) ? "-" : "") + normVarName;
-                }
-                else normString = FAI[1].Name;
-
                 SB.AppendLine("if (" + agu + " & " + (1 << g) + ") {");
-                SB.AppendLine("\t" + funcName + "(" + ac + " + idx, " + resultCoordPtr + " + idx, " + normString + ");");
+                SB.AppendLine("\t" + funcName + "(" + ac + " + idx, " + resultCoordPtr + " + idx, " + FAI[1].Name + ");");
                 if (g < (nbGroups - 1)) SB.AppendLine("\tidx += " + gmv.Group(g).Length + ";");
                 SB.AppendLine("}");
             }
@@ -1532,6 +1521,136 @@ namespace G25.CG.Shared
             return SB.ToString();
         } // GetDivCodeCppOrC()
 
+        /// <summary>
+        /// Returns true when the norm squared of the general multivector can be computed group by group,
+        /// i.e., when metric <c>M</c> does not relate the basis blades of different groups.
+        /// </summary>
+        public static bool IsGroupSeparableNorm(Specification S, G25.Metric M)
+        {
+            G25.GMV gmv = S.m_GMV;
+            bool ptr = false;
+            int allGroups = -1;
+            RefGA.Multivector[] A = G25.CG.Shared.Symbolic.GMVtoSymbolicMultivector(S, gmv, "a", ptr, allGroups);
+            RefGA.Multivector[] B = G25.CG.Shared.Symbolic.GMVtoSymbolicMultivector(S, gmv, "b", ptr, allGroups);
+            for (int g1 = 0; g1 < gmv.NbGroups; g1++)
+            {
+                for (int g2 = g1 + 1; g2 < gmv.NbGroups; g2++)
+                {
+                    RefGA.Multivector value = G25.CG.Shared.ProductCache.gp(RefGA.Multivector.Reverse(A[g1]), B[g2], M.m_metric).ExtractGrade(0);
+                    if (M.m_round) value = value.Round(1e-14);
+                    if (!value.IsZero()) return false;
+                }
+            }
+            return true;
+        }
+
+        /// <summary>
+        /// Returns the code for unit or versorInverse of a general multivector in C or C++ (see GetDivCode()).
+        /// 
+        /// When the metric allows (see IsGroupSeparableNorm()), the norm squared is computed inline, as the sum of the
+        /// squared coordinates of each group weighted by the signs of the metric. Otherwise the <c>norm2()</c> function is called.
+        /// The reciprocal of the norm (squared) is computed once, after which the reverse and the scaling are applied 
+        /// in a single pass over the coordinates.
+        /// 
+        /// The returned code is only the body. The function declaration is not included.
+        /// </summary>
+        /// <param name="S">Specification of algebra (used for output language).</param>
+        /// <param name="cgd">Used to resolve dependecy (<c>norm2()</c> function).</param>
+        /// <param name="FT">Floating point type.</param>
+        /// <param name="M">The metric.</param>
+        /// <param name="argName">Name of the general multivector argument.</param>
+        /// <param name="resultName">Name of variable where the result goes (C only, not used when <paramref name="inPlace"/>).</param>
+        /// <param name="funcType">What type of function (UNIT or VERSOR_INVERSE)</param>
+        /// <param name="inPlace">When true, the result overwrites the argument (which must not be const).</param>
+        /// <returns>code for the requested function.</returns>
+        public static string GetVersorDivCodeCppOrC(Specification S, G25.CG.Shared.CGdata cgd, G25.FloatType FT,
+            G25.Metric M, string argName, string resultName, DIVCODETYPE funcType, bool inPlace)
+        {
+            G25.GMV gmv = S.m_GMV;
+            int nbGroups = gmv.NbGroups;
+            bool unit = (funcType == DIVCODETYPE.UNIT);
+
+            StringBuilder SB = new StringBuilder();
+
+            string agu = (S.OutputC()) ? argName + "->gu" : argName + ".gu()";
+            string argC = (S.OutputC()) ? argName + "->c" : ((inPlace) ? argName + ".m_c" : argName + ".getC()");
+
+            SB.AppendLine("int gu = " + agu + ";");
+            SB.AppendLine("const " + FT.type + " *ac = " + argC + ";");
+            if (inPlace) SB.AppendLine(FT.type + " *cc = " + argC + ";");
+            else if (S.OutputC())
+            {
+                SB.AppendLine(FT.type + " *cc = " + resultName + "->c;");
+                SB.AppendLine(resultName + "->gu = gu;");
+            }
+            else 
+            {
+                SB.AppendLine(FT.type + " c[" + (1 << S.m_dimension) + "];");
+                SB.AppendLine(FT.type + " *cc = c;");
+            }
+            SB.AppendLine(FT.type + " n2 = " + FT.DoubleToString(S, 0.0) + ", s;");
+
+            // norm squared
+            if (IsGroupSeparableNorm(S, M))
+            {
+                bool ptr = false;
+                int allGroups = -1;
+                bool mustCast = false;
+                bool writeZeros = true;
+                RefGA.BasisBlade[] BL = new RefGA.BasisBlade[] { RefGA.BasisBlade.ONE };
+                RefGA.Multivector[] A = G25.CG.Shared.Symbolic.GMVtoSymbolicMultivector(S, gmv, "ac", ptr, allGroups);
+                for (int g = 0; g < nbGroups; g++)
+                {
+                    RefGA.Multivector n2Value = G25.CG.Shared.ProductCache.gp(RefGA.Multivector.Reverse(A[g]), A[g], M.m_metric).ExtractGrade(0);
+                    if (M.m_round) n2Value = n2Value.Round(1e-14);
+
+                    SB.AppendLine("if (gu & " + (1 << g) + ") { /* group " + g + " (grade " + gmv.Group(g)[0].Grade() + ") */");
+                    if (!n2Value.IsZero())
+                        SB.AppendLine("\tn2 += " + CodeUtil.GetAssignmentStrings(S, FT, mustCast, BL, n2Value, writeZeros)[0] + ";");
+                    if (g < (nbGroups - 1)) SB.AppendLine("\tac += " + gmv.Group(g).Length + ";");
+                    SB.AppendLine("}");
+                }
+                SB.AppendLine("ac = " + argC + ";");
+            }
+            else
+            {
+                string norm2FuncName = G25.CG.Shared.Dependencies.GetDependency(S, cgd, "norm2", new String[] { gmv.Name }, FT, M.m_name);
+                SB.AppendLine("n2 = " + norm2FuncName + G25.CG.Shared.CANSparts.RETURNS_SCALAR + "(" + argName + ");");
+            }
+
+            // reciprocal of norm (squared)
+            if (unit)
+            {
+                string sqrtFuncName = G25.CG.Shared.CodeUtil.OpNameToLangString(S, FT, RefGA.Symbolic.UnaryScalarOp.SQRT);
+                string n2Str = (M.m_metric.IsPositiveDefinite()) ? "n2" : "((n2 < " + FT.DoubleToString(S, 0.0) + ") ? -n2 : n2)";
+                SB.AppendLine("s = " + FT.DoubleToString(S, 1.0) + " / " + sqrtFuncName + "(" + n2Str + ");");
+            }
+            else SB.AppendLine("s = " + FT.DoubleToString(S, 1.0) + " / n2;");
+
+            // reverse and scale in one pass
+            for (int g = 0; g < nbGroups; g++)
+            {
+                double m = (unit) ? 1 : gmv.Group(g)[0].Reverse().scale / gmv.Group(g)[0].scale;
+                string sStr = ((m < 0) ? "-" : "") + "s";
+
+                SB.AppendLine("if (gu & " + (1 << g) + ") {");
+                for (int i = 0; i < gmv.Group(g).Length; i++)
+                    SB.AppendLine("\tcc[" + i + "] = " + sStr + " * ac[" + i + "];");
+                if (g < (nbGroups - 1))
+                {
+                    SB.AppendLine("\tac += " + gmv.Group(g).Length + ";");
+                    SB.AppendLine("\tcc += " + gmv.Group(g).Length + ";");
+                }
+                SB.AppendLine("}");
+            }
+
+            // return result
+            if ((!inPlace) && S.OutputCpp())
+                SB.AppendLine("return " + FT.GetMangledName(S, gmv.Name) + "(gu, c);");
+
+            return SB.ToString();
+        } // GetVersorDivCodeCppOrC()
+
         private static string GetDivCodeCSharpOrJava(Specification S, G25.CG.Shared.CGdata cgd, G25.FloatType FT,
             G25.Metric M, G25.CG.Shared.FuncArgInfo[] FAI, string resultName, DIVCODETYPE funcType)
         {
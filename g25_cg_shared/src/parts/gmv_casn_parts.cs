@@ -326,6 +326,52 @@ namespace G25.CG.Shared
             return funcName;
         }
 
+        /// <summary>
+        /// Writes an in-place unit or versor inverse function for general multivectors (C and C++ only).
+        /// The function overwrites its argument, so no new multivector is constructed (see CANSparts.GetVersorDivCodeCppOrC()).
+        /// </summary>
+        /// <param name="S"></param>
+        /// <param name="cgd"></param>
+        /// <param name="FT"></param>
+        /// <param name="M"></param>
+        /// <param name="FAI"></param>
+        /// <param name="F"></param>
+        /// <param name="comment"></param>
+        /// <param name="funcType"> UNIT or VERSOR_INVERSE</param>
+        public static string WriteDivInPlaceFunction(Specification S, G25.CG.Shared.CGdata cgd, FloatType FT, G25.Metric M,
+            G25.CG.Shared.FuncArgInfo[] FAI, G25.fgs F, Comment comment, G25.CG.Shared.CANSparts.DIVCODETYPE funcType)
+        {
+            // setup instructions
+            System.Collections.Generic.List<G25.CG.Shared.Instruction> I = new System.Collections.Generic.List<G25.CG.Shared.Instruction>();
+            int nbTabs = 1;
+
+            // write this function:
+            bool inPlace = true;
+            string code = G25.CG.Shared.CANSparts.GetVersorDivCodeCppOrC(S, cgd, FT, M, FAI[0].Name, null, funcType, inPlace);
+
+            // add one instruction (verbatim code)
+            I.Add(new G25.CG.Shared.VerbatimCodeInstruction(nbTabs, code));
+
+            // because of lack of overloading, function names include names of argument types
+            G25.fgs CF = G25.CG.Shared.Util.AppendTypenameToFuncName(S, FT, F, FAI);
+            string funcName = CF.OutputName;
+
+            string funcDecl = "void " + funcName + "(" + FT.GetMangledName(S, S.m_GMV.Name) + ((S.OutputC()) ? " *" : " &") + FAI[0].Name + ")";
+
+            // write declaration
+            comment.Write(cgd.m_declSB, S, 0);
+            cgd.m_declSB.AppendLine(funcDecl + ";");
+
+            // write definition (never inline GMV functions)
+            cgd.m_defSB.AppendLine(funcDecl + " {");
+            G25.CG.Shared.Instrumentation.WriteInstrumentationCode(cgd.m_defSB, S, cgd, funcName, FT, FAI);
+            foreach (G25.CG.Shared.Instruction instr in I)
+                instr.Write(cgd.m_defSB, S, cgd);
+            cgd.m_defSB.AppendLine("}");
+
+            return funcName;
+        }
+
         /// <summary>
         /// Writes a scale-and-add-scalar function (scalar * gmv + scalar)
         /// based on CASN parts code.
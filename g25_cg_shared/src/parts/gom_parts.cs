@@ -237,7 +237,15 @@ namespace G25.CG.Shared
 
                 SB.AppendLine("if (" + bgu + " & " + (1 << srcGroup) + ") {");
                 int dstGradeSizeAccumulator = 0;
-                for (int dstGroup = 0; dstGroup < nbGroups; dstGroup++)
+                string validateCode = OMinit.GetValidateGradeCode(S, S.m_GOM, FAI[0].Name, FAI[0].Pointer, srcGrade);
+                if (validateCode.Length > 0)
+                    SB.AppendLine("\t" + validateCode);
+                if (CanUseApplyGradeKernel(S, srcGroup))
+                {
+                    // aligned layout: use the vectorized kernel of the OM class
+                    SB.AppendLine("\t" + FAI[0].Name + ((FAI[0].Pointer) ? "->" : ".") + "applyGrade" + srcGrade + "(" + bc + " + idxB, c + idxC, 1);");
+                }
+                else for (int dstGroup = 0; dstGroup < nbGroups; dstGroup++)
                 {
                     string funcName = GetGomPartFunctionName(S, FT, srcGroup, dstGroup);
                     Tuple<string, string> key = new Tuple<string, string>(FT.type, funcName);
@@ -270,6 +278,31 @@ namespace G25.CG.Shared
             return SB.ToString();
         } // end of GetApplyGomCodeCppOrC
 
+        /// <summary>
+        /// Returns true when the <c>applyGrade</c> kernel of the aligned GOM layout (see G25.OM.SetAlignedLayout())
+        /// can be used to apply the GOM to group <paramref name="group"/> of the GMV. This requires C++ output,
+        /// a GMV that is grouped by grade, and domain and range blades which are identical to those of the group.
+        /// </summary>
+        public static bool CanUseApplyGradeKernel(Specification S, int group)
+        {
+            G25.GMV gmv = S.m_GMV;
+            G25.GOM gom = S.m_GOM;
+            if ((!S.OutputCpp()) || (!gom.AlignedLayout) || (!gmv.IsGroupedByGrade(S.m_dimension))) return false;
+
+            RefGA.BasisBlade[] B = gmv.Group(group);
+            int g = B[0].Grade();
+            if (g == 0) return false;
+            RefGA.BasisBlade[] D = gom.DomainForGrade(g);
+            RefGA.BasisBlade[] R = gom.RangeForGrade(g);
+            if ((B.Length != D.Length) || (B.Length != R.Length)) return false;
+            for (int i = 0; i < B.Length; i++)
+            {
+                if ((B[i].bitmap != D[i].bitmap) || (B[i].scale != D[i].scale)) return false;
+                if ((B[i].bitmap != R[i].bitmap) || (B[i].scale != R[i].scale)) return false;
+            }
+            return true;
+        }
+
         private static string GetApplyGomCodeCSharpOrJava(Specification S, G25.CG.Shared.CGdata cgd, G25.FloatType FT,
             G25.CG.Shared.FuncArgInfo[] FAI, string resultName)
         {
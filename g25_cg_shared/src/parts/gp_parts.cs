@@ -195,7 +195,7 @@ namespace G25.CG.Shared
                             RefGA.Multivector M3 = null;
                             if (S.m_gmvCodeGeneration == GMV_CODE.EXPAND)
                             {
-                                M3 = RefGA.Multivector.gp(M1[g1], M2[g2], M.m_metric);
+                                M3 = G25.CG.Shared.ProductCache.gp(M1[g1], M2[g2], M.m_metric);
                                 // round value if required by metric
                                 if (M.m_round) M3 = M3.Round(1e-14);
                             }
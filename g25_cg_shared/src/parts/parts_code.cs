@@ -58,16 +58,28 @@ namespace G25.CG.Shared
             G25.CG.Shared.Threads.StartThreadArray(T);
             G25.CG.Shared.Threads.JoinThreadArray(T);
 
-            // merge declarations and definitions go into cgd.m_declSB or cgd.m_defSB, depending on the language
-            for (int i = 0; i < NB_PARTS_CODE; i++)
+            // when the source is split over multiple files, the declarations go into the internal header
+            if ((cgd.m_sourceShards != null) && (!declOnly))
             {
-//                        StringBuilder SB = (S.OutputC()) ? cgd.m_defSB : cgd.m_declSB;
-                StringBuilder SB = cgd.m_defSB;
-                SB.Append(tmpCgd[i].m_declSB);
+                for (int i = 0; i < NB_PARTS_CODE; i++)
+                {
+                    cgd.m_sourceShards.AppendDeclarations(tmpCgd[i].m_declSB);
+                    cgd.m_sourceShards.AppendDefinitions(SourceShards.PARTS, tmpCgd[i].m_defSB);
+                }
             }
-            if (!declOnly) // if only declarations are wanted, don't copy the definitions
+            else
+            {
+                // merge declarations and definitions go into cgd.m_declSB or cgd.m_defSB, depending on the language
                 for (int i = 0; i < NB_PARTS_CODE; i++)
-                    cgd.m_defSB.Append(tmpCgd[i].m_defSB);
+                {
+//                        StringBuilder SB = (S.OutputC()) ? cgd.m_defSB : cgd.m_declSB;
+                    StringBuilder SB = cgd.m_defSB;
+                    SB.Append(tmpCgd[i].m_declSB);
+                }
+                if (!declOnly) // if only declarations are wanted, don't copy the definitions
+                    for (int i = 0; i < NB_PARTS_CODE; i++)
+                        cgd.m_defSB.Append(tmpCgd[i].m_defSB);
+            }
 
             // copy names of part functions from appropriate temporary cgd
             cgd.m_gmvGPpartFuncNames = tmpCgd[0].m_gmvGPpartFuncNames; // this assumes [0] = GP
@@ -0,0 +1,434 @@
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+// Copyright 2008-2010, Daniel Fontijne, University of Amsterdam -- fontijne@science.uva.nl
+
+using System;
+using System.Collections.Generic;
+using System.Text;
+
+namespace G25.CG.Shared
+{
+    /// <summary>
+    /// Thread-safe cache of symbolic products (geometric, outer and inner products).
+    ///
+    /// Many function generators compute the same symbolic products. For example the geometric product
+    /// of two <c>normalizedPoint</c>s is needed by <c>gp</c>, <c>applyVersor</c>, <c>versorInverse</c>, etc.
+    /// All BaseFunctionGenerator subclasses (and the parts code) share this cache, such that
+    /// each product is computed only once per run of the code generator.
+    ///
+    /// The names of the symbolic variables do not matter: before lookup, the String factors of both operands are 
+    /// replaced by placeholders (see Renaming), so <c>gp(a, b)</c> and <c>gp(x, y)</c> of the same types share one entry.
+    /// The cache is keyed on the remaining symbolic structure of both operands (bitmaps, scales and
+    /// symbolic scales of all basis blades), the type of product and the signature (matrix) of the metric.
+    /// The cached result is converted back to the names of the operands.
+    ///
+    /// The cache is split into segments, each with its own lock, such that threads rarely wait for each other.
+    /// Each segment evicts its least recently used entry when it is full.
+    /// </summary>
+    public static class ProductCache
+    {
+        /// <summary>
+        /// Types of products that are cached. The inner products are encoded by adding
+        /// their RefGA.BasisBlade.InnerProductType to INNER_PRODUCT.
+        /// </summary>
+        private const int GEOMETRIC_PRODUCT = 0;
+        private const int OUTER_PRODUCT = 1;
+        private const int INNER_PRODUCT = 16;
+
+        /// <summary>
+        /// Maximum number of entries in the cache. This bounds memory usage for very large specifications.
+        /// </summary>
+        public const int MAX_NB_ENTRIES = 1 << 16;
+
+        /// <summary>
+        /// Number of segments (each with its own lock and least recently used list).
+        /// </summary>
+        private const int NB_SEGMENTS = 16;
+
+        /// <returns>Geometric product of <paramref name="A"/> and <paramref name="B"/> (Euclidean metric).</returns>
+        public static RefGA.Multivector gp(RefGA.Multivector A, RefGA.Multivector B)
+        {
+            return gp(A, B, null);
+        }
+
+        /// <returns>Geometric product of <paramref name="A"/> and <paramref name="B"/> in metric <paramref name="M"/>
+        /// (when <paramref name="M"/> is null, the Euclidean metric is used).</returns>
+        public static RefGA.Multivector gp(RefGA.Multivector A, RefGA.Multivector B, RefGA.Metric M)
+        {
+            Renaming N = new Renaming(A, B);
+            Key K = new Key(N.A, N.B, GEOMETRIC_PRODUCT, M);
+            RefGA.Multivector R = Lookup(K);
+            if (R == null)
+            {
+                R = (M == null) ? RefGA.Multivector.gp(N.A, N.B) : RefGA.Multivector.gp(N.A, N.B, M);
+                Store(K, R);
+            }
+            return N.Restore(R);
+        }
+
+        /// <returns>Outer product of <paramref name="A"/> and <paramref name="B"/>.</returns>
+        public static RefGA.Multivector op(RefGA.Multivector A, RefGA.Multivector B)
+        {
+            Renaming N = new Renaming(A, B);
+            Key K = new Key(N.A, N.B, OUTER_PRODUCT, null);
+            RefGA.Multivector R = Lookup(K);
+            if (R == null)
+            {
+                R = RefGA.Multivector.op(N.A, N.B);
+                Store(K, R);
+            }
+            return N.Restore(R);
+        }
+
+        /// <returns>Inner product <paramref name="type"/> of <paramref name="A"/> and <paramref name="B"/> in metric <paramref name="M"/>.</returns>
+        public static RefGA.Multivector ip(RefGA.Multivector A, RefGA.Multivector B, RefGA.Metric M, RefGA.BasisBlade.InnerProductType type)
+        {
+            Renaming N = new Renaming(A, B);
+            Key K = new Key(N.A, N.B, INNER_PRODUCT + (int)type, M);
+            RefGA.Multivector R = Lookup(K);
+            if (R == null)
+            {
+                R = RefGA.Multivector.ip(N.A, N.B, M, type);
+                Store(K, R);
+            }
+            return N.Restore(R);
+        }
+
+        /// <summary>
+        /// Removes all entries from the cache.
+        /// </summary>
+        public static void Clear()
+        {
+            foreach (Segment S in s_segments)
+            {
+                lock (S)
+                {
+                    S.m_entries.Clear();
+                    S.m_lru.Clear();
+                }
+            }
+        }
+
+        /// <returns>The cached product for <paramref name="K"/>, or null when not present.</returns>
+        private static RefGA.Multivector Lookup(Key K)
+        {
+            Segment S = GetSegment(K);
+            lock (S)
+            {
+                LinkedListNode<Entry> node;
+                if (!S.m_entries.TryGetValue(K, out node)) return null;
+
+                // mark as most recently used
+                S.m_lru.Remove(node);
+                S.m_lru.AddFirst(node);
+                return node.Value.m_product;
+            }
+        }
+
+        /// <summary>
+        /// Stores product <paramref name="R"/> under <paramref name="K"/>. When the segment of <paramref name="K"/> is full, 
+        /// its least recently used entry is removed.
+        /// The product itself is computed outside the lock, so two threads may occasionally
+        /// compute the same product. Both results are identical, so it does not matter which one is kept.
+        /// </summary>
+        private static void Store(Key K, RefGA.Multivector R)
+        {
+            Segment S = GetSegment(K);
+            lock (S)
+            {
+                if (S.m_entries.ContainsKey(K)) return;
+
+                if (S.m_entries.Count >= MAX_NB_ENTRIES / NB_SEGMENTS)
+                {
+                    LinkedListNode<Entry> last = S.m_lru.Last;
+                    S.m_lru.RemoveLast();
+                    S.m_entries.Remove(last.Value.m_key);
+                }
+
+                S.m_entries[K] = S.m_lru.AddFirst(new Entry(K, R));
+            }
+        }
+
+        /// <returns>The segment that holds <paramref name="K"/>.</returns>
+        private static Segment GetSegment(Key K)
+        {
+            int H = K.GetHashCode();
+            return s_segments[(H ^ (H >> 16)) & (NB_SEGMENTS - 1)];
+        }
+
+        /// <summary>
+        /// Replaces the String factors of two operands by placeholders, and the placeholders in a product by the original names.
+        /// 
+        /// The placeholders are assigned in the sorted order of the names they replace, and sort in the same order themselves. 
+        /// RefGA sorts the factors and terms of symbolic scales (see RefGA.Util.SimplifySymbolicScalars()), so the product
+        /// of the renamed operands, with the names restored, is exactly the product of the original operands.
+        /// </summary>
+        private class Renaming
+        {
+            public Renaming(RefGA.Multivector A, RefGA.Multivector B)
+            {
+                // collect names
+                List<String> names = new List<String>();
+                Dictionary<String, String> toPlaceholder = new Dictionary<String, String>();
+                CollectNames(A, names, toPlaceholder);
+                CollectNames(B, names, toPlaceholder);
+                if (names.Count == 0)
+                {
+                    this.A = A;
+                    this.B = B;
+                    return;
+                }
+
+                // assign placeholders in sorted order (using the same comparison as RefGA.Util.SimplifySymbolicScalarsComparer)
+                names.Sort(delegate(String x, String y) { return x.CompareTo(y); });
+                m_toName = new Dictionary<String, String>();
+                for (int i = 0; i < names.Count; i++)
+                {
+                    String placeholder = PLACEHOLDER_PREFIX + i.ToString("D6");
+                    toPlaceholder[names[i]] = placeholder;
+                    m_toName[placeholder] = names[i];
+                }
+
+                this.A = Rename(A, toPlaceholder);
+                this.B = Rename(B, toPlaceholder);
+            }
+
+            /// <returns><paramref name="R"/> (a product of A and B) with the original names.</returns>
+            public RefGA.Multivector Restore(RefGA.Multivector R)
+            {
+                if (m_toName == null) return R;
+                else return Rename(R, m_toName);
+            }
+
+            /// <summary>
+            /// Adds the String factors of <paramref name="A"/> which are not in <paramref name="seen"/> yet to <paramref name="names"/>.
+            /// </summary>
+            private static void CollectNames(RefGA.Multivector A, List<String> names, Dictionary<String, String> seen)
+            {
+                foreach (RefGA.BasisBlade B in A.BasisBlades)
+                {
+                    if (B.symScale == null) continue;
+                    foreach (Object[] T in B.symScale)
+                    {
+                        if (T == null) continue;
+                        foreach (Object f in T)
+                        {
+                            String name = f as String;
+                            if ((name != null) && (!seen.ContainsKey(name)))
+                            {
+                                seen[name] = null;
+                                names.Add(name);
+                            }
+                        }
+                    }
+                }
+            }
+
+            /// <returns>Copy of <paramref name="A"/> with the String factors replaced according to <paramref name="map"/>.</returns>
+            private static RefGA.Multivector Rename(RefGA.Multivector A, Dictionary<String, String> map)
+            {
+                RefGA.BasisBlade[] L = new RefGA.BasisBlade[A.BasisBlades.Length];
+                for (int i = 0; i < L.Length; i++)
+                {
+                    RefGA.BasisBlade B = A.BasisBlades[i];
+                    L[i] = (B.symScale == null) ? B : new RefGA.BasisBlade(B, map);
+                }
+                return new RefGA.Multivector(L);
+            }
+
+            /// <summary>
+            /// Prefix of the placeholders. The placeholders are never output, because the names are always restored.
+            /// </summary>
+            private const String PLACEHOLDER_PREFIX = "_g25_sym";
+
+            /// <summary>The renamed operands.</summary>
+            public readonly RefGA.Multivector A, B;
+
+            /// <summary>Map from placeholder to original name (null when the operands contain no names).</summary>
+            private Dictionary<String, String> m_toName;
+        } // end of class Renaming
+
+        /// <summary>
+        /// Key of the cache. Multivector.CompareTo() cannot be used for equality because it ignores
+        /// the numerical factors inside symbolic scales, so the symbolic structure is compared exactly here.
+        /// </summary>
+        private class Key
+        {
+            public Key(RefGA.Multivector A, RefGA.Multivector B, int productType, RefGA.Metric M)
+            {
+                m_A = A;
+                m_B = B;
+                m_productType = productType;
+                m_signature = GetSignature(M);
+                m_hashCode = ((GetHashCode(A) * 31 + GetHashCode(B)) * 31 + productType) * 31 + GetHashCode(m_signature);
+            }
+
+            public override bool Equals(Object O)
+            {
+                Key K = O as Key;
+                if (K == null) return false;
+                return (m_hashCode == K.m_hashCode) &&
+                    (m_productType == K.m_productType) &&
+                    Equals(m_signature, K.m_signature) &&
+                    Equals(m_A, K.m_A) &&
+                    Equals(m_B, K.m_B);
+            }
+
+            public override int GetHashCode()
+            {
+                return m_hashCode;
+            }
+
+            /// <returns>The entries of the matrix of <paramref name="M"/> (row by row), or null when <paramref name="M"/> is null.</returns>
+            private static double[] GetSignature(RefGA.Metric M)
+            {
+                if (M == null) return null;
+                int dim = M.GetDimension();
+                double[] S = new double[dim * dim];
+                for (int i = 0; i < dim; i++)
+                    for (int j = 0; j < dim; j++)
+                        S[i * dim + j] = M.GetEntry(i, j);
+                return S;
+            }
+
+            /// <returns>true when metric signatures <paramref name="A"/> and <paramref name="B"/> are equal.</returns>
+            private static bool Equals(double[] A, double[] B)
+            {
+                if (Object.ReferenceEquals(A, B)) return true;
+                if ((A == null) || (B == null) || (A.Length != B.Length)) return false;
+                for (int i = 0; i < A.Length; i++)
+                    if (A[i] != B[i]) return false;
+                return true;
+            }
+
+            /// <returns>true when <paramref name="A"/> and <paramref name="B"/> have exactly the same symbolic structure.</returns>
+            private static bool Equals(RefGA.Multivector A, RefGA.Multivector B)
+            {
+                if (Object.ReferenceEquals(A, B)) return true;
+                RefGA.BasisBlade[] LA = A.BasisBlades;
+                RefGA.BasisBlade[] LB = B.BasisBlades;
+                if (LA.Length != LB.Length) return false;
+                for (int i = 0; i < LA.Length; i++)
+                {
+                    if ((LA[i].bitmap != LB[i].bitmap) || (LA[i].scale != LB[i].scale)) return false;
+                    Object[][] SA = LA[i].symScale;
+                    Object[][] SB = LB[i].symScale;
+                    int lA = (SA == null) ? 0 : SA.Length;
+                    int lB = (SB == null) ? 0 : SB.Length;
+                    if (lA != lB) return false;
+                    for (int t = 0; t < lA; t++)
+                    {
+                        if ((SA[t] == null) || (SB[t] == null))
+                        {
+                            if (SA[t] != SB[t]) return false;
+                            continue;
+                        }
+                        if (SA[t].Length != SB[t].Length) return false;
+                        for (int f = 0; f < SA[t].Length; f++)
+                            if (!FactorEquals(SA[t][f], SB[t][f])) return false;
+                    }
+                }
+                return true;
+            }
+
+            /// <returns>true when symbolic factors <paramref name="a"/> and <paramref name="b"/> are equal.</returns>
+            private static bool FactorEquals(Object a, Object b)
+            {
+                if (Object.ReferenceEquals(a, b)) return true;
+                if ((a == null) || (b == null)) return false;
+                if (!Object.ReferenceEquals(a.GetType(), b.GetType())) return false;
+                if ((a is Double) || (a is String)) return a.Equals(b);
+                return a.ToString() == b.ToString();
+            }
+
+            /// <returns>Hash code of metric signature <paramref name="S"/>.</returns>
+            private static int GetHashCode(double[] S)
+            {
+                if (S == null) return 0;
+                int H = S.Length;
+                foreach (double d in S)
+                    H = H * 31 + d.GetHashCode();
+                return H;
+            }
+
+            /// <returns>Hash code of the symbolic structure of <paramref name="A"/>.</returns>
+            private static int GetHashCode(RefGA.Multivector A)
+            {
+                int H = 0;
+                foreach (RefGA.BasisBlade B in A.BasisBlades)
+                {
+                    H = H * 31 + (int)B.bitmap;
+                    H = H * 31 + B.scale.GetHashCode();
+                    if (B.symScale == null) continue;
+                    foreach (Object[] T in B.symScale)
+                    {
+                        if (T == null) continue;
+                        foreach (Object f in T)
+                        {
+                            if (f == null) continue;
+                            H = H * 31 + (((f is Double) || (f is String)) ? f.GetHashCode() : f.ToString().GetHashCode());
+                        }
+                    }
+                }
+                return H;
+            }
+
+            private readonly RefGA.Multivector m_A;
+            private readonly RefGA.Multivector m_B;
+            private readonly int m_productType;
+            private readonly double[] m_signature;
+            private readonly int m_hashCode;
+        } // end of class Key
+
+        /// <summary>
+        /// Entry of the least recently used list of a segment.
+        /// </summary>
+        private class Entry
+        {
+            public Entry(Key K, RefGA.Multivector R)
+            {
+                m_key = K;
+                m_product = R;
+            }
+
+            public readonly Key m_key;
+            public readonly RefGA.Multivector m_product;
+        } // end of class Entry
+
+        /// <summary>
+        /// Segment of the cache: a map from key to node of the least recently used list (most recently used first).
+        /// Lock the segment itself before accessing it.
+        /// </summary>
+        private class Segment
+        {
+            public Dictionary<Key, LinkedListNode<Entry>> m_entries = new Dictionary<Key, LinkedListNode<Entry>>();
+            public LinkedList<Entry> m_lru = new LinkedList<Entry>();
+        } // end of class Segment
+
+        /// <returns>NB_SEGMENTS empty segments.</returns>
+        private static Segment[] CreateSegments()
+        {
+            Segment[] S = new Segment[NB_SEGMENTS];
+            for (int i = 0; i < S.Length; i++)
+                S[i] = new Segment();
+            return S;
+        }
+
+        /// <summary>
+        /// The segments of the cache.
+        /// </summary>
+        private static readonly Segment[] s_segments = CreateSegments();
+    } // end of class ProductCache
+} // end of namespace G25.CG.Shared
@@ -54,6 +54,8 @@ namespace G25.CG.Shared
             // get XML spec
             string XMLstr = GetXMLstring(S, F, FAI);
 
+            if (S.OutputCpp()) return GetCppReportInstruction(S, FAI, XMLstr);
+
             StringBuilder SB = new StringBuilder();
 
             if (S.OutputCSharpOrJava())
@@ -76,11 +78,7 @@ namespace G25.CG.Shared
                         SB.AppendLine(" && ");
                         SB.Append("\t");
                     }
-                    if (S.OutputCpp())
-                    {
-                        SB.Append("(" + FAI[i].Name + ".m_t > " + MV_CONSTANT + ") && (" + FAI[i].Name + ".m_t < " + INVALID_CONSTANT + ")");
-                    }
-                    else if (S.OutputCSharp())
+                    if (S.OutputCSharp())
                     {
                         SB.Append("(type_" + FAI[i].Name + " > SmvType." + MV_CONSTANT + ") && (type_" + FAI[i].Name + " < SmvType." + INVALID_CONSTANT + ")");
                     }
@@ -92,11 +90,7 @@ namespace G25.CG.Shared
                 SB.AppendLine(") {");
 
 
-                if (S.OutputCpp())
-                {
-                    SB.Append("\t\tstd::string reportUsageString = std::string(\"\") + ");
-                }
-                else if (S.OutputCSharp())
+                if (S.OutputCSharp())
                 {
                     SB.Append("\t\tstring reportUsageString = ");
                 }
@@ -117,11 +111,7 @@ namespace G25.CG.Shared
                     SB.Append(Util.StringToCode(XMLstr.Substring(XMLstrIdx, nextIdx - XMLstrIdx)));
                     if (argIdx < FAI.Length)
                     {
-                        if (S.OutputCpp())
-                        {
-                            SB.Append("+ g_" + S.m_namespace + "Typenames[" + FAI[argIdx].Name + ".m_t] + ");
-                        }
-                        else if (S.OutputCSharp())
+                        if (S.OutputCSharp())
                         {
                             SB.Append("+ typenames[(int)type_" + FAI[argIdx].Name + "] + ");
                         }
@@ -135,11 +125,7 @@ namespace G25.CG.Shared
                     XMLstrIdx = nextIdx + placeHolder.Length;
                 }
                 SB.AppendLine(";");
-                if (S.OutputCpp())
-                {
-                    SB.AppendLine("\t\tReportUsage::mergeReport(new ReportUsage(reportUsageString));");
-                }
-                else if (S.OutputCSharp())
+                if (S.OutputCSharp())
                 {
                     SB.AppendLine("\t\tReportUsage.MergeReport(new ReportUsage(reportUsageString));");
                 }
@@ -155,6 +141,80 @@ namespace G25.CG.Shared
             return new VerbatimCodeInstruction(nbTabs, SB.ToString());
         }
 
+        /// <summary>
+        /// Returns the report instruction for C++.
+        /// 
+        /// Each report site gets a static <c>ReportUsageSite</c> with an ID which is assigned here (at generation time).
+        /// The XML string is split into parts at the argument type names, such that no strings have to be built
+        /// at run-time. The types of the arguments are packed into a single key which is counted lock-free
+        /// (see the <c>ReportUsageHeader</c> template); the report is only assembled in <c>ReportUsage::printReport()</c>.
+        /// </summary>
+        private static Instruction GetCppReportInstruction(Specification S, FuncArgInfo[] FAI, string XMLstr)
+        {
+            // number of bits required for the type of each argument
+            int nbTypes = SmvUtil.GetSpecializedTypeDictionary(S).Count;
+            int nbBitsPerArg = 1;
+            while ((1 << nbBitsPerArg) <= nbTypes) nbBitsPerArg++;
+            if (nbBitsPerArg * FAI.Length > MAX_NB_KEY_BITS) return new NOPinstruction(); // types do not fit in key
+
+            int siteId = System.Threading.Interlocked.Increment(ref s_nbCppSites);
+
+            StringBuilder SB = new StringBuilder();
+
+            // the parts of the XML string, in between the argument types
+            SB.Append("static const char *reportUsageXml[] = {");
+            int XMLstrIdx = 0;
+            for (int argIdx = 0; argIdx <= FAI.Length; argIdx++)
+            {
+                string placeHolder = GetPlaceHolderString(argIdx);
+                int nextIdx = XMLstr.IndexOf(placeHolder, XMLstrIdx);
+                if ((argIdx == FAI.Length) || (nextIdx < 0)) nextIdx = XMLstr.Length;
+
+                if (argIdx > 0) SB.Append(", ");
+                SB.Append(Util.StringToCode(XMLstr.Substring(XMLstrIdx, nextIdx - XMLstrIdx)));
+                XMLstrIdx = Math.Min(nextIdx + placeHolder.Length, XMLstr.Length);
+            }
+            SB.AppendLine("};");
+            SB.AppendLine("static ReportUsageSite reportUsageSite = {" + siteId + ", " + FAI.Length + ", " + nbBitsPerArg + ", reportUsageXml};");
+
+            // output the test for all specialized MVs
+            string MV_CONSTANT = GetSpecializedConstantName(S, S.m_GMV.Name);
+            string INVALID_CONSTANT = GetSpecializedConstantName(S, INVALID);
+            SB.Append("if (");
+            for (int i = 0; i < FAI.Length; i++)
+            {
+                if (i > 0)
+                {
+                    SB.AppendLine(" && ");
+                    SB.Append("\t");
+                }
+                SB.Append("(" + FAI[i].Name + ".m_t > " + MV_CONSTANT + ") && (" + FAI[i].Name + ".m_t < " + INVALID_CONSTANT + ")");
+            }
+            SB.AppendLine(")");
+
+            // pack the types of the arguments into the key
+            SB.Append("\tReportUsage::count(reportUsageSite, ");
+            for (int i = 0; i < FAI.Length; i++)
+            {
+                if (i > 0) SB.Append(" | ");
+                SB.Append("((unsigned int)" + FAI[i].Name + ".m_t << " + (i * nbBitsPerArg) + ")");
+            }
+            SB.AppendLine(");");
+
+            int nbTabs = 1;
+            return new VerbatimCodeInstruction(nbTabs, SB.ToString());
+        }
+
+        /// <summary>
+        /// Number of bits in the key of a C++ report (the key should remain positive as a signed 32-bit integer).
+        /// </summary>
+        private const int MAX_NB_KEY_BITS = 30;
+
+        /// <summary>
+        /// Number of C++ report sites generated so far. Used to assign a unique ID to each site.
+        /// </summary>
+        private static int s_nbCppSites = 0;
+
         private static string GetPlaceHolderString(int idx)
         {
             return PLACE_HOLDER + idx;
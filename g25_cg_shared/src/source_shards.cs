@@ -0,0 +1,249 @@
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+// Copyright 2008-2010, Daniel Fontijne, University of Amsterdam -- fontijne@science.uva.nl
+
+using System;
+using System.Collections.Generic;
+using System.Text;
+
+namespace G25.CG.Shared
+{
+
+    /// <summary>
+    /// Collects the definitions that go into the source file of the C and C++ languages when
+    /// the user has asked for the source to be split over multiple files (XML attribute <c>sourceShards</c>,
+    /// <c>Specification.m_nbSourceShards</c>).
+    /// 
+    /// The definitions are kept apart per function family (parts, set functions, converters, functions).
+    /// Each family is split over one or more shards. The declarations that shards need from 
+    /// each other (e.g., the parts of the geometric product) go into a shared internal header.
+    /// 
+    /// The definitions are streamed to disk as soon as they are appended: each block of definitions
+    /// goes to the shard of its family which has the least code so far. A block is always a whole
+    /// function group (the output of one function generator, converter or set generator), because such a group
+    /// may contain static helper functions which are only visible to the rest of the group. 
+    /// Only the parts code (which contains no static functions) is split at the end of each definition. 
+    /// Since the definitions are 
+    /// appended in a fixed order (see Functions.WriteFunctions()), the output is deterministic.
+    /// Because the preamble of the shards (#includes) is only known once all code is generated,
+    /// the definitions are first written to a temporary file per shard (see DefinitionSpool). WriteShards() then writes the 
+    /// final source files, copying the temporary files in small blocks.
+    /// 
+    /// When a CGdata has no SourceShards (the default), all definitions go into a single source file (see <c>CGdata.AppendDefinitions()</c>).
+    /// </summary>
+    public class SourceShards
+    {
+        /// <summary>Family of the parts code (geometric product parts, dual parts, etc).</summary>
+        public const string PARTS = "parts";
+        /// <summary>Family of the set, copy, largest coordinate (etc) functions.</summary>
+        public const string SET = "set";
+        /// <summary>Family of the converters (underscore constructors).</summary>
+        public const string CONVERTERS = "converters";
+        /// <summary>Family of the regular functions (gp, op, applyVersor, etc).</summary>
+        public const string FUNCTIONS = "functions";
+
+        /// <summary>All families, in the order in which they are written.</summary>
+        public static readonly string[] FAMILIES = new string[] { PARTS, SET, CONVERTERS, FUNCTIONS };
+
+        /// <summary>
+        /// Consecutive parts definitions are kept in the same shard until they are at least this size (in characters).
+        /// This keeps small, related definitions together, while the large parts family is still spread evenly.
+        /// </summary>
+        public const int BLOCK_SIZE = 16 * 1024;
+
+        /// <param name="S">Specification (used for the namespace and output directory).</param>
+        /// <param name="nbShards">Maximum number of shards for each family.</param>
+        public SourceShards(Specification S, int nbShards)
+        {
+            m_specification = S;
+            m_nbShards = nbShards;
+            foreach (string family in FAMILIES)
+                m_shards[family] = new DefinitionSpool[nbShards];
+        }
+
+        /// <returns>Raw filename of the internal header which is shared by all shards.</returns>
+        public static string GetRawInternalHeaderFilename(Specification S)
+        {
+            return S.m_namespace + "_internal.h";
+        }
+
+        /// <summary>
+        /// Returns the raw filename of a shard. The name can be overridden using <c>outputFilename</c>
+        /// (possibly using a wildcard, like <c>defaultName="c3ga_functions_*.cpp"</c>).
+        /// </summary>
+        /// <param name="S">Specification (used for namespace).</param>
+        /// <param name="family">One of FAMILIES.</param>
+        /// <param name="idx">Index of shard within family.</param>
+        /// <param name="extension">Extension of source file (".c" or ".cpp").</param>
+        /// <returns>Raw filename of shard <c>idx</c> of <c>family</c>.</returns>
+        public static string GetRawShardFilename(Specification S, string family, int idx, string extension)
+        {
+            return S.m_namespace + "_" + family + "_" + idx + extension;
+        }
+
+        /// <summary>
+        /// Appends declarations which must be visible to all shards (thread-safe).
+        /// </summary>
+        public void AppendDeclarations(StringBuilder declSB)
+        {
+            lock (m_internalDeclSB)
+            {
+                m_internalDeclSB.Append(declSB);
+            }
+        }
+
+        /// <summary>
+        /// Appends definitions to the code of <c>family</c> (thread-safe).
+        /// 
+        /// <c>defSB</c> should contain one whole function group. It is written to the least-filled shard of the family
+        /// as a single block, such that static helper functions stay in the same file as the functions that call them.
+        /// The parts code is the exception: it is split into blocks of at least BLOCK_SIZE characters (only at the end of 
+        /// a top-level definition).
+        /// </summary>
+        public void AppendDefinitions(string family, StringBuilder defSB)
+        {
+            string code = defSB.ToString();
+            if (code.Trim().Length == 0) return;
+
+            lock (m_shards)
+            {
+                if (family != PARTS)
+                {
+                    GetLeastFilledShard(family).Write(code, 0, code.Length);
+                    return;
+                }
+
+                int startIdx = 0;
+                while (startIdx < code.Length)
+                {
+                    int endIdx = FindEndOfDefinition(code, startIdx + BLOCK_SIZE);
+                    if (endIdx < 0) endIdx = code.Length;
+                    GetLeastFilledShard(family).Write(code, startIdx, endIdx - startIdx);
+                    startIdx = endIdx;
+                }
+            }
+        }
+
+        /// <returns>All declarations which should go into the internal header.</returns>
+        public string GetDeclarations()
+        {
+            return m_internalDeclSB.ToString();
+        }
+
+        /// <summary>
+        /// Writes the source files of all families. Each file consists of <c>preamble</c>, the definitions
+        /// of the shard, and <c>postamble</c>. Shards without code are skipped, and the remaining shards of each family
+        /// are numbered consecutively. The temporary files are removed, also when writing fails.
+        /// </summary>
+        /// <param name="extension">Extension of source file (".c" or ".cpp").</param>
+        /// <param name="preamble">Code that goes before the definitions (copyright, #includes, etc).</param>
+        /// <param name="postamble">Code that goes after the definitions (e.g., closing of namespace).</param>
+        /// <returns>a list of filenames which were generated (full path).</returns>
+        public List<string> WriteShards(string extension, string preamble, string postamble)
+        {
+            List<string> generatedFiles = new List<string>();
+            lock (m_shards)
+            {
+                try
+                {
+                    foreach (string family in FAMILIES)
+                    {
+                        int idx = 0;
+                        foreach (DefinitionSpool shard in m_shards[family])
+                        {
+                            if (shard == null) continue;
+                            string shardFilename = m_specification.GetOutputPath(GetRawShardFilename(m_specification, family, idx, extension));
+                            shard.CopyTo(shardFilename, preamble, postamble);
+                            generatedFiles.Add(shardFilename);
+                            idx++;
+                        }
+                    }
+                }
+                finally
+                {
+                    // remove temporary files which were not copied (when writing failed halfway)
+                    foreach (string family in FAMILIES)
+                    {
+                        foreach (DefinitionSpool shard in m_shards[family])
+                            if (shard != null) shard.Delete();
+                        m_shards[family] = new DefinitionSpool[m_nbShards];
+                    }
+                }
+            }
+            return generatedFiles;
+        }
+
+        /// <summary>
+        /// Returns the shard of <c>family</c> with the least code. Shards are created 
+        /// (and their temporary file opened) when they are first needed.
+        /// </summary>
+        private DefinitionSpool GetLeastFilledShard(string family)
+        {
+            DefinitionSpool[] shards = m_shards[family];
+            int bestIdx = -1;
+            for (int i = 0; i < shards.Length; i++)
+            {
+                if (shards[i] == null)
+                { // an unused shard is always the least filled
+                    shards[i] = new DefinitionSpool(DefinitionSpool.GetTmpFilename(m_specification, GetRawShardFilename(m_specification, family, i, "")));
+                    return shards[i];
+                }
+                if ((bestIdx < 0) || (shards[i].Length < shards[bestIdx].Length))
+                    bestIdx = i;
+            }
+            return shards[bestIdx];
+        }
+
+        /// <summary>
+        /// Finds the first line consisting of only <c>"}"</c>, starting the search at <c>idx</c>.
+        /// </summary>
+        /// <returns>index of the start of the line after the closing bracket, or -1 when not found.</returns>
+        private static int FindEndOfDefinition(string code, int idx)
+        {
+            if (idx >= code.Length) return -1;
+
+            // move to start of next line, unless already there
+            if ((idx > 0) && (code[idx - 1] != '\n'))
+            {
+                idx = code.IndexOf('\n', idx);
+                if (idx < 0) return -1;
+                idx++;
+            }
+
+            while (idx < code.Length)
+            {
+                int lineEnd = code.IndexOf('\n', idx);
+                if (lineEnd < 0) return -1;
+                if (code.Substring(idx, lineEnd - idx).TrimEnd() == "}")
+                    return lineEnd + 1;
+                idx = lineEnd + 1;
+            }
+            return -1;
+        }
+
+        /// <summary>Specification (used for the namespace and output directory).</summary>
+        protected Specification m_specification;
+
+        /// <summary>Maximum number of shards for each family.</summary>
+        protected int m_nbShards;
+
+        /// <summary>Declarations that go into the internal header.</summary>
+        protected StringBuilder m_internalDeclSB = new StringBuilder();
+
+        /// <summary>Map from family to its shards (null when not used yet).</summary>
+        private Dictionary<string, DefinitionSpool[]> m_shards = new Dictionary<string, DefinitionSpool[]>();
+
+    } // end of class SourceShards
+} // end of namespace G25.CG.Shared
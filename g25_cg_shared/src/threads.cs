@@ -80,6 +80,139 @@ namespace G25.CG.Shared
             }
         }
 
+        /// <summary>
+        /// Called by RunWorkQueue() on the calling thread, for each item in order.
+        /// </summary>
+        /// <param name="idx">Index of the item which is done.</param>
+        public delegate void ItemDone(int idx);
+
+        /// <summary>
+        /// A worker does not start an item which is more than this number of items (times the number of workers) ahead of 
+        /// the item which is handled next by RunWorkQueue(). This bounds the number of results which are kept in memory
+        /// while an earlier item is still running.
+        /// </summary>
+        public const int MAX_ITEMS_AHEAD_PER_WORKER = 4;
+
+        /// <returns>The number of worker threads used by RunWorkQueue() (the number of processors).</returns>
+        public static int GetNbWorkerThreads()
+        {
+            return Math.Max(1, Environment.ProcessorCount);
+        }
+
+        /// <summary>
+        /// Runs all (non-null) entries of <c>T</c> on a fixed number of worker threads (see GetNbWorkerThreads()),
+        /// instead of starting a thread for each entry. The entries are started in order.
+        /// 
+        /// When <c>done</c> is not null, it is called on the calling thread for each entry in order, 
+        /// as soon as that entry (and all entries before it) have finished. This allows the results to be 
+        /// collected (and released) in a deterministic order, while later entries are still running.
+        /// </summary>
+        /// <param name="T">Work items (may contain null entries).</param>
+        /// <param name="done">Called in order for each item (including null entries) when it is done. May be null.</param>
+        public static void RunWorkQueue(System.Threading.ThreadStart[] T, ItemDone done)
+        {
+            if (RUN_THREADS_SERIALLY)
+            {
+                for (int t = 0; t < T.Length; t++)
+                {
+                    if (T[t] != null) T[t]();
+                    if (done != null) done(t);
+                }
+                return;
+            }
+
+            int nbWorkers = Math.Min(GetNbWorkerThreads(), T.Length);
+            WorkQueue Q = new WorkQueue(T, (done == null) ? T.Length : MAX_ITEMS_AHEAD_PER_WORKER * nbWorkers);
+            System.Threading.Thread[] workers = new System.Threading.Thread[nbWorkers];
+            for (int w = 0; w < nbWorkers; w++)
+                workers[w] = new System.Threading.Thread(Q.Work);
+            StartThreadArray(workers);
+
+            if (done != null)
+            {
+                for (int t = 0; t < T.Length; t++)
+                {
+                    Q.WaitFor(t);
+                    done(t);
+                    Q.Handled(t);
+                }
+            }
+
+            JoinThreadArray(workers);
+        }
+
+        /// <summary>
+        /// The state shared by the worker threads of RunWorkQueue().
+        /// </summary>
+        private class WorkQueue
+        {
+            /// <param name="T">Work items (may contain null entries).</param>
+            /// <param name="maxAhead">Maximum number of items that may be started beyond the item which is handled next.</param>
+            public WorkQueue(System.Threading.ThreadStart[] T, int maxAhead)
+            {
+                m_T = T;
+                m_finished = new bool[T.Length];
+                m_maxAhead = Math.Max(1, maxAhead);
+            }
+
+            /// <summary>
+            /// Entry point of the worker threads: runs items in order until there are none left.
+            /// </summary>
+            public void Work()
+            {
+                while (true)
+                {
+                    int idx;
+                    lock (m_lock)
+                    {
+                        while ((m_nextToStart < m_T.Length) && (m_nextToStart - m_nextToHandle >= m_maxAhead))
+                            System.Threading.Monitor.Wait(m_lock);
+                        if (m_nextToStart >= m_T.Length) return;
+                        idx = m_nextToStart++;
+                    }
+
+                    if (m_T[idx] != null) m_T[idx]();
+
+                    lock (m_lock)
+                    {
+                        m_finished[idx] = true;
+                        System.Threading.Monitor.PulseAll(m_lock);
+                    }
+                }
+            }
+
+            /// <summary>
+            /// Blocks until item <c>idx</c> has finished.
+            /// </summary>
+            public void WaitFor(int idx)
+            {
+                lock (m_lock)
+                {
+                    while (!m_finished[idx])
+                        System.Threading.Monitor.Wait(m_lock);
+                }
+            }
+
+            /// <summary>
+            /// Marks item <c>idx</c> as handled, such that the workers may start items further ahead.
+            /// </summary>
+            public void Handled(int idx)
+            {
+                lock (m_lock)
+                {
+                    m_nextToHandle = idx + 1;
+                    System.Threading.Monitor.PulseAll(m_lock);
+                }
+            }
+
+            private System.Threading.ThreadStart[] m_T;
+            private bool[] m_finished;
+            private int m_maxAhead;
+            private int m_nextToStart;
+            private int m_nextToHandle;
+            private Object m_lock = new Object();
+        } // end of class WorkQueue
+
         /// <summary>
         /// Starts and joins all threads in 'T' one after another (this useful for debugging).
         /// </summary>
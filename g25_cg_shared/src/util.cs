@@ -550,6 +550,58 @@ namespace G25.CG.Shared
             return SB.ToString();
         }
 
+        /// <summary>
+        /// Multiplier of the (32 bit FNV-1a) string hash used by GetStringHash().
+        /// </summary>
+        public const uint STRING_HASH_PRIME = 16777619;
+
+        /// <summary>
+        /// Hashes <paramref name="str"/> (FNV-1a, starting from <paramref name="seed"/>).
+        /// The generated code computes the same hash as:
+        /// <code>h = seed; for (i = 0; i &lt; len; i++) h = (h ^ (unsigned char)str[i]) * 16777619u;</code>
+        /// </summary>
+        public static uint GetStringHash(uint seed, string str)
+        {
+            uint h = seed;
+            foreach (char c in str)
+                h = unchecked((h ^ (uint)(c & 0xFF)) * STRING_HASH_PRIME);
+            return h;
+        }
+
+        /// <summary>
+        /// Finds a perfect hash for <paramref name="names"/>: a seed such that 
+        /// <c>GetStringHash(seed, name) &amp; (table.Length-1)</c> is different for each name.
+        /// The table is at least twice as large as the number of names. It is used by the
+        /// builtin parser to look up basis vector names with a single comparison.
+        /// </summary>
+        /// <param name="names">The (unique) names.</param>
+        /// <param name="seed">The seed of the hash.</param>
+        /// <returns>For each slot of the hash table, the index of the name which hashes to it, or -1.</returns>
+        public static int[] GetPerfectHashTable(List<string> names, out uint seed)
+        {
+            const int MAX_NB_SEEDS = 1 << 16;
+            for (int tableSize = 2; ; tableSize *= 2)
+            {
+                if (tableSize < 2 * names.Count) continue;
+
+                int[] table = new int[tableSize];
+                for (uint s = 0; s < MAX_NB_SEEDS; s++)
+                {
+                    seed = unchecked(2166136261u + s); // FNV offset basis + s
+                    for (int i = 0; i < tableSize; i++) table[i] = -1;
+
+                    bool collision = false;
+                    for (int n = 0; (n < names.Count) && (!collision); n++)
+                    {
+                        int idx = (int)(GetStringHash(seed, names[n]) & (uint)(tableSize - 1));
+                        if (table[idx] >= 0) collision = true;
+                        else table[idx] = n;
+                    }
+                    if (!collision) return table;
+                }
+            }
+        }
+
         /// <returns>A unique name for the testing function of 'funcName'.</returns>
         public static string GetTestingFunctionName(Specification S, CGdata cgd, string funcName)
         {
@@ -32,6 +32,13 @@ namespace g25_test_generator
         /// </summary>
         public static bool SampleAlgebras = false;
 
+        /// <summary>
+        /// When true, each algebra is generated (in C++) with both GMV code generation methods (expand, runtime) 
+        /// and all GMV memory allocation methods, including a benchmark suite.
+        /// The build_and_benchmark script runs the same GMV workloads on each of them and prints a comparison table.
+        /// </summary>
+        public static bool BenchmarkModes = false;
+
         /// <summary>
         /// What algebras to generate for (command-line option, otherwise the default is used.
         /// </summary>
@@ -50,6 +57,13 @@ namespace g25_test_generator
         public const string TEST_CMD = "test";
         public const string XML_TEST_CMD = "xml_test";
         public const string DOXYGEN_CMD = "doxygen";
+        public const string BENCHMARK_CMD = "benchmark";
+
+        /// <summary>
+        /// The GMV functions which are timed by the benchmark algebras (see BenchmarkModes), with their number of arguments.
+        /// </summary>
+        public static string[] BenchmarkWorkloads = new string[] { "gp", "op", "lc", "dual", "applyVersor" };
+        public static int[] BenchmarkWorkloadNbArgs = new int[] { 2, 2, 2, 1, 2 };
 
         public static List<string> Languages = new List<string> { 
             G25.XML.XML_C, 
@@ -94,11 +108,13 @@ namespace g25_test_generator
             commands[TEST_CMD] = new List<string>();
             commands[XML_TEST_CMD] = new List<string>();
             commands[DOXYGEN_CMD] = new List<string>();
+            commands[BENCHMARK_CMD] = new List<string>();
 
             // generate the specifications, collect commands
             try
             {
                 if (SampleAlgebras) GenerateSampleAlgebras(cog, commands);
+                else if (BenchmarkModes) GenerateBenchmarkVariations(cog, commands);
                 else GenerateVariations(cog, commands);
             }
             catch (Exception ex)
@@ -129,6 +145,7 @@ namespace g25_test_generator
                 { "a|algebra=", (string s) => { Algebras.Add(s.ToLower()); } },
                 { "s|shuffle", (string s) => {Shuffle = true;} },
                 { "sa|sample_algebras", (string s) => {SampleAlgebras = true;} },
+                { "b|benchmark", (string s) => {BenchmarkModes = true;} },
                 { "r|reduce=", (int r) => {ReduceNbTestsBy = r;} },
             };
 
@@ -154,6 +171,8 @@ namespace g25_test_generator
                 "Options:\n" +
                 "-h -? -help: display help.\n" +
 			    "-sa -sample_algebras: generate the sample algebras instead of the test algebras.\n" +       
+                "-b -benchmark: generate each algebra with gmvCode expand/runtime and each memAlloc method,\n" +
+                "               and a script which benchmarks and compares them.\n" +
                 "-a -algebra: what algebras to generate (e2ga, e3ga, p3ga, c3ga, enga).\n" +
                 "-s -shuffle: shuffle the order of the algebras inside the scripts.\n" +
                 "-r -reduce: reduce the number of test algebras by a factor of N (default is 1000).\n" +
@@ -228,6 +247,39 @@ namespace g25_test_generator
 			}
         }
 
+        /// <summary>
+        /// Writes a script which builds and runs the benchmark algebras. The results of all algebras are collected in
+        /// benchmark_comparison.csv, which is printed at the end, grouped by function.
+        /// </summary>
+        public static void WriteBenchmarkScript(StringBuilder SB, List<string> commands)
+        {
+            if (IsUnix())
+            {
+                SB.AppendLine("#!/bin/sh");
+                SB.AppendLine("");
+                SB.AppendLine("echo \"variant,function,floatType,callsPerBatch,medianNs,p99Ns\" > benchmark_comparison.csv");
+                AppendCommands(SB, commands);
+                SB.AppendLine("echo \"\"");
+                SB.AppendLine("echo \"Comparison (grouped by function):\"");
+                SB.AppendLine("head -n 1 benchmark_comparison.csv");
+                SB.AppendLine("tail -n +2 benchmark_comparison.csv | sort -t, -k2");
+                SB.AppendLine("exit 0");
+            }
+            else
+            {
+                if (IsWindows())
+                    SB.AppendLine("@echo off");
+                SB.AppendLine("echo variant,function,floatType,callsPerBatch,medianNs,p99Ns> benchmark_comparison.csv");
+                AppendCommands(SB, commands);
+                SB.AppendLine("echo.");
+                SB.AppendLine("echo Comparison:");
+                SB.AppendLine("type benchmark_comparison.csv");
+                SB.AppendLine("exit /B 0");
+                SB.AppendLine(":error");
+                SB.AppendLine("exit /B -1");
+            }
+        }
+
         public static void WriteXmlTestScript(StringBuilder SB, List<string> commands)
         {
 			if (IsWindows()) {
@@ -264,7 +316,7 @@ namespace g25_test_generator
 
             { // build
                 StringBuilder SB = new StringBuilder();
-                WriteBuildScript(SB, commands[BUILD_CMD]);
+                WriteBuildScript(SB, new List<string>(commands[BUILD_CMD])); // copy: AppendCommands() inserts progress indicators, and the build commands are interleaved again below
 
                 string compileScriptFlename = System.IO.Path.Combine(OutputDirectory, "build." + GetScriptExtension());
                 G25.CG.Shared.Util.WriteFile(compileScriptFlename, SB.ToString());
@@ -294,6 +346,17 @@ namespace g25_test_generator
                 G25.CG.Shared.Util.WriteFile(runScriptFlename, SB.ToString());
             }
 
+            if (commands[BENCHMARK_CMD].Count > 0)
+            { // build and benchmark
+                List<string> interleavedCommands = InterleaveCommandList(commands[BUILD_CMD], commands[BENCHMARK_CMD]);
+
+                StringBuilder SB = new StringBuilder();
+                WriteBenchmarkScript(SB, interleavedCommands);
+
+                string benchmarkScriptFlename = System.IO.Path.Combine(OutputDirectory, "build_and_benchmark." + GetScriptExtension());
+                G25.CG.Shared.Util.WriteFile(benchmarkScriptFlename, SB.ToString());
+            }
+
             { // doxygen
                 StringBuilder SB = new StringBuilder();
                 if (IsUnix()) SB.Append("#!/bin/sh\n\n");
@@ -361,6 +424,37 @@ namespace g25_test_generator
             GenerateC3gaVariations(cog, commands, vars);
         }
 
+        /// <summary>
+        /// Generates the benchmark algebras (see BenchmarkModes).
+        /// All algebras are C++, with default settings, except for the GMV code generation method and memory allocation method.
+        /// Runtime GMV code is not generated for c3ga because its metric is not diagonal.
+        /// </summary>
+        public static void GenerateBenchmarkVariations(CoG cog, Dictionary<string, List<string>> commands)
+        {
+            Console.WriteLine("Generating the benchmark algebras");
+
+            ReduceNbTestsBy = 1;
+            Shuffle = false;
+
+            SpecVars SV = new SpecVars();
+            SV.OutputLanguage = G25.XML.XML_CPP;
+            SV.BenchmarkSuite = true;
+            List<SpecVars> vars = SpecVars.VaryGmvMemAlloc(new List<SpecVars> { SV }, new List<G25.GMV.MEM_ALLOC_METHOD> { 
+                G25.GMV.MEM_ALLOC_METHOD.FULL, G25.GMV.MEM_ALLOC_METHOD.PARITY_PURE, G25.GMV.MEM_ALLOC_METHOD.DYNAMIC });
+            List<SpecVars> varsBothGmvCodes = SpecVars.VaryGmvCode(vars, new List<G25.GMV_CODE> { G25.GMV_CODE.EXPAND, G25.GMV_CODE.RUNTIME });
+
+            if (Algebras.Contains("e2ga")) GenerateE2gaVariations(cog, commands, SpecVars.VaryDimension(varsBothGmvCodes, new List<int> { 2 }));
+            if (Algebras.Contains("e3ga")) GenerateE3gaVariations(cog, commands, SpecVars.VaryDimension(varsBothGmvCodes, new List<int> { 3 }));
+            if (Algebras.Contains("p3ga")) GenerateP3gaVariations(cog, commands, SpecVars.VaryDimension(varsBothGmvCodes, new List<int> { 4 }));
+            if (Algebras.Contains("c3ga")) GenerateC3gaVariations(cog, commands, SpecVars.VaryDimension(vars, new List<int> { 5 }));
+            if (Algebras.Contains("enga"))
+            {
+                // up to 7-D; above that, the expanded code is too large to be compiled
+                foreach (SpecVars V in SpecVars.VaryDimension(varsBothGmvCodes, new List<int> { 5, 6, 7 }))
+                    GenerateFromVar(cog, commands, "eNga_spec", GetMakefileTemplateName(V.OutputLanguage), "e" + V.Dimension + "ga", V);
+            }
+        }
+
         public static void GenerateVariations(CoG cog, Dictionary<string, List<string>> commands)
         {
             if (Algebras.Contains("e2ga")) GenerateE2gaVariations(cog, commands);
@@ -597,11 +691,13 @@ namespace g25_test_generator
             }
 
 
-            commands[BUILD_CMD].Add(GenerateMakeCommands(cog, specName, SV, ""));
+            commands[BUILD_CMD].Add(GenerateMakeCommands(cog, specName, SV, (SV.BenchmarkSuite && IsUnix()) ? " CXXFLAGS=-O2" : ""));
             commands[TEST_CMD].Add(GenerateRunCommands(cog, specName, SV));
             commands[CLEAN_CMD].Add(GenerateMakeCommands(cog, specName, SV, " clean"));
             commands[XML_TEST_CMD].Add(GenerateXmlTestCommands(cog, specName, SV));
             commands[DOXYGEN_CMD].Add(GenerateDoxygenCommands(cog, specName, SV));
+            if (SV.BenchmarkSuite)
+                commands[BENCHMARK_CMD].Add(GenerateBenchmarkCommands(cog, specName, SV));
 
             return specName;
         }
@@ -659,6 +755,40 @@ namespace g25_test_generator
             return SB.ToString();
         }
 
+        /// <summary>
+        /// Returns the commands which run the benchmark of 'specName' on the GMV workloads (see BenchmarkWorkloads)
+        /// and append the results (prefixed with 'specName') to benchmark_comparison.csv.
+        /// </summary>
+        public static string GenerateBenchmarkCommands(CoG cog, string specName, SpecVars SV)
+        {
+            StringBuilder SB = new StringBuilder();
+
+            StringBuilder filters = new StringBuilder();
+            for (int i = 0; i < BenchmarkWorkloads.Length; i++)
+            {
+                filters.Append(" \"" + BenchmarkWorkloads[i] + "(" + SV.GmvName);
+                if (BenchmarkWorkloadNbArgs[i] == 2) filters.Append(", " + SV.GmvName);
+                filters.Append(")\"");
+            }
+
+            SB.AppendLine("");
+            SB.AppendLine("cd " + specName);
+            SB.AppendLine("echo \"Benchmarking " + specName + " \"");
+            if (IsUnix())
+            {
+                SB.AppendLine("./benchmark" + filters.ToString() + " > benchmark.csv");
+                SB.AppendLine("tail -n +2 benchmark.csv | sed \"s/^/" + specName + ",/\" >> ../benchmark_comparison.csv");
+            }
+            else
+            {
+                SB.AppendLine("benchmark.exe" + filters.ToString() + " > benchmark.csv");
+                SB.AppendLine("for /F \"skip=1 delims=\" %%L in (benchmark.csv) do echo " + specName + ",%%L>> ..\\benchmark_comparison.csv");
+            }
+            SB.AppendLine("cd ..");
+
+            return SB.ToString();
+        }
+
         public static string GenerateXmlTestCommands(CoG cog, string specName, SpecVars SV)
         {
             StringBuilder SB = new StringBuilder();
@@ -22,6 +22,7 @@ namespace g25_test_generator
     ///   - memory allocation method of GMV
     ///   - number of float types, what float types
     ///   - what random generator is used
+    ///   - whether to generate a benchmark suite
     /// 
     /// </summary>
     public class SpecVars : ICloneable
@@ -44,6 +45,7 @@ namespace g25_test_generator
             FloatTypes = new List<string>{"double"};
             RandomGenerator = "libc";
             ShortNameLangOnly = false;
+            BenchmarkSuite = false;
         }
 
         object ICloneable.Clone()
@@ -84,6 +86,7 @@ namespace g25_test_generator
                     ((Inline) ? "I" : "x") + "_" +
                     ((ReportUsage) ? "R" : "x") + "_" +
                     gmvMemAllocStr +
+                    ((BenchmarkSuite) ? ((GmvCode == G25.GMV_CODE.RUNTIME) ? "R" : "E") : "") + // the benchmark algebras are generated with both gmvCode values
                     GmvName + "_" +
                     floatTypesStr + "_" +
                     RandomGenerator + "_" +
@@ -518,6 +521,7 @@ namespace g25_test_generator
         public List<string> FloatTypes { get; set; }
         public string RandomGenerator { get; set; }
         public bool ShortNameLangOnly { get; set; }
+        public bool BenchmarkSuite { get; set; }
 
     }
 }
@@ -122,6 +122,14 @@ namespace G25
             else return true;
         }
 
+        /// <returns>Size of this floating point type in bytes. Throws a G25.UserException for types other than float and double.</returns>
+        public int SizeOf()
+        {
+            if (type == "float") return 4;
+            else if (type == "double") return 8;
+            else throw new G25.UserException("The size of floating point type '" + type + "' is unknown (only float and double are supported here).");
+        }
+
         public double PrecisionEpsilon()
         {
             if (type == "double") return 1e-14;
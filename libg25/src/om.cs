@@ -36,6 +36,11 @@ namespace G25
     /// </summary>
     public class OM : VariableType
     {
+        /// <summary>
+        /// The default SIMD width (in floating point values) used by the aligned layout.
+        /// </summary>
+        public const int DEFAULT_SIMD_WIDTH = 4;
+
         /// <summary>
         /// Constructor. Do not use directly. Use the constructors of G25.GOM and
         /// G25.SOM instead.
@@ -306,9 +311,60 @@ namespace G25
         /// <summary>
         /// Returns index into matrix of gradeIdx for entry [domainIdx, rangeIdx]  or 
         /// if matrix is not transposed: [column, row]
+        /// 
+        /// With the aligned layout (see SetAlignedLayout()), the matrix is stored column-major
+        /// with a column stride of ColumnStride(gradeIdx).
         /// </summary>
         public int getCoordinateIndex(int gradeIdx, int domainIdx, int rangeIdx) {
-            return DomainForGrade(gradeIdx).Length * rangeIdx + domainIdx;
+            if (AlignedLayout) return ColumnStride(gradeIdx) * domainIdx + rangeIdx;
+            else return DomainForGrade(gradeIdx).Length * rangeIdx + domainIdx;
+        }
+
+        /// <summary>
+        /// Switches this OM to the aligned layout: each matrix is stored column-major (the image of
+        /// each domain blade is contiguous), and each column is padded to a multiple of <paramref name="simdWidth"/>
+        /// coordinates. This allows the application of the OM to be vectorized.
+        /// </summary>
+        /// <param name="simdWidth">The number of floating point values in a SIMD register (for example, 4 or 8).</param>
+        public void SetAlignedLayout(int simdWidth)
+        {
+            if ((simdWidth < 1) || ((simdWidth & (simdWidth - 1)) != 0))
+                throw new G25.UserException("In outermorphism type " + Name + ":\n" +
+                    "Invalid SIMD width " + simdWidth + " (must be a power of two).");
+            m_simdWidth = simdWidth;
+        }
+
+        /// <summary>Whether the matrices of this OM are stored in the aligned, column-major layout.</summary>
+        public bool AlignedLayout { get { return m_simdWidth > 0; } }
+
+        /// <summary>The number of floating point values each column is padded to (0 when AlignedLayout is false).</summary>
+        public int SimdWidth { get { return m_simdWidth; } }
+
+        /// <returns>Distance between the start of two consecutive columns of the matrix for grade 'g' (aligned layout only).</returns>
+        public int ColumnStride(int g)
+        {
+            int nbRows = RangeForGrade(g).Length;
+            if (!AlignedLayout) return nbRows;
+            else return ((nbRows + m_simdWidth - 1) / m_simdWidth) * m_simdWidth;
+        }
+
+        /// <summary>
+        /// Switches this OM to lazy construction: only the grade 1 matrix is computed when the OM is set
+        /// from vector images or a matrix. Higher grade matrices are computed on first use.
+        /// </summary>
+        public void SetLazy()
+        {
+            m_lazy = true;
+        }
+
+        /// <summary>Whether the higher grade matrices of this OM are computed on first use (see SetLazy()).</summary>
+        public bool Lazy { get { return m_lazy; } }
+
+        /// <returns>The number of floating point values required to store the matrix for grade 'g' (including padding).</returns>
+        public int MatrixSize(int g)
+        {
+            if (AlignedLayout) return DomainForGrade(g).Length * ColumnStride(g);
+            else return DomainForGrade(g).Length * RangeForGrade(g).Length;
         }
 
 
@@ -330,6 +386,16 @@ namespace G25
 
         protected readonly G25.SMVOM[][] m_domainSmv;
 
+        /// <summary>
+        /// When larger than 0, the matrices are stored column-major, with each column padded to a multiple of m_simdWidth.
+        /// </summary>
+        protected int m_simdWidth = 0;
+
+        /// <summary>
+        /// When true, the higher grade matrices are computed on first use.
+        /// </summary>
+        protected bool m_lazy = false;
+
         /// <summary>
         /// The vectors that span the domain of this OM.
         /// </summary>
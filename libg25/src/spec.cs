@@ -224,6 +224,20 @@ namespace G25
             if ((m_namespace == null) || (m_namespace.Length < 1))
                 throw new G25.UserException("No namespace set (use XML attribute '" + XML.XML_NAMESPACE + "').");
 
+            // source shards
+            if (m_nbSourceShards < 1)
+                throw new G25.UserException("Invalid number of source files " + m_nbSourceShards + " (use XML attribute '" + XML.XML_SOURCE_SHARDS + "').");
+            if ((m_nbSourceShards > 1) && (!OutputCppOrC()))
+                throw new G25.UserException("Splitting the source code over multiple files is only supported for C and C++ (XML attribute '" + XML.XML_SOURCE_SHARDS + "').");
+
+            // benchmark suite
+            if (m_generateBenchmarkSuite && (!OutputCpp()))
+                throw new G25.UserException("The benchmark suite is only supported for C++ (XML attribute '" + XML.XML_BENCHMARK_SUITE + "').");
+
+            // instrumentation
+            if (m_instrumentation && (!OutputCpp()))
+                throw new G25.UserException("Instrumentation is only supported for C++ (XML attribute '" + XML.XML_INSTRUMENTATION + "').");
+
             // float types
             if ((m_floatTypes == null) || (m_floatTypes.Count == 0))
                 throw new G25.UserException("No float type set (use XML element '" + XML.XML_FLOAT_TYPE + "').");
@@ -248,6 +262,11 @@ namespace G25
             }
 
             // check general outermorphism
+            if ((m_GOM != null) && m_GOM.AlignedLayout && (!OutputCpp()))
+                throw new G25.UserException("The aligned outermorphism layout is only supported for C++ (XML attribute '" + XML.XML_LAYOUT + "').");
+            if ((m_GOM != null) && m_GOM.Lazy && (!OutputCpp()))
+                throw new G25.UserException("Lazy outermorphisms are only supported for C++ (XML attribute '" + XML.XML_LAZY + "').");
+
             if (m_GOM != null)
             {
                 if (m_gmvCodeGeneration == GMV_CODE.RUNTIME)
@@ -1099,15 +1118,44 @@ namespace G25
         /// <param name="customName"></param>
         public void SetOutputFilename(string defaultName, string customName)
         {
+            if ((defaultName.IndexOf('*') >= 0) && (!m_outputFilenameOverrides.ContainsKey(defaultName)))
+                m_outputFilenameWildcards.Add(defaultName);
             m_outputFilenameOverrides[defaultName] = customName;
         }
 
+        /// <summary>
+        /// Overrides are first looked up by exact name. If that fails, overrides which contain
+        /// a wildcard ('*') in their default name are tried. This is used to name the
+        /// source shards (e.g., <c>defaultName="c3ga_functions_*.cpp" customName="fn_*.cpp"</c>).
+        /// The text matched by the wildcard is substituted for the '*' in the custom name.
+        /// 
+        /// When several wildcard overrides match, the most specific one (the one with the most
+        /// characters outside the wildcard) is used. Of equally specific overrides, the one declared first is used.
+        /// </summary>
         /// <returns>output filename of file 'defaultName', with possible override.</returns>
         public string GetOutputFilename(string defaultName)
         {
             if (m_outputFilenameOverrides.ContainsKey(defaultName))
                 return m_outputFilenameOverrides[defaultName];
-            else return defaultName;
+
+            string bestName = defaultName;
+            int bestLength = -1;
+            foreach (string pattern in m_outputFilenameWildcards)
+            {
+                int wcIdx = pattern.IndexOf('*');
+                string prefix = pattern.Substring(0, wcIdx);
+                string suffix = pattern.Substring(wcIdx + 1);
+                if ((defaultName.Length >= prefix.Length + suffix.Length) &&
+                    defaultName.StartsWith(prefix) && defaultName.EndsWith(suffix) &&
+                    (prefix.Length + suffix.Length > bestLength))
+                {
+                    string match = defaultName.Substring(prefix.Length, defaultName.Length - prefix.Length - suffix.Length);
+                    bestName = m_outputFilenameOverrides[pattern].Replace("*", match);
+                    bestLength = prefix.Length + suffix.Length;
+                }
+            }
+
+            return bestName;
         }
 
         /// <remarks>First defaultName is possibly overriden using GetOutputFilename().
@@ -1229,6 +1277,12 @@ namespace G25
         /// </summary>
         public bool m_reportUsage;
 
+        /// <summary>
+        /// When true, call counting and timing code is added to every generated function (C++ only).
+        /// The code is only compiled when <c>NS_INSTRUMENTATION</c> is defined.
+        /// </summary>
+        public bool m_instrumentation = false;
+
         /// <summary>
         /// What type of code to generate for general multivector functions
         /// (fully expand, or do stuff at run-time to save code size)
@@ -1246,6 +1300,19 @@ namespace G25
         /// </summary>
         public bool m_generateTestSuite = false;
 
+        /// <summary>
+        /// When true, a benchmark suite will be generated (C++ only).
+        /// It times every generated function on random inputs.
+        /// </summary>
+        public bool m_generateBenchmarkSuite = false;
+
+        /// <summary>
+        /// Number of source files over which the definitions are split (C and C++ only).
+        /// When larger than 1, the definitions are grouped by function family (parts, set functions,
+        /// converters, functions) and each family is split over at most this many source files,
+        /// such that they can be compiled in parallel.
+        /// </summary>
+        public int m_nbSourceShards = 1;
 
 
         /// <summary>Whether to inline the constructors.</summary>
@@ -1320,6 +1387,11 @@ namespace G25
         /// </summary>
         public Dictionary<string, string> m_outputFilenameOverrides = new Dictionary<string, string>();
 
+        /// <summary>
+        /// The keys of m_outputFilenameOverrides which contain a wildcard, in declaration order.
+        /// </summary>
+        public List<string> m_outputFilenameWildcards = new List<string>();
+
         /// <summary>
         /// Verbatim code fragments that should be inserted into output files.
         /// </summary>
@@ -0,0 +1,179 @@
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+// Copyright 2008-2010, Daniel Fontijne, University of Amsterdam -- fontijne@science.uva.nl
+
+using System;
+using System.Collections.Generic;
+using System.Text;
+using System.Xml;
+using System.IO;
+
+namespace G25
+{
+    /// <summary>
+    /// A usage report, as printed by the <c>ReportUsage</c> class of the generated code
+    /// (see Specification.m_reportUsage).
+    ///
+    /// Each line of the report contains a <c>function</c> element for a function which was called with
+    /// specialized multivectors that had to be converted to general multivectors, followed by a comment
+    /// which says how often that happened. For example:
+    /// <code>
+    /// &lt;function name="gp" arg1="normalizedPoint" arg2="vectorE3GA" floatType="float"/&gt;  &lt;!-- used 512 times --&gt;
+    /// </code>
+    /// Lines which do not contain a <c>function</c> element are ignored.
+    /// Reports of multiple runs can be concatenated; the counts of equal functions are summed.
+    ///
+    /// AddToSpecification() adds the most frequently used functions to a specification, such that
+    /// the next version of the generated code contains optimized versions of them.
+    /// </summary>
+    public class UsageReport
+    {
+        /// <summary>
+        /// A function from the report, and how often it was used.
+        /// </summary>
+        public class Entry : IComparable<Entry>
+        {
+            public Entry(string xml, long count)
+            {
+                m_xml = xml;
+                m_count = count;
+            }
+
+            /// <summary>
+            /// Sorts on count (descending), then on XML string.
+            /// </summary>
+            public int CompareTo(Entry E)
+            {
+                if (m_count != E.m_count) return (m_count > E.m_count) ? -1 : 1;
+                else return String.CompareOrdinal(m_xml, E.m_xml);
+            }
+
+            /// <summary>The <c>function</c> element.</summary>
+            public string m_xml;
+            /// <summary>How often the function was used.</summary>
+            public long m_count;
+        }
+
+        /// <summary>
+        /// Reads the usage report from <paramref name="filename"/>.
+        /// </summary>
+        public UsageReport(string filename)
+        {
+            string[] lines;
+            try
+            {
+                lines = File.ReadAllLines(filename);
+            }
+            catch (System.Exception E)
+            {
+                throw new G25.UserException("Error reading usage report '" + filename + "': " + E.Message);
+            }
+
+            Dictionary<string, Entry> D = new Dictionary<string, Entry>();
+            foreach (string line in lines)
+            {
+                int startIdx = line.IndexOf("<" + XML.XML_FUNCTION + " ");
+                if (startIdx < 0) continue;
+                int endIdx = line.IndexOf("/>", startIdx);
+                if (endIdx < 0) continue;
+                string xml = line.Substring(startIdx, endIdx + 2 - startIdx);
+
+                long count = ParseCount(line.Substring(endIdx + 2));
+
+                Entry E;
+                if (D.TryGetValue(xml, out E)) E.m_count += count;
+                else D[xml] = new Entry(xml, count);
+            }
+
+            m_entries = new List<Entry>(D.Values);
+            m_entries.Sort();
+        }
+
+        /// <summary>
+        /// Returns the count from the comment which follows the <c>function</c> element
+        /// (<c>&lt;!-- used N times --&gt;</c>). Returns 1 when there is no count.
+        /// </summary>
+        private static long ParseCount(string comment)
+        {
+            const string USED = "used ";
+            int idx = comment.IndexOf(USED);
+            if (idx < 0) return 1;
+            idx += USED.Length;
+            int endIdx = idx;
+            while ((endIdx < comment.Length) && Char.IsDigit(comment[endIdx])) endIdx++;
+            long count;
+            if (!Int64.TryParse(comment.Substring(idx, endIdx - idx), out count)) return 1;
+            return count;
+        }
+
+        /// <summary>
+        /// Adds the (at most) <paramref name="maxNbFunctions"/> most frequently used functions
+        /// which are not yet present to <paramref name="S"/>.
+        /// </summary>
+        /// <param name="S">The specification (typically loaded from the specification which generated the code that produced the report).</param>
+        /// <param name="maxNbFunctions">Maximum number of functions to add (all when less than 0).</param>
+        /// <returns>The entries that were added, most frequently used first.</returns>
+        public List<Entry> AddToSpecification(Specification S, int maxNbFunctions)
+        {
+            List<Entry> added = new List<Entry>();
+            foreach (Entry E in m_entries)
+            {
+                if ((maxNbFunctions >= 0) && (added.Count >= maxNbFunctions)) break;
+
+                // parse the function (XML.ParseFunction() adds it to S.m_functions)
+                XmlDocument doc = new XmlDocument();
+                try
+                {
+                    doc.LoadXml(E.m_xml);
+                }
+                catch (System.Exception Ex)
+                {
+                    throw new G25.UserException("Error parsing usage report: " + Ex.Message, E.m_xml);
+                }
+                int nbFunctions = S.m_functions.Count;
+                XML.ParseFunction(S, doc.DocumentElement);
+                fgs F = S.m_functions[nbFunctions];
+
+                if (IsPresent(S, F, nbFunctions)) S.m_functions.RemoveAt(nbFunctions);
+                else added.Add(E);
+            }
+            return added;
+        }
+
+        /// <returns>true when one of the first <paramref name="nbFunctions"/> functions of <paramref name="S"/> is
+        /// equal to <paramref name="F"/> for all float types of <paramref name="F"/> (the comment and output name are ignored).</returns>
+        private static bool IsPresent(Specification S, fgs F, int nbFunctions)
+        {
+            for (int i = 0; i < nbFunctions; i++)
+            {
+                fgs G = S.m_functions[i];
+                if ((G.Name != F.Name) || (G.MetricName != F.MetricName) || (G.ReturnTypeName != F.ReturnTypeName)) continue;
+                if (fgs.CompareArrays(G.ArgumentTypeNames, F.ArgumentTypeNames) != 0) continue;
+
+                bool allFloatTypes = true;
+                foreach (string floatName in F.FloatNames)
+                    if (Array.IndexOf(G.FloatNames, floatName) < 0) allFloatTypes = false;
+                if (allFloatTypes) return true;
+            }
+            return false;
+        }
+
+        /// <summary>All functions in the report, most frequently used first.</summary>
+        public List<Entry> Entries { get { return m_entries; } }
+
+        /// <summary>All functions in the report, most frequently used first.</summary>
+        protected List<Entry> m_entries;
+    } // end of class UsageReport
+} // end of namespace G25
@@ -50,11 +50,14 @@ namespace G25
         public const string XML_FALSE = "false";
         public const string XML_DIMENSION = "dimension";
         public const string XML_REPORT_USAGE = "reportUsage";
+        public const string XML_INSTRUMENTATION = "instrumentation";
         public const string XML_GMV_CODE = "gmvCode";
         public const string XML_EXPAND = "expand";
         public const string XML_RUNTIME = "runtime";
         public const string XML_PARSER = "parser";
         public const string XML_TEST_SUITE = "testSuite";
+        public const string XML_SOURCE_SHARDS = "sourceShards";
+        public const string XML_BENCHMARK_SUITE = "benchmarkSuite";
         public const string XML_NONE = "none";
         public const string XML_ANTLR = "antlr";
         public const string XML_BUILTIN = "builtin";
@@ -105,6 +108,11 @@ namespace G25
         public const string XML_SOM = "som";
         public const string XML_DOMAIN = "domain";
         public const string XML_RANGE = "range";
+        public const string XML_LAYOUT = "layout";
+        public const string XML_PACKED = "packed";
+        public const string XML_ALIGNED = "aligned";
+        public const string XML_SIMD_WIDTH = "simdWidth";
+        public const string XML_LAZY = "lazy";
         public const string XML_RETURN_TYPE = "returnType";
         public const string XML_SCALAR = "scalar";
         public const string XML_OUTPUT_DIRECTORY = "outputDirectory";
@@ -174,6 +182,10 @@ namespace G25
                 // report usage of non-optimized functions
                 SB.Append("\t" + XML_REPORT_USAGE + "=\"" + (S.m_reportUsage ? XML_TRUE : XML_FALSE) + "\"\n");
 
+                // count calls and time spent in functions
+                if (S.m_instrumentation)
+                    SB.Append("\t" + XML_INSTRUMENTATION + "=\"" + XML_TRUE + "\"\n");
+
                 { // what type of GMV code to generate:
                     SB.Append("\t" + XML_GMV_CODE + "=\"");
                     switch (S.m_gmvCodeGeneration)
@@ -200,6 +212,14 @@ namespace G25
                 // generate test suite
                 SB.Append("\t" + XML_TEST_SUITE + "=\"" + (S.m_generateTestSuite ? XML_TRUE : XML_FALSE) + "\"\n");
 
+                // generate benchmark suite
+                if (S.m_generateBenchmarkSuite)
+                    SB.Append("\t" + XML_BENCHMARK_SUITE + "=\"" + XML_TRUE + "\"\n");
+
+                // split source over multiple files
+                if (S.m_nbSourceShards > 1)
+                    SB.Append("\t" + XML_SOURCE_SHARDS + "=\"" + S.m_nbSourceShards.ToString() + "\"\n");
+
             }
 
             SB.Append("\t>\n"); // end of <g25spec> entry
@@ -455,6 +475,15 @@ namespace G25
                     bool defaultCoordOrder = rangeEqualsDomain && om.CompareDomainOrder(rsbbp.ListToDoubleArray(S.m_basisBladeParser.GetDefaultBasisBlades()));
                     SB.Append(" " + XML_COORDINATE_ORDER + "=\"" + ((defaultCoordOrder) ? XML_DEFAULT : XML_CUSTOM) + "\"");
 
+                    // layout:
+                    if (om.AlignedLayout)
+                    {
+                        SB.Append(" " + XML_LAYOUT + "=\"" + XML_ALIGNED + "\"");
+                        SB.Append(" " + XML_SIMD_WIDTH + "=\"" + om.SimdWidth + "\"");
+                    }
+                    if (om.Lazy)
+                        SB.Append(" " + XML_LAZY + "=\"" + XML_TRUE + "\"");
+
                     // end of XMLtag
                     SB.Append(">\n");
 
@@ -858,6 +887,9 @@ namespace G25
                     case XML_REPORT_USAGE:
                         S.m_reportUsage = (A[i].Value.ToLower() == XML_TRUE);
                         break;
+                    case XML_INSTRUMENTATION:
+                        S.m_instrumentation = (A[i].Value.ToLower() == XML_TRUE);
+                        break;
                     case XML_GMV_CODE:
                         if (A[i].Value.ToLower() == XML_RUNTIME)
                             S.m_gmvCodeGeneration = GMV_CODE.RUNTIME;
@@ -877,6 +909,16 @@ namespace G25
                     case XML_TEST_SUITE:
                         S.m_generateTestSuite = (A[i].Value.ToLower() == XML_TRUE);
                         break;
+                    case XML_BENCHMARK_SUITE:
+                        S.m_generateBenchmarkSuite = (A[i].Value.ToLower() == XML_TRUE);
+                        break;
+                    case XML_SOURCE_SHARDS:
+                        try
+                        {
+                            S.m_nbSourceShards = System.Int32.Parse(A[i].Value);
+                        }
+                        catch (System.Exception) { throw new G25.UserException("Invalid number of source files: '" + A[i].Value + "'."); }
+                        break;
                     default:
                         throw new G25.UserException("XML parsing error: Unknown XML attribute '" + A[i].Name + "' in root element '" + XML_G25_SPEC + "'.");
                 }
@@ -1400,6 +1442,9 @@ namespace G25
         {
             String name = null;
             bool defaultCoordinateOrder = false; // false means 'custom'
+            bool alignedLayout = false;
+            int simdWidth = OM.DEFAULT_SIMD_WIDTH;
+            bool lazy = false;
 
             { // handle attributes
                 XmlAttributeCollection A = E.Attributes;
@@ -1420,6 +1465,27 @@ namespace G25
                             defaultCoordinateOrder = false;
                         else throw new G25.UserException("XML parsing error: Invalid coordinate order '" + A[i].Value + "' in element '" + E.Name + "'.");
                     }
+
+                    // layout
+                    else if (A[i].Name == XML_LAYOUT)
+                    {
+                        if (A[i].Value == XML_ALIGNED)
+                            alignedLayout = true;
+                        else if (A[i].Value == XML_PACKED)
+                            alignedLayout = false;
+                        else throw new G25.UserException("XML parsing error: Invalid layout '" + A[i].Value + "' in element '" + E.Name + "'.");
+                    }
+
+                    // SIMD width
+                    else if (A[i].Name == XML_SIMD_WIDTH)
+                    {
+                        if (!Int32.TryParse(A[i].Value, out simdWidth))
+                            throw new G25.UserException("XML parsing error: Invalid SIMD width '" + A[i].Value + "' in element '" + E.Name + "'.");
+                    }
+
+                    // lazy
+                    else if (A[i].Name == XML_LAZY)
+                        lazy = (A[i].Value.ToLower() == XML_TRUE);
                 }
             } // end of 'handle attributes'
 
@@ -1468,8 +1534,20 @@ namespace G25
             if (range == null) range = domain;
 
             if (specialized)
+            {
+                if (alignedLayout)
+                    throw new G25.UserException("XML parsing error: The '" + XML_LAYOUT + "' attribute can only be used on general outermorphisms (name=" + name + ").");
+                if (lazy)
+                    throw new G25.UserException("XML parsing error: The '" + XML_LAZY + "' attribute can only be used on general outermorphisms (name=" + name + ").");
                 return new SOM(name, rsbbp.ListToSingleArray(domain), rsbbp.ListToSingleArray(range), S.m_dimension);
-            else return new GOM(name, rsbbp.ListToSingleArray(domain), rsbbp.ListToSingleArray(range), S.m_dimension);
+            }
+            else
+            {
+                GOM gom = new GOM(name, rsbbp.ListToSingleArray(domain), rsbbp.ListToSingleArray(range), S.m_dimension);
+                if (alignedLayout) gom.SetAlignedLayout(simdWidth);
+                if (lazy) gom.SetLazy();
+                return gom;
+            }
         } // end of ParseOMelementAndAttributes()
 
 
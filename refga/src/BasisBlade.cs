@@ -151,6 +151,36 @@ namespace RefGA
             m_hashCode = ComputeHashCode();
         }
 
+        /// <summary>
+        /// Creates a copy of <paramref name="B"/> in which the String factors of the symbolic scale are replaced according 
+        /// to <paramref name="names"/> (factors which are not in <paramref name="names"/> are kept).
+        /// The symbolic scale is not simplified again, so its structure is exactly that of <paramref name="B"/>.
+        /// </summary>
+        public BasisBlade(BasisBlade B, Dictionary<String, String> names)
+        {
+            m_bitmap = B.m_bitmap;
+            m_scale = B.m_scale;
+            if (B.m_symScale == null) m_symScale = null;
+            else
+            {
+                m_symScale = new Object[B.m_symScale.Length][];
+                for (int i = 0; i < m_symScale.Length; i++)
+                {
+                    Object[] T = B.m_symScale[i];
+                    if (T == null) continue;
+                    m_symScale[i] = new Object[T.Length];
+                    for (int j = 0; j < T.Length; j++)
+                    {
+                        String newName;
+                        if ((T[j] is String) && names.TryGetValue((String)T[j], out newName))
+                            m_symScale[i][j] = newName;
+                        else m_symScale[i][j] = T[j];
+                    }
+                }
+            }
+            m_hashCode = ComputeHashCode();
+        }
+
         /// <summary>Creates a new basis blade from a symbolic scale</summary>
         /// <param name="symScale">Single symbolic scale String. I.e., it would be symScale[0][0] in the constructor which accepts an array of ararys.</param>
        public BasisBlade(String symScale) : this(0, 1.0, symScale) { }
@@ -718,6 +748,9 @@ namespace RefGA
        /// <summary>
        ///  'Simplifies' an ArrayList of BasisBlades. I.e., sums scale of BasisBlades with identical bitmaps.
        /// Can also process symbolic scalars.
+       /// 
+       /// The basis blades are grouped by bitmap using a hash table, so only the (unique) summed
+       /// basis blades have to be sorted, instead of all basis blades in <paramref name="A"/>.
        /// </summary>
        /// <param name="A">ArrayList of BasisBlades (no other types of objects should be in the array).</param>
        /// <returns>Sorted, Simplified ArrayList of BasisBlades</returns>
@@ -725,53 +758,51 @@ namespace RefGA
        {
            if (A.Count == 0) return A;
 
-           // sort  basis blade in A such that those blade with the same bitmap are next to eachother
-           A.Sort();
-
+           // group basis blades with identical bitmaps
+           Dictionary<uint, List<BasisBlade>> groups = new Dictionary<uint, List<BasisBlade>>();
+           List<uint> bitmaps = new List<uint>(); // bitmaps in order of first appearance
+           for (int i = 0; i < A.Count; i++)
+           {
+               BasisBlade B = (BasisBlade)A[i];
+               List<BasisBlade> G;
+               if (!groups.TryGetValue(B.bitmap, out G))
+               {
+                   G = new List<BasisBlade>();
+                   groups[B.bitmap] = G;
+                   bitmaps.Add(B.bitmap);
+               }
+               G.Add(B);
+           }
 
-           // loop over all basis blades in A, summing basis blades with identical bitmaps, storing the result in 'result'
-           ArrayList result = new ArrayList();
+           // sum the basis blades of each group, storing the result in 'result'
+           ArrayList result = new ArrayList(bitmaps.Count);
            {
                // allocate memory to store the scales
-               int scalesIdx = 0;
                double[] scales = new double[A.Count];
                Object[][][] symScales = new Object[A.Count][][];
 
-               uint currentBitmap = ((BasisBlade)A[0]).bitmap;
-
-               // keep scale and sym scale in arrays?
-               scales[scalesIdx] = ((BasisBlade)A[0]).scale;
-               symScales[scalesIdx] = ((BasisBlade)A[0]).symScale;
-               scalesIdx++;
-
-               for (int i = 1; i < A.Count; i++) // loop over all basis blades in A, summing basis blades with identical bitmaps, storing the result in 'result'
+               foreach (uint bitmap in bitmaps)
                {
-                   BasisBlade B = (BasisBlade)A[i];
-                   if (B.bitmap == currentBitmap)
-                   {
-                       scales[scalesIdx] = B.scale;
-                       symScales[scalesIdx] = B.symScale;
-                       scalesIdx++;
+                   List<BasisBlade> G = groups[bitmap];
+                   if ((G.Count == 1) && (!G[0].IsSymbolic()))
+                   { // nothing to sum
+                       if (G[0].scale != 0.0) result.Add(G[0]);
+                       continue;
                    }
-                   else
-                   {
-                       BasisBlade sum = SumScales(currentBitmap, scales, symScales, scalesIdx);
-                       if ((sum != null) && (sum.scale != 0.0)) result.Add(sum);
-
-                       currentBitmap = B.bitmap;
 
-                       scalesIdx = 0;
-                       scales[scalesIdx] = B.scale;
-                       symScales[scalesIdx] = B.symScale;
-                       scalesIdx++;
+                   for (int i = 0; i < G.Count; i++)
+                   {
+                       scales[i] = G[i].scale;
+                       symScales[i] = G[i].symScale;
                    }
-               }
-
-               { // handle leftover from loop:
-                   BasisBlade sum = SumScales(currentBitmap, scales, symScales, scalesIdx);
+                   BasisBlade sum = SumScales(bitmap, scales, symScales, G.Count);
                    if ((sum != null) && (sum.scale != 0.0)) result.Add(sum);
                }
            }
+
+           // sort the summed basis blades (bitmaps are unique, so this sorts on grade and bitmap)
+           result.Sort();
+
            return result;
        }
 
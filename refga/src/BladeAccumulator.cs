@@ -0,0 +1,224 @@
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+// Copyright 2008-2010, Daniel Fontijne, University of Amsterdam -- fontijne@science.uva.nl
+
+using System;
+using System.Collections.Generic;
+using System.Text;
+using System.Collections;
+
+namespace RefGA
+{
+    /// <summary>
+    /// Sums the products of the BasisBlades of two multivectors as they are produced, instead of collecting 
+    /// all of them in a list and simplifying afterwards (see BasisBlade.Simplify()).
+    ///
+    /// The blades are accumulated in an open-addressing hash table keyed on the bitmap. Each slot of the
+    /// table is a struct which holds the sum of the numerical scales of the blades with that bitmap,
+    /// and the sum of their symbolic scales (if any). The symbolic scales are summed as typed Symbolic.Polynomials, 
+    /// so memory usage is bounded by the size of the result (the number of distinct bitmaps and symbolic terms), 
+    /// instead of the number of blade-blade products.
+    /// 
+    /// The numerical part and the symbolic part of each product are computed separately: Split() converts
+    /// the symbolic scales of the operands to Polynomials once, and the product of two blades is then
+    /// added as the product of their numerical parts (a BasisBlade without symbolic scale), times the 
+    /// product of their Polynomials (see Add()). Hence the factors of the symbolic scales are interned only once 
+    /// per operand blade, instead of once per product. The SymbolTable is owned by the accumulator,
+    /// so it lives only as long as the computation of a single product.
+    ///
+    /// Used by Multivector.GeometricProduct(), Multivector.OuterProduct() and Multivector.InnerProduct().
+    /// </summary>
+    public class BladeAccumulator
+    {
+        /// <param name="expectedNbBlades">The expected number of distinct bitmaps (used to size the hash table).</param>
+        public BladeAccumulator(int expectedNbBlades)
+        {
+            int capacity = 8;
+            while ((capacity < 2 * expectedNbBlades) && (capacity < INITIAL_CAPACITY_LIMIT))
+                capacity *= 2;
+            SetSlots(new Slot[capacity]);
+            m_table = new Symbolic.SymbolTable();
+        }
+
+        /// <summary>
+        /// Splits the basis blades of <paramref name="A"/> into their numerical part and their symbolic scale.
+        /// </summary>
+        /// <param name="A">Operand of the product.</param>
+        /// <param name="P">The symbolic scale of each basis blade (null when the blade is not symbolic).</param>
+        /// <returns>The basis blades of <paramref name="A"/> without their symbolic scale.</returns>
+        public BasisBlade[] Split(Multivector A, out Symbolic.Polynomial[] P)
+        {
+            BasisBlade[] BL = A.BasisBlades;
+            BasisBlade[] N = new BasisBlade[BL.Length];
+            P = new Symbolic.Polynomial[BL.Length];
+            for (int i = 0; i < BL.Length; i++)
+            {
+                BasisBlade B = BL[i];
+                if (B.IsSymbolic())
+                {
+                    N[i] = new BasisBlade(B.bitmap, B.scale);
+                    P[i] = new Symbolic.Polynomial(m_table, B.symScale);
+                }
+                else N[i] = B;
+            }
+            return N;
+        }
+
+        /// <summary>
+        /// Adds <paramref name="B"/> * <paramref name="PA"/> * <paramref name="PB"/> to the sum. 
+        /// Blades with a zero scale are ignored.
+        /// </summary>
+        /// <param name="B">Product of the numerical parts of the operands (must not be symbolic).</param>
+        /// <param name="PA">Symbolic scale of the first operand (null when not symbolic; see Split()).</param>
+        /// <param name="PB">Symbolic scale of the second operand (null when not symbolic; see Split()).</param>
+        public void Add(BasisBlade B, Symbolic.Polynomial PA, Symbolic.Polynomial PB)
+        {
+            if (B.scale == 0.0) return;
+
+            int idx = FindSlot(B.bitmap);
+            if (!m_slots[idx].used)
+            {
+                m_slots[idx].used = true;
+                m_slots[idx].bitmap = B.bitmap;
+                m_nbUsed++;
+            }
+
+            if ((PA == null) && (PB == null))
+                m_slots[idx].scale += B.scale;
+            else
+            {
+                if (m_slots[idx].symSum == null)
+                    m_slots[idx].symSum = new Symbolic.Polynomial(m_table);
+                if (PA == null) m_slots[idx].symSum.Add(PB, B.scale);
+                else if (PB == null) m_slots[idx].symSum.Add(PA, B.scale);
+                else m_slots[idx].symSum.AddProduct(PA, PB, B.scale);
+            }
+
+            if (2 * m_nbUsed > m_slots.Length) Grow();
+        }
+
+        /// <summary>
+        /// Adds all BasisBlades in <paramref name="L"/>, times <paramref name="PA"/> * <paramref name="PB"/>, to the sum.
+        /// </summary>
+        public void Add(ArrayList L, Symbolic.Polynomial PA, Symbolic.Polynomial PB)
+        {
+            foreach (BasisBlade B in L)
+                Add(B, PA, PB);
+        }
+
+        /// <returns>The sum of all blades added so far (sorted, zero blades removed).</returns>
+        public Multivector ToMultivector()
+        {
+            List<BasisBlade> L = new List<BasisBlade>(m_nbUsed);
+            for (int i = 0; i < m_slots.Length; i++)
+            {
+                if (!m_slots[i].used) continue;
+                BasisBlade B;
+                if (m_slots[i].symSum == null)
+                {
+                    if (m_slots[i].scale == 0.0) continue;
+                    B = new BasisBlade(m_slots[i].bitmap, m_slots[i].scale);
+                }
+                else
+                {
+                    m_slots[i].symSum.Add(m_slots[i].scale); // the sum of the non-symbolic blades is the constant term
+                    Object[][] symScale = m_slots[i].symSum.ToSymbolicScalar();
+                    if (symScale == null) continue;
+                    B = new BasisBlade(m_slots[i].bitmap, 1.0, symScale);
+                    if (B.scale == 0.0) continue;
+                }
+                L.Add(B);
+            }
+            L.Sort(); // sorts on grade and bitmap (the bitmaps are unique)
+            return new Multivector(L.ToArray());
+        }
+
+        /// <returns>Index of the slot which holds <paramref name="bitmap"/>, or the index of the free slot where it should go.</returns>
+        private int FindSlot(uint bitmap)
+        {
+            int mask = m_slots.Length - 1;
+            int idx = (int)(unchecked(bitmap * 2654435761u) >> m_shift); // multiplicative hashing (uses the high bits)
+            while (m_slots[idx].used && (m_slots[idx].bitmap != bitmap))
+                idx = (idx + 1) & mask; // linear probing
+            return idx;
+        }
+
+        /// <summary>
+        /// Doubles the size of the hash table.
+        /// </summary>
+        private void Grow()
+        {
+            Slot[] oldSlots = m_slots;
+            SetSlots(new Slot[oldSlots.Length * 2]);
+            for (int i = 0; i < oldSlots.Length; i++)
+            {
+                if (!oldSlots[i].used) continue;
+                m_slots[FindSlot(oldSlots[i].bitmap)] = oldSlots[i];
+            }
+        }
+
+        /// <summary>
+        /// Sets the hash table to <paramref name="slots"/> and computes the matching m_shift.
+        /// </summary>
+        private void SetSlots(Slot[] slots)
+        {
+            m_slots = slots;
+            m_shift = 32;
+            for (int c = slots.Length; c > 1; c >>= 1)
+                m_shift--;
+        }
+
+        /// <summary>
+        /// The initial capacity of the hash table is not made larger than this;
+        /// the table grows when more distinct bitmaps are actually added.
+        /// </summary>
+        private const int INITIAL_CAPACITY_LIMIT = 1 << 12;
+
+        /// <summary>
+        /// A slot of the hash table.
+        /// </summary>
+        private struct Slot
+        {
+            /// <summary>true when this slot is in use.</summary>
+            public bool used;
+            /// <summary>Bitmap of the blades in this slot.</summary>
+            public uint bitmap;
+            /// <summary>Sum of the scales of the non-symbolic blades.</summary>
+            public double scale;
+            /// <summary>Sum of the symbolic scales (null when there are none).</summary>
+            public Symbolic.Polynomial symSum;
+        }
+
+        /// <summary>
+        /// The hash table (length is always a power of two).
+        /// </summary>
+        private Slot[] m_slots;
+
+        /// <summary>
+        /// 32 - log2(m_slots.Length); the hash is shifted right by this amount.
+        /// </summary>
+        private int m_shift;
+
+        /// <summary>
+        /// Number of slots in use.
+        /// </summary>
+        private int m_nbUsed;
+
+        /// <summary>
+        /// The table in which the factors of the symbolic scales are interned.
+        /// </summary>
+        private Symbolic.SymbolTable m_table;
+    } // end of class BladeAccumulator
+} // end of namespace RefGA
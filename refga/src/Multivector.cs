@@ -408,14 +408,14 @@ namespace RefGA
         /// <returns>outer product of <paramref name="A"/> and <paramref name="B"/></returns>
         public static Multivector OuterProduct(Multivector A, Multivector B)
         {
-            ArrayList L = new ArrayList();
-            foreach (BasisBlade a in A.BasisBlades)
-                foreach (BasisBlade b in B.BasisBlades) {
-                    BasisBlade c = BasisBlade.OuterProduct(a, b);
-                    if (c.scale != 0.0) L.Add(c);
-                }
+            BladeAccumulator L = new BladeAccumulator(A.BasisBlades.Length * B.BasisBlades.Length);
+            Symbolic.Polynomial[] PA, PB;
+            BasisBlade[] NA = L.Split(A, out PA), NB = L.Split(B, out PB);
+            for (int i = 0; i < NA.Length; i++)
+                for (int j = 0; j < NB.Length; j++)
+                    L.Add(BasisBlade.OuterProduct(NA[i], NB[j]), PA[i], PB[j]);
 
-            return new Multivector(BasisBlade.Simplify(L));
+            return L.ToMultivector();
         }
 
         /// <summary>
@@ -444,16 +444,14 @@ namespace RefGA
         /// <returns>geometric product of <paramref name="A"/> and <paramref name="B"/></returns>
         public static Multivector GeometricProduct(Multivector A, Multivector B)
         {
-            ArrayList L = new ArrayList();
-            foreach (BasisBlade a in A.BasisBlades)
-                foreach (BasisBlade b in B.BasisBlades)
-                {
-                    BasisBlade c = BasisBlade.GeometricProduct(a, b);
-                    //System.Console.WriteLine(a.ToString() + " " + b.ToString() + " = " + c.ToString());
-                    if (c.scale != 0.0) L.Add(c);
-                }
+            BladeAccumulator L = new BladeAccumulator(A.BasisBlades.Length * B.BasisBlades.Length);
+            Symbolic.Polynomial[] PA, PB;
+            BasisBlade[] NA = L.Split(A, out PA), NB = L.Split(B, out PB);
+            for (int i = 0; i < NA.Length; i++)
+                for (int j = 0; j < NB.Length; j++)
+                    L.Add(BasisBlade.GeometricProduct(NA[i], NB[j]), PA[i], PB[j]);
 
-            return new Multivector(BasisBlade.Simplify(L));
+            return L.ToMultivector();
         }
 
         /// <summary>
@@ -465,15 +463,14 @@ namespace RefGA
         /// <returns>geometric product of <paramref name="A"/> and <paramref name="B"/></returns>
         public static Multivector GeometricProduct(Multivector A, Multivector B, double[] m)
         {
-            ArrayList L = new ArrayList();
-            foreach (BasisBlade a in A.BasisBlades)
-                foreach (BasisBlade b in B.BasisBlades)
-                {
-                    BasisBlade c = BasisBlade.GeometricProduct(a, b, m);
-                    if (c.scale != 0.0) L.Add(c);
-                }
+            BladeAccumulator L = new BladeAccumulator(A.BasisBlades.Length * B.BasisBlades.Length);
+            Symbolic.Polynomial[] PA, PB;
+            BasisBlade[] NA = L.Split(A, out PA), NB = L.Split(B, out PB);
+            for (int i = 0; i < NA.Length; i++)
+                for (int j = 0; j < NB.Length; j++)
+                    L.Add(BasisBlade.GeometricProduct(NA[i], NB[j], m), PA[i], PB[j]);
 
-            return new Multivector(BasisBlade.Simplify(L));
+            return L.ToMultivector();
         }
 
         /// <summary>
@@ -485,14 +482,14 @@ namespace RefGA
         /// <returns>geometric product of <paramref name="A"/> and <paramref name="B"/></returns>
         public static Multivector GeometricProduct(Multivector A, Multivector B, Metric M)
         {
-            ArrayList L = new ArrayList();
-            foreach (BasisBlade a in A.BasisBlades)
-                foreach (BasisBlade b in B.BasisBlades)
-                {
-                    L.AddRange(BasisBlade.GeometricProduct(a, b, M));
-                }
+            BladeAccumulator L = new BladeAccumulator(A.BasisBlades.Length * B.BasisBlades.Length);
+            Symbolic.Polynomial[] PA, PB;
+            BasisBlade[] NA = L.Split(A, out PA), NB = L.Split(B, out PB);
+            for (int i = 0; i < NA.Length; i++)
+                for (int j = 0; j < NB.Length; j++)
+                    L.Add(BasisBlade.GeometricProduct(NA[i], NB[j], M), PA[i], PB[j]);
 
-            return new Multivector(BasisBlade.Simplify(L));
+            return L.ToMultivector();
         }
 
         /// <summary>
@@ -504,15 +501,14 @@ namespace RefGA
         /// <returns>Inner product of <paramref name="A"/> and <paramref name="B"/></returns>
         public static Multivector InnerProduct(Multivector A, Multivector B, BasisBlade.InnerProductType type)
         {
-            ArrayList L = new ArrayList();
-            foreach (BasisBlade a in A.BasisBlades)
-                foreach (BasisBlade b in B.BasisBlades)
-                {
-                    BasisBlade c = BasisBlade.InnerProduct(a, b, type);
-                    if (c.scale != 0.0) L.Add(c);
-                }
+            BladeAccumulator L = new BladeAccumulator(A.BasisBlades.Length * B.BasisBlades.Length);
+            Symbolic.Polynomial[] PA, PB;
+            BasisBlade[] NA = L.Split(A, out PA), NB = L.Split(B, out PB);
+            for (int i = 0; i < NA.Length; i++)
+                for (int j = 0; j < NB.Length; j++)
+                    L.Add(BasisBlade.InnerProduct(NA[i], NB[j], type), PA[i], PB[j]);
 
-            return new Multivector(BasisBlade.Simplify(L));            
+            return L.ToMultivector();
         }
 
         /// <summary>
@@ -525,15 +521,14 @@ namespace RefGA
         /// <returns>Inner product of <paramref name="A"/> and <paramref name="B"/></returns>
         public static Multivector InnerProduct(Multivector A, Multivector B, double[] m, BasisBlade.InnerProductType type)
         {
-            ArrayList L = new ArrayList();
-            foreach (BasisBlade a in A.BasisBlades)
-                foreach (BasisBlade b in B.BasisBlades)
-                {
-                    BasisBlade c = BasisBlade.InnerProduct(a, b, m, type);
-                    if (c.scale != 0.0) L.Add(c);
-                }
+            BladeAccumulator L = new BladeAccumulator(A.BasisBlades.Length * B.BasisBlades.Length);
+            Symbolic.Polynomial[] PA, PB;
+            BasisBlade[] NA = L.Split(A, out PA), NB = L.Split(B, out PB);
+            for (int i = 0; i < NA.Length; i++)
+                for (int j = 0; j < NB.Length; j++)
+                    L.Add(BasisBlade.InnerProduct(NA[i], NB[j], m, type), PA[i], PB[j]);
 
-            return new Multivector(BasisBlade.Simplify(L));           
+            return L.ToMultivector();
         }
 
         /// <summary>
@@ -546,14 +541,14 @@ namespace RefGA
         /// <returns>Inner product of <paramref name="A"/> and <paramref name="B"/></returns>
         public static Multivector InnerProduct(Multivector A, Multivector B, Metric M, BasisBlade.InnerProductType type)
         {
-            ArrayList L = new ArrayList();
-            foreach (BasisBlade a in A.BasisBlades)
-                foreach (BasisBlade b in B.BasisBlades)
-                {
-                    L.AddRange(BasisBlade.InnerProduct(a, b, M, type));
-                }
+            BladeAccumulator L = new BladeAccumulator(A.BasisBlades.Length * B.BasisBlades.Length);
+            Symbolic.Polynomial[] PA, PB;
+            BasisBlade[] NA = L.Split(A, out PA), NB = L.Split(B, out PB);
+            for (int i = 0; i < NA.Length; i++)
+                for (int j = 0; j < NB.Length; j++)
+                    L.Add(BasisBlade.InnerProduct(NA[i], NB[j], M, type), PA[i], PB[j]);
 
-            return new Multivector(BasisBlade.Simplify(L));            
+            return L.ToMultivector();
         }
 
         /// <summary>
@@ -0,0 +1,221 @@
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+// Copyright 2008-2010, Daniel Fontijne, University of Amsterdam -- fontijne@science.uva.nl
+
+using System;
+using System.Collections.Generic;
+using System.Text;
+
+namespace RefGA.Symbolic
+
+{
+    /// <summary>
+    /// Typed representation of a symbolic scalar (see BasisBlade.symScale): a sum of terms, where each term is
+    /// a Monomial of interned factors times a double coefficient.
+    /// 
+    /// Terms are merged as they are added: a hash table maps each Monomial to its term, and only the summed
+    /// coefficient is kept. All Monomials of a Polynomial, and all Polynomials which are combined, must use the
+    /// same SymbolTable.
+    /// 
+    /// Used by Util.SimplifySymbolicScalars() and BladeAccumulator. ToSymbolicScalar() converts back to the 
+    /// Object[][] representation which the rest of RefGA and the code generators use.
+    /// </summary>
+    public class Polynomial
+    {
+        /// <summary>
+        /// Constructs an empty polynomial (zero).
+        /// </summary>
+        /// <param name="table">The table in which the factors are interned.</param>
+        public Polynomial(SymbolTable table)
+        {
+            m_table = table;
+            m_termIdx = new Dictionary<Monomial, int>();
+            m_monomials = new List<Monomial>();
+            m_coefs = new List<double>();
+        }
+
+        /// <summary>
+        /// Constructs the polynomial of <paramref name="symScale"/>.
+        /// </summary>
+        /// <param name="table">The table in which the factors are interned.</param>
+        /// <param name="symScale">Symbolic scale (array of arrays, may be null).</param>
+        public Polynomial(SymbolTable table, Object[][] symScale) : this(table)
+        {
+            Add(symScale, 1.0);
+        }
+
+        /// <summary>The table in which the factors of this polynomial are interned.</summary>
+        public SymbolTable Table
+        {
+            get { return m_table; }
+        }
+
+        /// <summary>
+        /// Adds <paramref name="scale"/> * <paramref name="symScale"/>. The Doubles of each
+        /// term of <paramref name="symScale"/> are multiplied into its coefficient.
+        /// </summary>
+        /// <param name="symScale">Symbolic scale (array of arrays, may be null). Is not changed.</param>
+        /// <param name="scale">Multiplier for all terms.</param>
+        public void Add(Object[][] symScale, double scale)
+        {
+            if (symScale == null) return;
+            for (int i = 0; i < symScale.Length; i++)
+            {
+                Object[] T = symScale[i];
+                if ((T == null) || (T.Length == 0)) continue;
+
+                double coef = scale;
+                for (int j = 0; j < T.Length; j++)
+                    if (T[j] is Double) coef *= (double)T[j];
+                if (coef == 0.0) continue;
+
+                Add(new Monomial(T, m_table), coef);
+            }
+        }
+
+        /// <summary>
+        /// Adds <paramref name="coef"/> * <paramref name="M"/>.
+        /// </summary>
+        public void Add(Monomial M, double coef)
+        {
+            int idx;
+            if (m_termIdx.TryGetValue(M, out idx))
+                m_coefs[idx] += coef;
+            else
+            {
+                m_termIdx[M] = m_monomials.Count;
+                m_monomials.Add(M);
+                m_coefs.Add(coef);
+            }
+        }
+
+        /// <summary>
+        /// Adds the constant <paramref name="c"/>.
+        /// </summary>
+        public void Add(double c)
+        {
+            if (c != 0.0) Add(Monomial.ONE, c);
+        }
+
+        /// <summary>
+        /// Adds <paramref name="scale"/> * <paramref name="P"/>.
+        /// </summary>
+        public void Add(Polynomial P, double scale)
+        {
+            CheckTable(P);
+            for (int i = 0; i < P.m_monomials.Count; i++)
+            {
+                double coef = scale * P.m_coefs[i];
+                if (coef != 0.0) Add(P.m_monomials[i], coef);
+            }
+        }
+
+        /// <summary>
+        /// Adds <paramref name="scale"/> * <paramref name="P"/> * <paramref name="Q"/>.
+        /// </summary>
+        public void AddProduct(Polynomial P, Polynomial Q, double scale)
+        {
+            CheckTable(P);
+            CheckTable(Q);
+            for (int i = 0; i < P.m_monomials.Count; i++)
+            {
+                double coefP = scale * P.m_coefs[i];
+                if (coefP == 0.0) continue;
+                for (int j = 0; j < Q.m_monomials.Count; j++)
+                {
+                    double coef = coefP * Q.m_coefs[j];
+                    if (coef != 0.0) Add(Monomial.Multiply(P.m_monomials[i], Q.m_monomials[j]), coef);
+                }
+            }
+        }
+
+        /// <summary>
+        /// Converts this polynomial to a symbolic scale (see BasisBlade.symScale).
+        /// 
+        /// Terms which cancelled are discarded. The coefficient of each term is put in front of its factors
+        /// (it is left out when it is 1.0). The factors of each term are sorted using Util.SimplifySymbolicScalarsComparer,
+        /// and the terms are sorted using Util.SimplifySymbolicArrayComparer (see SymbolTable.GetRanks()), 
+        /// such that the output does not depend on the order in which terms were added.
+        /// </summary>
+        /// <returns>The symbolic scale, or null when all terms cancelled.</returns>
+        public Object[][] ToSymbolicScalar()
+        {
+            int[] ranks = m_table.GetRanks();
+            Object[] symbolOfRank = m_table.GetSymbolsByRank();
+
+            List<int[]> keys = new List<int[]>(m_monomials.Count); // ranks of the factors of each term
+            List<Object[]> terms = new List<Object[]>(m_monomials.Count);
+            for (int i = 0; i < m_monomials.Count; i++)
+            {
+                double coef = m_coefs[i];
+                if (coef == 0.0) continue;
+
+                Monomial M = m_monomials[i];
+                int[] key = new int[M.Degree];
+                for (int j = 0; j < key.Length; j++)
+                    key[j] = ranks[M.GetID(j)];
+                if (key.Length > 1) Array.Sort(key);
+
+                int offset = ((coef == 1.0) && (key.Length > 0)) ? 0 : 1;
+                Object[] T = new Object[key.Length + offset];
+                if (offset != 0) T[0] = coef;
+                for (int j = 0; j < key.Length; j++)
+                    T[j + offset] = symbolOfRank[key[j]];
+
+                keys.Add(key);
+                terms.Add(T);
+            }
+
+            if (terms.Count == 0) return null;
+
+            Object[][] result = terms.ToArray();
+            if (result.Length > 1)
+                Array.Sort(keys.ToArray(), result, new RankComparer());
+            return result;
+        }
+
+        private void CheckTable(Polynomial P)
+        {
+            if (!Object.ReferenceEquals(P.m_table, m_table))
+                throw new ArgumentException("Polynomials must use the same SymbolTable");
+        }
+
+        /// <summary>
+        /// Lexicographic order of the (sorted) ranks of the factors of terms. A term which is a prefix
+        /// of another term comes first. This is the order of Util.SimplifySymbolicArrayComparer.
+        /// </summary>
+        private class RankComparer : IComparer<int[]>
+        {
+            public int Compare(int[] X, int[] Y)
+            {
+                for (int i = 0; (i < X.Length) && (i < Y.Length); i++)
+                {
+                    if (X[i] != Y[i]) return (X[i] < Y[i]) ? -1 : 1;
+                }
+                return X.Length.CompareTo(Y.Length);
+            }
+        } // end of class RankComparer
+
+        /// <summary>The table in which the factors are interned.</summary>
+        private SymbolTable m_table;
+        /// <summary>Map from monomial to the index of its term.</summary>
+        private Dictionary<Monomial, int> m_termIdx;
+        /// <summary>The monomial of each term.</summary>
+        private List<Monomial> m_monomials;
+        /// <summary>The summed coefficient of each term.</summary>
+        private List<double> m_coefs;
+    } // end of class Polynomial
+
+} // end of namespace RefGA.Symbolic
@@ -0,0 +1,285 @@
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+// Copyright 2008-2010, Daniel Fontijne, University of Amsterdam -- fontijne@science.uva.nl
+
+using System;
+using System.Collections.Generic;
+using System.Text;
+
+namespace RefGA.Symbolic
+{
+    /// <summary>
+    /// Interns symbolic scalar factors (strings, UnaryScalarOps, BinaryScalarOps, etc) to small integer IDs.
+    ///
+    /// Two factors get the same ID when they are equal according to SymbolComparer: strings are compared directly,
+    /// scalar BasisBlades on their bitmap and scale, and other types on their string representation.
+    /// The latter is the same notion of equality that Util.SimplifySymbolicScalarsComparer falls back on.
+    ///
+    /// A table only lives as long as the computation that uses it (one call of Util.SimplifySymbolicScalars(),
+    /// or one BladeAccumulator), so the IDs are only meaningful for the Monomials and Polynomials of that 
+    /// computation. Tables are not thread-safe, and are never shared between threads.
+    /// The IDs do not determine the order in which factors are output (see GetRanks()).
+    /// </summary>
+    public class SymbolTable
+    {
+        public SymbolTable()
+        {
+            m_IDs = new Dictionary<Object, int>(new SymbolComparer());
+            m_symbols = new List<Object>();
+        }
+
+        /// <summary>
+        /// Returns the ID of symbolic scalar factor <paramref name="O"/>.
+        /// Allocates a new ID when <paramref name="O"/> was not seen before by this table.
+        /// </summary>
+        /// <param name="O">The factor (must not be null, must not be a Double).</param>
+        /// <returns>ID of <paramref name="O"/>.</returns>
+        public int GetID(Object O)
+        {
+            int ID;
+            if (!m_IDs.TryGetValue(O, out ID))
+            {
+                ID = m_symbols.Count;
+                m_IDs[O] = ID;
+                m_symbols.Add(O);
+            }
+            return ID;
+        }
+
+        /// <returns>Number of symbols interned so far.</returns>
+        public int Count
+        {
+            get
+            {
+                return m_symbols.Count;
+            }
+        }
+
+        /// <summary>
+        /// Returns the rank of each symbol (indexed by ID) when all symbols are sorted 
+        /// using Util.SimplifySymbolicScalarsComparer. Factors and terms are output in this order
+        /// (see Polynomial.ToSymbolicScalar()), such that the output does not depend on the order 
+        /// in which the symbols were interned.
+        /// </summary>
+        public int[] GetRanks()
+        {
+            UpdateRanks();
+            return m_ranks;
+        }
+
+        /// <returns>The symbols, sorted on rank (see GetRanks()).</returns>
+        public Object[] GetSymbolsByRank()
+        {
+            UpdateRanks();
+            return m_symbolsByRank;
+        }
+
+        /// <summary>
+        /// Computes m_ranks and m_symbolsByRank, unless they are up to date
+        /// (i.e., no symbols were added since the previous call).
+        /// </summary>
+        private void UpdateRanks()
+        {
+            if ((m_ranks != null) && (m_ranks.Length == m_symbols.Count)) return;
+
+            Object[] symbols = m_symbols.ToArray();
+            int[] IDs = new int[symbols.Length];
+            for (int i = 0; i < IDs.Length; i++)
+                IDs[i] = i;
+            Array.Sort(symbols, IDs, new Util.SimplifySymbolicScalarsComparer());
+
+            m_ranks = new int[IDs.Length];
+            for (int i = 0; i < IDs.Length; i++)
+                m_ranks[IDs[i]] = i;
+            m_symbolsByRank = symbols;
+        }
+
+        /// <summary>
+        /// Equality of symbolic scalar factors, used as the comparer of the table.
+        /// 
+        /// Strings (the most common case) are compared directly. Scalar BasisBlades (used as factors by BasisBlade.SumScales()) 
+        /// are compared on bitmap and the exact value of their scale. Other factors are equal when they are of the same type and
+        /// have the same string representation.
+        /// </summary>
+        private class SymbolComparer : IEqualityComparer<Object>
+        {
+            public new bool Equals(Object x, Object y)
+            {
+                if (Object.ReferenceEquals(x, y)) return true;
+                if (!Object.ReferenceEquals(x.GetType(), y.GetType())) return false;
+
+                if (x is String) return String.Equals((String)x, (String)y);
+                else if (IsScalarBasisBlade(x) || IsScalarBasisBlade(y))
+                {
+                    BasisBlade A = (BasisBlade)x, B = (BasisBlade)y;
+                    return IsScalarBasisBlade(x) && IsScalarBasisBlade(y) && (A.bitmap == B.bitmap) &&
+                        (BitConverter.DoubleToInt64Bits(A.scale) == BitConverter.DoubleToInt64Bits(B.scale));
+                }
+                else return String.Equals(x.ToString(), y.ToString());
+            }
+
+            public int GetHashCode(Object O)
+            {
+                if (O is String) return O.GetHashCode();
+                else if (IsScalarBasisBlade(O))
+                {
+                    BasisBlade B = (BasisBlade)O;
+                    return (int)B.bitmap ^ BitConverter.DoubleToInt64Bits(B.scale).GetHashCode();
+                }
+                else return O.GetType().GetHashCode() ^ O.ToString().GetHashCode();
+            }
+
+            private static bool IsScalarBasisBlade(Object O)
+            {
+                return (O is BasisBlade) && (!((BasisBlade)O).IsSymbolic());
+            }
+        } // end of class SymbolComparer
+
+        /// <summary>
+        /// Map from factor to ID (see SymbolComparer).
+        /// </summary>
+        private Dictionary<Object, int> m_IDs;
+
+        /// <summary>
+        /// The factors, indexed by ID.
+        /// </summary>
+        private List<Object> m_symbols;
+
+        /// <summary>
+        /// Cached result of GetRanks() (null when not computed yet).
+        /// </summary>
+        private int[] m_ranks;
+
+        /// <summary>
+        /// Cached result of GetSymbolsByRank() (null when not computed yet).
+        /// </summary>
+        private Object[] m_symbolsByRank;
+    } // end of class SymbolTable
+
+    /// <summary>
+    /// Immutable product of interned symbolic scalar factors (see SymbolTable).
+    /// The IDs of the factors are stored in a sorted array, such that two monomials
+    /// which contain the same factors (in any order) are equal and have the same hash code.
+    ///
+    /// Used as key when merging the terms of symbolic scalars (see Polynomial).
+    /// </summary>
+    public struct Monomial : IEquatable<Monomial>
+    {
+        /// <summary>
+        /// Constructs the monomial of <paramref name="factors"/>, interning the factors in <paramref name="table"/>.
+        /// Doubles in <paramref name="factors"/> are skipped (they are coefficients, not factors).
+        /// </summary>
+        /// <param name="factors">Factors of a single term of a symbolic scalar (must not contain null).</param>
+        /// <param name="table">The table of the computation.</param>
+        public Monomial(Object[] factors, SymbolTable table)
+        {
+            int nb = 0;
+            for (int i = 0; i < factors.Length; i++)
+                if (!(factors[i] is Double)) nb++;
+
+            int[] IDs = new int[nb];
+            int idx = 0;
+            for (int i = 0; i < factors.Length; i++)
+                if (!(factors[i] is Double))
+                    IDs[idx++] = table.GetID(factors[i]);
+            if (nb > 1) Array.Sort(IDs);
+
+            m_IDs = IDs;
+            m_hashCode = ComputeHashCode(IDs);
+        }
+
+        /// <summary>
+        /// Constructs the monomial with (sorted) factor IDs <paramref name="sortedIDs"/>. The array is not copied.
+        /// </summary>
+        private Monomial(int[] sortedIDs)
+        {
+            m_IDs = sortedIDs;
+            m_hashCode = ComputeHashCode(sortedIDs);
+        }
+
+        /// <summary>
+        /// Returns the product of <paramref name="A"/> and <paramref name="B"/> (the sorted IDs of both are merged).
+        /// </summary>
+        public static Monomial Multiply(Monomial A, Monomial B)
+        {
+            if (A.m_IDs.Length == 0) return B;
+            else if (B.m_IDs.Length == 0) return A;
+
+            int[] a = A.m_IDs, b = B.m_IDs;
+            int[] IDs = new int[a.Length + b.Length];
+            int ia = 0, ib = 0, idx = 0;
+            while ((ia < a.Length) && (ib < b.Length))
+                IDs[idx++] = (a[ia] <= b[ib]) ? a[ia++] : b[ib++];
+            while (ia < a.Length) IDs[idx++] = a[ia++];
+            while (ib < b.Length) IDs[idx++] = b[ib++];
+            return new Monomial(IDs);
+        }
+
+        /// <summary>
+        /// The monomial without factors (the constant 1).
+        /// </summary>
+        public static readonly Monomial ONE = new Monomial(new int[0]);
+
+        /// <returns>Number of (symbolic) factors in this monomial.</returns>
+        public int Degree
+        {
+            get { return m_IDs.Length; }
+        }
+
+        public bool Equals(Monomial M)
+        {
+            if (m_hashCode != M.m_hashCode) return false;
+            if (m_IDs.Length != M.m_IDs.Length) return false;
+            for (int i = 0; i < m_IDs.Length; i++)
+                if (m_IDs[i] != M.m_IDs[i]) return false;
+            return true;
+        }
+
+        public override bool Equals(Object O)
+        {
+            return (O is Monomial) && Equals((Monomial)O);
+        }
+
+        public override int GetHashCode()
+        {
+            return m_hashCode;
+        }
+
+        /// <returns>The ID of factor <paramref name="idx"/> (the factors are sorted on ID).</returns>
+        public int GetID(int idx)
+        {
+            return m_IDs[idx];
+        }
+
+        private static int ComputeHashCode(int[] IDs)
+        {
+            int H = IDs.Length;
+            for (int i = 0; i < IDs.Length; i++)
+                H = H * 31 + IDs[i];
+            return H;
+        }
+
+        /// <summary>
+        /// Sorted IDs of the factors.
+        /// </summary>
+        private readonly int[] m_IDs;
+
+        /// <summary>
+        ///  Computed at construction-time
+        /// </summary>
+        private readonly int m_hashCode;
+    } // end of struct Monomial
+
+} // end of namespace RefGA.Symbolic
@@ -278,107 +278,66 @@ namespace RefGA
         }
 
 
+        /// <summary>
+        /// Simplifies a `symbolic scalar array' (a sum of products).
+        /// 
+        /// The terms are converted to a Symbolic.Polynomial, which interns the factors of each term
+        /// in a SymbolTable (local to this call) and merges the terms using a hash table keyed on their Symbolic.Monomial. 
+        /// Doubles are multiplied into the coefficient of each term, and the coefficients of identical terms are summed. 
+        /// Terms which cancel are discarded.
+        /// 
+        /// The factors of each term are sorted using SimplifySymbolicScalarsComparer, and the terms
+        /// are sorted using SimplifySymbolicArrayComparer, such that the output does not depend on the 
+        /// order of the input terms.
+        /// </summary>
+        /// <param name="A">Arrays of arrays of Objects (may be null). The component arrays of A are not changed.</param>
+        /// <returns>Simplified version of A; may return null when all terms cancel.</returns>
         public static Object[][] SimplifySymbolicScalars(Object[][] A)
         {
             if (A == null) return null;
 
-            // sort all arrays A[i] of A, and add the non-null ones in AL
-            // also multiply all doubles
-            ArrayList AL = new ArrayList();
+            // most symbolic scalars have a single term: then there is nothing to merge
+            int nbTerms = 0;
+            Object[] single = null;
+            for (int i = 0; i < A.Length; i++)
             {
-                SimplifySymbolicScalarsComparer SSSC = new SimplifySymbolicScalarsComparer();
-                for (int i = 0; i < A.Length; i++)
-                {
-                    if ((A[i] != null) && (A[i].Length > 0))
-                    {
-                        Array.Sort(A[i], SSSC);
-
-                        // multiply doubles (at the front)
-                        if ((A[i].Length > 1) && (A[i][0] is Double) && (A[i][1] is Double)) // are there 2 or more Double at the front of A[i]?
-                        {
-                            // count number of doubles, multiply them together
-                            int nb = 2; // we know the first two are already double!
-                            double val = (double)A[i][0] * (double)A[i][1];
-                            while ((nb < A[i].Length) && (A[i][nb] is Double))
-                            {
-                                val *= (double)A[i][nb];
-                                nb++;
-                            }
-
-                            // form a new array
-                            Object[] newAi = new Object[A[i].Length - nb + 1];
-                            newAi[0] = val;
-                            Array.Copy(A[i], nb, newAi, 1, A[i].Length - nb);
-                            A[i] = newAi;
-                        }
-
-                        // if zero, then discard the whole thing:
-                        if (!((A[i].Length > 1) && (A[i][0] is Double) && ((double)A[i][0] == 0.0)))
-                            AL.Add(A[i]);
-                    }
-                }
+                if ((A[i] == null) || (A[i].Length == 0)) continue;
+                single = A[i];
+                nbTerms++;
             }
+            if (nbTerms == 0) return null;
+            else if (nbTerms == 1) return SimplifySymbolicTerm(single);
 
-            if (AL.Count == 1) return new Object[1][] {(Object[])AL[0] };
-
-            // sort the arrays themselves
-            System.Collections.IComparer SSAC = new SimplifySymbolicArrayComparer();
-            AL.Sort(SSAC);
-
+            Symbolic.Polynomial P = new Symbolic.Polynomial(new Symbolic.SymbolTable(), A);
+            return P.ToSymbolicScalar();
+        }
 
-            // merge adjacent identical (up to scale) arrays
-            ArrayList mergedAL = new ArrayList();
-            for (int i = 0; i < AL.Count;) // note: no increment
+        /// <summary>
+        /// Simplifies a single term of a `symbolic scalar array' the same way as SimplifySymbolicScalars() does:
+        /// the Doubles are multiplied, and put in front of the sorted factors (unless the product is 1.0).
+        /// </summary>
+        /// <param name="T">The term (not null, not empty). Is not changed.</param>
+        /// <returns>The simplified term (in an array of length 1), or null when the term is zero.</returns>
+        private static Object[][] SimplifySymbolicTerm(Object[] T)
+        {
+            double coef = 1.0;
+            int nbFactors = 0;
+            for (int j = 0; j < T.Length; j++)
             {
-                // find all arrays which are equal up to scale:
-                int j = i+1; // j will become index of first array which is not equal up to scale
-                while ((j < AL.Count) && (SSAC.Compare(AL[i], AL[j]) == 0)) j++;
-
-                if (j - i > 1)
-                { // at least one array equal up to scale: merge these arrays
-                    double scale = 0; // collect scale here
-                    int ALiFirstObjectIdx = -1;
-                    for (int k = i; k < j; k++)
-                    {
-                        int l = 0;
-                        Object[] ALk = (Object[])AL[k];
-                        double ALkScale = 1.0;
-                        while ((l < ALk.Length) && (Object.ReferenceEquals(ALk[l].GetType(), DT)))
-                        {
-                            ALkScale *= (double)ALk[l];
-                            l++;
-                        }
-                        if (k == i) ALiFirstObjectIdx = l; // remember where the Objects start in AL[i]
-
-                        scale += ALkScale;
-                    }
-
-
-                    if (scale != 0.0)
-                    {
-                        Object[] ALi = (Object[])AL[i];
-                        bool scaleNotOne = (scale != 1.0);
-                        Object[] newALi = new Object[ALi.Length - ALiFirstObjectIdx + ((scaleNotOne) ? 1 : 0)];
-                        if (scaleNotOne) newALi[0] = scale;
-                        Array.Copy(ALi, ALiFirstObjectIdx, newALi, (scaleNotOne) ? 1 : 0, ALi.Length - ALiFirstObjectIdx);
-                        mergedAL.Add(newALi);
-                    }
-
-                    i = j;
-                }
-                else
-                {
-                    mergedAL.Add(AL[i]);
-                    i++;
-                }
+                if (T[j] is Double) coef *= (double)T[j];
+                else nbFactors++;
             }
+            if (coef == 0.0) return null;
 
-            if (mergedAL.Count == 0) return null;
+            int offset = ((coef == 1.0) && (nbFactors > 0)) ? 0 : 1;
+            Object[] term = new Object[nbFactors + offset];
+            if (offset != 0) term[0] = coef;
+            int k = offset;
+            for (int j = 0; j < T.Length; j++)
+                if (!(T[j] is Double)) term[k++] = T[j];
+            if (nbFactors > 1) Array.Sort(term, offset, nbFactors, new SimplifySymbolicScalarsComparer());
 
-            Object[][] resultA = new Object[mergedAL.Count][];
-            for (int i = 0; i < mergedAL.Count; i++)
-                resultA[i] = (Object[])mergedAL[i];
-            return resultA;
+            return new Object[1][] { term };
         }
 
         /// <summary>